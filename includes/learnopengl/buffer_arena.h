@@ -0,0 +1,535 @@
+#ifndef BUFFER_ARENA_H
+#define BUFFER_ARENA_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cstring>
+
+#include "mesh_optimizer.h"
+
+// two level segregated fit allocator (Masmano et al.) over an abstract range of
+// units: O(1) allocate and free with immediate coalescing of neighbours. it only
+// hands out offsets, the memory itself lives elsewhere (here: in GL buffers)
+class TlsfAllocator {
+public:
+	static const unsigned int INVALID = ~0u;
+
+	TlsfAllocator(unsigned int capacity = 0)
+	{
+		reset(capacity);
+	}
+
+	// forget all allocations, the whole range becomes one free block
+	void reset(unsigned int capacity)
+	{
+		blocks.clear();
+		unusedBlocks.clear();
+		flBitmap = 0;
+		memset(slBitmap, 0, sizeof(slBitmap));
+		for (int fl = 0; fl < FL_COUNT; fl++)
+			for (int sl = 0; sl < SL_COUNT; sl++)
+				heads[fl][sl] = INVALID;
+		total = capacity;
+		used = 0;
+		if (capacity > 0)
+		{
+			unsigned int block = newBlock(0, capacity);
+			insertFree(block);
+		}
+	}
+
+	// returns a block handle or INVALID when no free block is large enough
+	unsigned int allocate(unsigned int size)
+	{
+		if (size == 0)
+			size = 1;
+		int fl, sl;
+		unsigned int block = INVALID;
+		if (mapSearch(size, fl, sl) && findSuitable(fl, sl))
+			block = heads[fl][sl];
+		else
+		{
+			// the rounded up classes are empty, but the request's own class may
+			// still hold a block that fits: look through that one list
+			mapInsert(size, fl, sl);
+			for (unsigned int b = heads[fl][sl]; b != INVALID && block == INVALID; b = blocks[b].nextFree)
+				if (blocks[b].size >= size)
+					block = b;
+			if (block == INVALID)
+				return INVALID;
+		}
+		removeFree(block);
+
+		// give the tail back
+		if (blocks[block].size > size)
+		{
+			unsigned int rest = newBlock(blocks[block].offset + size, blocks[block].size - size);
+			blocks[rest].prevPhys = block;
+			blocks[rest].nextPhys = blocks[block].nextPhys;
+			if (blocks[block].nextPhys != INVALID)
+				blocks[blocks[block].nextPhys].prevPhys = rest;
+			blocks[block].nextPhys = rest;
+			blocks[block].size = size;
+			insertFree(rest);
+		}
+		blocks[block].free = false;
+		used += size;
+		return block;
+	}
+
+	void free(unsigned int block)
+	{
+		if (block == INVALID || blocks[block].free)
+			return;
+		used -= blocks[block].size;
+		unsigned int prev = blocks[block].prevPhys, next = blocks[block].nextPhys;
+		if (next != INVALID && blocks[next].free)
+		{
+			removeFree(next);
+			absorbNext(block);
+		}
+		if (prev != INVALID && blocks[prev].free)
+		{
+			removeFree(prev);
+			absorbNext(prev);
+			block = prev;
+		}
+		insertFree(block);
+	}
+
+	// start over with blocks of 'sizes' back to back from offset 0 and the rest
+	// free, no search involved. handles[i] receives the block for sizes[i],
+	// INVALID where sizes[i] is 0. the sizes must add up to at most 'capacity'
+	void resetPacked(unsigned int capacity, const std::vector<unsigned int> &sizes, std::vector<unsigned int> &handles)
+	{
+		reset(0);
+		total = capacity;
+		handles.assign(sizes.size(), (unsigned int)INVALID);
+		unsigned int offset = 0, last = INVALID;
+		for (size_t i = 0; i < sizes.size(); i++)
+		{
+			if (sizes[i] == 0)
+				continue;
+			unsigned int block = newBlock(offset, sizes[i]);
+			blocks[block].free = false;
+			link(last, block);
+			last = block;
+			offset += sizes[i];
+			handles[i] = block;
+		}
+		used = offset;
+		if (offset < capacity)
+		{
+			unsigned int rest = newBlock(offset, capacity - offset);
+			link(last, rest);
+			insertFree(rest);
+		}
+	}
+
+	unsigned int offset(unsigned int block) const { return blocks[block].offset; }
+	unsigned int size(unsigned int block) const { return blocks[block].size; }
+	unsigned int capacity() const { return total; }
+	unsigned int usedUnits() const { return used; }
+	unsigned int freeUnits() const { return total - used; }
+
+	// size of the largest free block, the biggest allocation that can succeed
+	unsigned int largestFree() const
+	{
+		if (flBitmap == 0)
+			return 0;
+		int fl = 31 - __builtin_clz(flBitmap);
+		int sl = 31 - __builtin_clz(slBitmap[fl]);
+		unsigned int largest = 0;
+		for (unsigned int b = heads[fl][sl]; b != INVALID; b = blocks[b].nextFree)
+			largest = blocks[b].size > largest ? blocks[b].size : largest;
+		return largest;
+	}
+
+private:
+	enum { SL_BITS = 4, SL_COUNT = 1 << SL_BITS, FL_COUNT = 32 };
+
+	struct Block {
+		unsigned int offset, size;
+		unsigned int prevPhys, nextPhys;	// neighbours in the range
+		unsigned int prevFree, nextFree;	// neighbours in the free list of its size class
+		bool free;
+	};
+
+	std::vector<Block> blocks;
+	std::vector<unsigned int> unusedBlocks;
+	unsigned int flBitmap;
+	unsigned int slBitmap[FL_COUNT];
+	unsigned int heads[FL_COUNT][SL_COUNT];
+	unsigned int total, used;
+
+	// size class of a free block: sizes below SL_COUNT are exact, above that
+	// every power of two is split into SL_COUNT linear steps
+	static void mapInsert(unsigned int size, int &fl, int &sl)
+	{
+		if (size < SL_COUNT)
+		{
+			fl = 0;
+			sl = (int)size;
+			return;
+		}
+		int msb = 31 - __builtin_clz(size);
+		sl = (int)(size >> (msb - SL_BITS)) ^ SL_COUNT;
+		fl = msb - SL_BITS + 1;
+	}
+
+	// size class whose blocks are all at least 'size' large
+	static bool mapSearch(unsigned int size, int &fl, int &sl)
+	{
+		if (size >= SL_COUNT)
+		{
+			unsigned int round = (1u << (31 - __builtin_clz(size) - SL_BITS)) - 1;
+			if (size > ~0u - round)
+				return false;
+			size += round;
+		}
+		mapInsert(size, fl, sl);
+		return true;
+	}
+
+	bool findSuitable(int &fl, int &sl) const
+	{
+		unsigned int slMap = sl < 32 ? slBitmap[fl] & (~0u << sl) : 0;
+		if (!slMap)
+		{
+			unsigned int flMap = fl + 1 < 32 ? flBitmap & (~0u << (fl + 1)) : 0;
+			if (!flMap)
+				return false;
+			fl = __builtin_ctz(flMap);
+			slMap = slBitmap[fl];
+		}
+		sl = __builtin_ctz(slMap);
+		return true;
+	}
+
+	unsigned int newBlock(unsigned int offset, unsigned int size)
+	{
+		Block b = { offset, size, INVALID, INVALID, INVALID, INVALID, true };
+		if (!unusedBlocks.empty())
+		{
+			unsigned int index = unusedBlocks.back();
+			unusedBlocks.pop_back();
+			blocks[index] = b;
+			return index;
+		}
+		blocks.push_back(b);
+		return (unsigned int)blocks.size() - 1;
+	}
+
+	void insertFree(unsigned int block)
+	{
+		int fl, sl;
+		mapInsert(blocks[block].size, fl, sl);
+		blocks[block].free = true;
+		blocks[block].prevFree = INVALID;
+		blocks[block].nextFree = heads[fl][sl];
+		if (heads[fl][sl] != INVALID)
+			blocks[heads[fl][sl]].prevFree = block;
+		heads[fl][sl] = block;
+		flBitmap |= 1u << fl;
+		slBitmap[fl] |= 1u << sl;
+	}
+
+	void removeFree(unsigned int block)
+	{
+		int fl, sl;
+		mapInsert(blocks[block].size, fl, sl);
+		unsigned int prev = blocks[block].prevFree, next = blocks[block].nextFree;
+		if (prev != INVALID)
+			blocks[prev].nextFree = next;
+		else
+			heads[fl][sl] = next;
+		if (next != INVALID)
+			blocks[next].prevFree = prev;
+		if (heads[fl][sl] == INVALID)
+		{
+			slBitmap[fl] &= ~(1u << sl);
+			if (!slBitmap[fl])
+				flBitmap &= ~(1u << fl);
+		}
+		blocks[block].free = false;
+	}
+
+	// make 'next' the physical successor of 'block' (INVALID: none)
+	void link(unsigned int block, unsigned int next)
+	{
+		blocks[next].prevPhys = block;
+		if (block != INVALID)
+			blocks[block].nextPhys = next;
+	}
+
+	// merge the physical successor into 'block' and recycle its handle
+	void absorbNext(unsigned int block)
+	{
+		unsigned int next = blocks[block].nextPhys;
+		blocks[block].size += blocks[next].size;
+		blocks[block].nextPhys = blocks[next].nextPhys;
+		if (blocks[next].nextPhys != INVALID)
+			blocks[blocks[next].nextPhys].prevPhys = block;
+		unusedBlocks.push_back(next);
+	}
+};
+
+// many meshes with the same vertex format in one vertex and one index buffer
+// behind one VAO. vertex ranges are counted in vertices and index ranges in
+// indices, so a mesh draws with glDrawElementsBaseVertex and its indices stay
+// relative to its own first vertex: 16-bit indices work however many meshes
+// share the arena
+class BufferArena {
+public:
+	struct Stats {
+		unsigned int meshes;
+		unsigned int vertexCapacity, verticesUsed, largestVertexRange;
+		unsigned int indexCapacity, indicesUsed, largestIndexRange;
+		unsigned int defragmentations;
+	};
+
+	// leaves the VAO, vertex and index buffer bound so the caller can set up the
+	// vertex attributes once, e.g. with VertexLayout<...>::apply()
+	BufferArena(GLsizei vertexStride, unsigned int vertexCapacity, unsigned int indexCapacity,
+		GLenum indexType = GL_UNSIGNED_SHORT)
+		: stride(vertexStride), type(indexType), indexSize((GLsizei)indexTypeSize(indexType)),
+		vertices(vertexCapacity), indices(indexCapacity), defragmentations(0)
+	{
+		glGenVertexArrays(1, &VAO);
+		glGenBuffers(1, &VBO);
+		glGenBuffers(1, &EBO);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)vertexCapacity * stride, NULL, GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)indexCapacity * indexSize, NULL, GL_DYNAMIC_DRAW);
+	}
+
+	~BufferArena()
+	{
+		glDeleteVertexArrays(1, &VAO);
+		glDeleteBuffers(1, &VBO);
+		glDeleteBuffers(1, &EBO);
+	}
+
+	// copy a mesh into the arena, indices are 32-bit on the CPU side and relative
+	// to the first of its vertices. compacts or grows the buffers when needed.
+	// returns a mesh id for draw() and remove()
+	unsigned int add(const void *vertexData, unsigned int vertexCount, const unsigned int *indexData, unsigned int indexCount)
+	{
+		Mesh mesh;
+		mesh.vertexBlock = vertices.allocate(vertexCount);
+		mesh.indexBlock = indices.allocate(indexCount);
+		if (mesh.vertexBlock == TlsfAllocator::INVALID || mesh.indexBlock == TlsfAllocator::INVALID)
+		{
+			vertices.free(mesh.vertexBlock);
+			indices.free(mesh.indexBlock);
+			// compact first, grow only when the arena is really full
+			unsigned int vertexCapacity = vertices.capacity(), indexCapacity = indices.capacity();
+			if (vertices.usedUnits() + vertexCount > vertexCapacity)
+				vertexCapacity = (vertices.usedUnits() + vertexCount) * 2;
+			if (indices.usedUnits() + indexCount > indexCapacity)
+				indexCapacity = (indices.usedUnits() + indexCount) * 2;
+			for (;;)
+			{
+				defragment(vertexCapacity, indexCapacity);
+				mesh.vertexBlock = vertices.allocate(vertexCount);
+				mesh.indexBlock = indices.allocate(indexCount);
+				if (mesh.vertexBlock != TlsfAllocator::INVALID && mesh.indexBlock != TlsfAllocator::INVALID)
+					break;
+				// still no room after compacting, grow whichever ran out
+				if (mesh.vertexBlock == TlsfAllocator::INVALID)
+					vertexCapacity = vertices.capacity() * 2 + vertexCount;
+				if (mesh.indexBlock == TlsfAllocator::INVALID)
+					indexCapacity = indices.capacity() * 2 + indexCount;
+				vertices.free(mesh.vertexBlock);
+				indices.free(mesh.indexBlock);
+			}
+		}
+		mesh.indexCount = indexCount;
+		mesh.live = true;
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, VBO);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)vertices.offset(mesh.vertexBlock) * stride,
+			(GLsizeiptr)vertexCount * stride, vertexData);
+		std::vector<unsigned short> narrow;
+		std::vector<unsigned char> bytes;
+		const void *indexBytes = indexData;
+		if (indexSize == 2)
+		{
+			narrow.assign(indexData, indexData + indexCount);
+			indexBytes = narrow.empty() ? NULL : &narrow[0];
+		}
+		else if (indexSize == 1)
+		{
+			bytes.assign(indexData, indexData + indexCount);
+			indexBytes = bytes.empty() ? NULL : &bytes[0];
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, EBO);
+		glBufferSubData(GL_COPY_WRITE_BUFFER, (GLintptr)indices.offset(mesh.indexBlock) * indexSize,
+			(GLsizeiptr)indexCount * indexSize, indexBytes);
+
+		if (!unusedMeshes.empty())
+		{
+			unsigned int id = unusedMeshes.back();
+			unusedMeshes.pop_back();
+			meshes[id] = mesh;
+			return id;
+		}
+		meshes.push_back(mesh);
+		return (unsigned int)meshes.size() - 1;
+	}
+
+	void remove(unsigned int id)
+	{
+		if (id >= meshes.size() || !meshes[id].live)
+			return;
+		vertices.free(meshes[id].vertexBlock);
+		indices.free(meshes[id].indexBlock);
+		meshes[id].live = false;
+		unusedMeshes.push_back(id);
+	}
+
+	// bind once, then draw any number of meshes
+	void bind() const
+	{
+		glBindVertexArray(VAO);
+	}
+
+	void draw(unsigned int id) const
+	{
+		const Mesh &mesh = meshes[id];
+		glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)mesh.indexCount, type,
+			(void*)((size_t)indices.offset(mesh.indexBlock) * indexSize), (GLint)vertices.offset(mesh.vertexBlock));
+	}
+
+	// where a mesh currently lives, for drawing it some other way (indirect
+	// commands, batching). only valid until the next add() or defragment()
+	struct Range {
+		GLuint count, firstIndex;
+		GLint baseVertex;
+	};
+
+	Range range(unsigned int id) const
+	{
+		const Mesh &mesh = meshes[id];
+		Range r = { mesh.indexCount, indices.offset(mesh.indexBlock), (GLint)vertices.offset(mesh.vertexBlock) };
+		return r;
+	}
+
+	GLenum indexType() const { return type; }
+	unsigned int vertexArray() const { return VAO; }
+
+	// move all live meshes to the start of the buffers (optionally resized) so the
+	// free space becomes one block. runs on the GPU through a scratch buffer; the
+	// buffer names stay the same so the VAO keeps its bindings
+	void defragment(unsigned int vertexCapacity = 0, unsigned int indexCapacity = 0)
+	{
+		if (vertexCapacity < vertices.usedUnits())
+			vertexCapacity = vertices.capacity();
+		if (indexCapacity < indices.usedUnits())
+			indexCapacity = indices.capacity();
+
+		std::vector<unsigned int> vertexSizes, indexSizes;
+		compact(VBO, vertices, stride, true, vertexCapacity, vertexSizes);
+		compact(EBO, indices, indexSize, false, indexCapacity, indexSizes);
+
+		// the allocators start over with every live mesh packed in order, the
+		// same bump offsets compact() copied them to
+		std::vector<unsigned int> vertexBlocks, indexBlocks;
+		vertices.resetPacked(vertexCapacity, vertexSizes, vertexBlocks);
+		indices.resetPacked(indexCapacity, indexSizes, indexBlocks);
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			if (!meshes[i].live)
+				continue;
+			meshes[i].vertexBlock = vertexBlocks[i];
+			meshes[i].indexBlock = indexBlocks[i];
+		}
+		defragmentations++;
+	}
+
+	Stats stats() const
+	{
+		Stats s;
+		s.meshes = (unsigned int)(meshes.size() - unusedMeshes.size());
+		s.vertexCapacity = vertices.capacity();
+		s.verticesUsed = vertices.usedUnits();
+		s.largestVertexRange = vertices.largestFree();
+		s.indexCapacity = indices.capacity();
+		s.indicesUsed = indices.usedUnits();
+		s.largestIndexRange = indices.largestFree();
+		s.defragmentations = defragmentations;
+		return s;
+	}
+
+	// 0 when all free space is one block, towards 1 when it is scattered
+	float fragmentation() const
+	{
+		float v = vertices.freeUnits() ? 1.0f - (float)vertices.largestFree() / vertices.freeUnits() : 0.0f;
+		float i = indices.freeUnits() ? 1.0f - (float)indices.largestFree() / indices.freeUnits() : 0.0f;
+		return v > i ? v : i;
+	}
+
+private:
+	struct Mesh {
+		unsigned int vertexBlock, indexBlock;
+		unsigned int indexCount;
+		bool live;
+	};
+
+	unsigned int VAO, VBO, EBO;
+	GLsizei stride;
+	GLenum type;
+	GLsizei indexSize;
+	TlsfAllocator vertices, indices;
+	std::vector<Mesh> meshes;
+	std::vector<unsigned int> unusedMeshes;
+	unsigned int defragmentations;
+
+	// pack the live ranges of one buffer into a scratch buffer, respecify the
+	// buffer at its new size and copy them back. sizes[i] receives each mesh's
+	// range length in units, in mesh order, which is also the packed order
+	void compact(unsigned int buffer, const TlsfAllocator &allocator, GLsizei unit, bool vertexRanges,
+		unsigned int capacity, std::vector<unsigned int> &sizes)
+	{
+		sizes.assign(meshes.size(), 0);
+		GLsizeiptr usedBytes = (GLsizeiptr)allocator.usedUnits() * unit;
+		unsigned int scratch = 0;
+		if (usedBytes > 0)
+		{
+			glGenBuffers(1, &scratch);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, scratch);
+			glBufferData(GL_COPY_WRITE_BUFFER, usedBytes, NULL, GL_STREAM_COPY);
+			glBindBuffer(GL_COPY_READ_BUFFER, buffer);
+		}
+		GLintptr packed = 0;
+		for (size_t i = 0; i < meshes.size(); i++)
+		{
+			if (!meshes[i].live)
+				continue;
+			unsigned int block = vertexRanges ? meshes[i].vertexBlock : meshes[i].indexBlock;
+			sizes[i] = allocator.size(block);
+			GLsizeiptr bytes = (GLsizeiptr)sizes[i] * unit;
+			if (bytes > 0)
+				glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, (GLintptr)allocator.offset(block) * unit, packed, bytes);
+			packed += bytes;
+		}
+
+		glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+		if (capacity != allocator.capacity())
+			glBufferData(GL_COPY_WRITE_BUFFER, (GLsizeiptr)capacity * unit, NULL, GL_DYNAMIC_DRAW);
+		if (usedBytes > 0)
+		{
+			glBindBuffer(GL_COPY_READ_BUFFER, scratch);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, usedBytes);
+			glDeleteBuffers(1, &scratch);
+		}
+	}
+
+	BufferArena(const BufferArena &);
+	BufferArena &operator=(const BufferArena &);
+};
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef COMMAND_BUFFER_H
+#define COMMAND_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cstring>
+#include <chrono>
+
+#include "thread_pool.h"
+#include "gl_state.h"
+
+// draws recorded as compact POD commands into a linear byte buffer instead of
+// being issued right away. recording touches no GL at all, so any thread can
+// do it; execute() then replays the buffer on the thread owning the context.
+//
+//   CommandBuffer commands;
+//   commands.useProgram(shader.ID);
+//   commands.uniformMatrix4(transformLoc, glm::value_ptr(trans));
+//   commands.drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT);
+//   ...
+//   commands.execute(&state);	// GL thread, through a GLState when given
+//
+// each command is a 4 byte header (type, size in bytes) followed by its
+// arguments; reset() keeps the storage, so a buffer stops allocating after the
+// first few frames
+class CommandBuffer {
+public:
+	enum Type {
+		USE_PROGRAM, BIND_VERTEX_ARRAY, BIND_TEXTURE, UNIFORM_MATRIX4, UNIFORM_4F, DRAW_ELEMENTS, DRAW_ARRAYS,
+		SET_ENABLED, BLEND_FUNC
+	};
+
+	CommandBuffer() : commands(0) {}
+
+	void reset()
+	{
+		bytes.clear();
+		commands = 0;
+	}
+
+	void useProgram(GLuint program)
+	{
+		push(USE_PROGRAM, &program, sizeof(program));
+	}
+
+	void bindVertexArray(GLuint vertexArray)
+	{
+		push(BIND_VERTEX_ARRAY, &vertexArray, sizeof(vertexArray));
+	}
+
+	// 'unit' 0 based
+	void bindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		GLuint args[3] = { unit, target, texture };
+		push(BIND_TEXTURE, args, sizeof(args));
+	}
+
+	// 16 floats, column major
+	void uniformMatrix4(GLint location, const float *matrix)
+	{
+		unsigned char args[sizeof(GLint) + 16 * sizeof(float)];
+		memcpy(args, &location, sizeof(GLint));
+		memcpy(args + sizeof(GLint), matrix, 16 * sizeof(float));
+		push(UNIFORM_MATRIX4, args, sizeof(args));
+	}
+
+	void uniform4f(GLint location, float x, float y, float z, float w)
+	{
+		unsigned char args[sizeof(GLint) + 4 * sizeof(float)];
+		float value[4] = { x, y, z, w };
+		memcpy(args, &location, sizeof(GLint));
+		memcpy(args + sizeof(GLint), value, sizeof(value));
+		push(UNIFORM_4F, args, sizeof(args));
+	}
+
+	// 'offset' in bytes into the bound element buffer
+	void drawElements(GLenum mode, GLsizei count, GLenum type, GLuint offset = 0, GLsizei instances = 1)
+	{
+		GLuint args[5] = { mode, (GLuint)count, type, offset, (GLuint)instances };
+		push(DRAW_ELEMENTS, args, sizeof(args));
+	}
+
+	void drawArrays(GLenum mode, GLint first, GLsizei count, GLsizei instances = 1)
+	{
+		GLuint args[4] = { mode, (GLuint)first, (GLuint)count, (GLuint)instances };
+		push(DRAW_ARRAYS, args, sizeof(args));
+	}
+
+	void setEnabled(GLenum cap, bool enabled)
+	{
+		GLuint args[2] = { cap, enabled ? 1u : 0u };
+		push(SET_ENABLED, args, sizeof(args));
+	}
+
+	void blendFunc(GLenum source, GLenum destination)
+	{
+		GLuint args[2] = { source, destination };
+		push(BLEND_FUNC, args, sizeof(args));
+	}
+
+	// replay every command in order. binds go through 'state' when given, so
+	// the redundant ones recorded by independent workers are dropped there
+	void execute(GLState *state = NULL) const
+	{
+		size_t at = 0;
+		while (at < bytes.size())
+		{
+			unsigned short header[2];
+			memcpy(header, &bytes[at], sizeof(header));
+			const unsigned char *args = &bytes[at + sizeof(header)];
+			at += sizeof(header) + header[1];
+
+			GLuint u[5];
+			float f[16];
+			GLint location;
+			switch (header[0])
+			{
+			case USE_PROGRAM:
+				memcpy(u, args, sizeof(GLuint));
+				if (state)
+					state->useProgram(u[0]);
+				else
+					glUseProgram(u[0]);
+				break;
+			case BIND_VERTEX_ARRAY:
+				memcpy(u, args, sizeof(GLuint));
+				if (state)
+					state->bindVertexArray(u[0]);
+				else
+					glBindVertexArray(u[0]);
+				break;
+			case BIND_TEXTURE:
+				memcpy(u, args, 3 * sizeof(GLuint));
+				if (state)
+					state->bindTexture((int)u[0], u[1], u[2]);
+				else
+				{
+					glActiveTexture(GL_TEXTURE0 + u[0]);
+					glBindTexture(u[1], u[2]);
+				}
+				break;
+			case UNIFORM_MATRIX4:
+				memcpy(&location, args, sizeof(GLint));
+				memcpy(f, args + sizeof(GLint), 16 * sizeof(float));
+				glUniformMatrix4fv(location, 1, GL_FALSE, f);
+				break;
+			case UNIFORM_4F:
+				memcpy(&location, args, sizeof(GLint));
+				memcpy(f, args + sizeof(GLint), 4 * sizeof(float));
+				glUniform4f(location, f[0], f[1], f[2], f[3]);
+				break;
+			case DRAW_ELEMENTS:
+				memcpy(u, args, 5 * sizeof(GLuint));
+				glDrawElementsInstanced(u[0], (GLsizei)u[1], u[2], (void*)(size_t)u[3], (GLsizei)u[4]);
+				break;
+			case DRAW_ARRAYS:
+				memcpy(u, args, 4 * sizeof(GLuint));
+				glDrawArraysInstanced(u[0], (GLint)u[1], (GLsizei)u[2], (GLsizei)u[3]);
+				break;
+			case SET_ENABLED:
+				memcpy(u, args, 2 * sizeof(GLuint));
+				if (state)
+					state->setEnabled(u[0], u[1] != 0);
+				else if (u[1])
+					glEnable(u[0]);
+				else
+					glDisable(u[0]);
+				break;
+			case BLEND_FUNC:
+				memcpy(u, args, 2 * sizeof(GLuint));
+				if (state)
+					state->blendFunc(u[0], u[1]);
+				else
+					glBlendFunc(u[0], u[1]);
+				break;
+			}
+		}
+	}
+
+	size_t size() const { return bytes.size(); }
+	size_t commandCount() const { return commands; }
+
+private:
+	std::vector<unsigned char> bytes;
+	size_t commands;
+
+	void push(Type type, const void *args, size_t size)
+	{
+		unsigned short header[2] = { (unsigned short)type, (unsigned short)size };
+		size_t at = bytes.size();
+		bytes.resize(at + sizeof(header) + size);
+		memcpy(&bytes[at], header, sizeof(header));
+		memcpy(&bytes[at + sizeof(header)], args, size);
+		commands++;
+	}
+};
+
+// records [0, count) items in parallel into one CommandBuffer per fixed range
+// and replays the ranges in order, so the result is the same as recording on
+// one thread however the ranges were scheduled. a range is only ever written
+// by the worker that runs it, no locking while recording
+//
+//   recorder.record(objects.size(), [&](CommandBuffer &commands, int begin, int end) {
+//       for (int i = begin; i < end; i++) ...
+//   });
+//   recorder.execute(&state);
+class ParallelRecorder {
+public:
+	struct Stats {
+		double recordSeconds, executeSeconds;
+		size_t commands, bytes;
+		int ranges, threads;
+	};
+
+	// 'rangesPerThread' ranges per pool thread balance uneven work
+	ParallelRecorder(ThreadPool &threadPool = ThreadPool::shared(), int rangesPerThread = 4)
+		: pool(threadPool), perThread(rangesPerThread), used(0)
+	{
+		memset(&stats, 0, sizeof(stats));
+	}
+
+	template <typename Record>
+	void record(int count, const Record &body)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		int ranges = pool.size() * perThread;
+		ranges = count < ranges ? (count > 0 ? count : 1) : ranges;
+		if ((int)buffers.size() < ranges)
+			buffers.resize(ranges);
+		used = ranges;
+		pool.parallelFor(ranges, [&](int first, int last) {
+			for (int r = first; r < last; r++)
+			{
+				buffers[r].reset();
+				body(buffers[r], (int)((long long)count * r / ranges), (int)((long long)count * (r + 1) / ranges));
+			}
+		});
+
+		stats.recordSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		stats.commands = stats.bytes = 0;
+		for (int r = 0; r < used; r++)
+		{
+			stats.commands += buffers[r].commandCount();
+			stats.bytes += buffers[r].size();
+		}
+		stats.ranges = ranges;
+		stats.threads = pool.size();
+	}
+
+	// GL thread only
+	void execute(GLState *state = NULL)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int r = 0; r < used; r++)
+			buffers[r].execute(state);
+		stats.executeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	const Stats &statistics() const { return stats; }
+
+private:
+	ThreadPool &pool;
+	int perThread;
+	int used;
+	std::vector<CommandBuffer> buffers;
+	Stats stats;
+
+	ParallelRecorder(const ParallelRecorder &);
+	ParallelRecorder &operator=(const ParallelRecorder &);
+};
+
+#endif
@@ -0,0 +1,419 @@
+#ifndef DAMAGE_TRACKER_H
+#define DAMAGE_TRACKER_H
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#define GLFW_EXPOSE_NATIVE_EGL
+#include <GLFW/glfw3native.h>
+#include <EGL/eglext.h>
+
+#include <vector>
+#include <deque>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <algorithm>
+
+// pixel rectangle, origin bottom left like glScissor
+struct DamageRect {
+	int x, y, width, height;
+
+	bool empty() const { return width <= 0 || height <= 0; }
+	long long area() const { return empty() ? 0 : (long long)width * height; }
+
+	bool intersects(const DamageRect &other) const
+	{
+		return !empty() && !other.empty() && x < other.x + other.width && other.x < x + width &&
+			y < other.y + other.height && other.y < y + height;
+	}
+
+	DamageRect merged(const DamageRect &other) const
+	{
+		if (empty())
+			return other;
+		if (other.empty())
+			return *this;
+		int left = std::min(x, other.x), bottom = std::min(y, other.y);
+		int right = std::max(x + width, other.x + other.width), top = std::max(y + height, other.y + other.height);
+		DamageRect r = { left, bottom, right - left, top - bottom };
+		return r;
+	}
+};
+
+// pixels covered by the object space box [minX, maxX] x [minY, maxY] (z = 0)
+// under 'matrix' (16 floats, column major, to clip space) in a viewport of
+// 'width' x 'height', grown by 'padding' pixels for edge pixels and filtering.
+// whole viewport when a corner is behind the eye
+inline DamageRect damageBounds(const float *matrix, float minX, float minY, float maxX, float maxY, int width, int height,
+	int padding = 2)
+{
+	float left = 1e30f, right = -1e30f, bottom = 1e30f, top = -1e30f;
+	for (int i = 0; i < 4; i++)
+	{
+		float px = (i & 1) ? maxX : minX, py = (i & 2) ? maxY : minY;
+		float x = matrix[0] * px + matrix[4] * py + matrix[12];
+		float y = matrix[1] * px + matrix[5] * py + matrix[13];
+		float w = matrix[3] * px + matrix[7] * py + matrix[15];
+		if (w <= 1e-6f)
+		{
+			DamageRect all = { 0, 0, width, height };
+			return all;
+		}
+		x = (x / w * 0.5f + 0.5f) * width;
+		y = (y / w * 0.5f + 0.5f) * height;
+		left = std::min(left, x);
+		right = std::max(right, x);
+		bottom = std::min(bottom, y);
+		top = std::max(top, y);
+	}
+	int x0 = std::max(0, (int)std::floor(left) - padding), y0 = std::max(0, (int)std::floor(bottom) - padding);
+	int x1 = std::min(width, (int)std::ceil(right) + padding), y1 = std::min(height, (int)std::ceil(top) + padding);
+	DamageRect r = { x0, y0, x1 - x0, y1 - y0 };
+	return r;
+}
+
+// which parts of a retained image have to be redrawn this frame. objects report
+// where they are every frame; one that changed damages both where it was and
+// where it is now. the damage is kept as a few rectangles: overlapping ones are
+// merged when that costs no extra area, and past 'maxRects' the pair whose
+// union wastes least is merged. the damage of the last few frames is kept too,
+// for drawing into an image that is more than one frame old (buffer age)
+//
+//   tracker.update(0, damageBounds(...), changed);
+//   const std::vector<DamageRect> &damage = tracker.collect(presenter.beginFrame());
+//   for each rect: glScissor, glClear, draw what intersects it
+//   tracker.endFrame();
+class DamageTracker {
+public:
+	// images older than this many frames are redrawn completely
+	static const int MAX_BUFFER_AGE = 4;
+
+	DamageTracker(int maxRectangles = 8)
+		: maxRects(maxRectangles), width(0), height(0), full(true)
+	{
+	}
+
+	// new image size, everything is damaged
+	void resize(int w, int h)
+	{
+		width = w;
+		height = h;
+		full = true;
+		history.clear();
+	}
+
+	// redraw everything next frame
+	void invalidate() { full = true; }
+
+	// object 'id' now covers 'bounds'. an unchanged object only damages
+	// anything when it moved
+	void update(unsigned int id, const DamageRect &bounds, bool changed = true)
+	{
+		if (id >= previous.size())
+		{
+			DamageRect none = { 0, 0, 0, 0 };
+			previous.resize(id + 1, none);
+		}
+		const DamageRect &before = previous[id];
+		bool moved = before.x != bounds.x || before.y != bounds.y || before.width != bounds.width || before.height != bounds.height;
+		if (changed || moved)
+		{
+			add(before);
+			add(bounds);
+		}
+		previous[id] = bounds;
+	}
+
+	// an area that changed for any other reason
+	void add(const DamageRect &rect)
+	{
+		DamageRect r = clip(rect);
+		if (!r.empty())
+			pending.push_back(r);
+	}
+
+	// the rectangles to redraw this frame, disjoint or merged. 'bufferAge' is
+	// how many frames ago the image drawn into was last drawn: 1 for a retained
+	// image, more for a swap chain (EGL_EXT_buffer_age), 0 when unknown
+	const std::vector<DamageRect> &collect(int bufferAge = 1)
+	{
+		rects.clear();
+		if (full || bufferAge <= 0 || bufferAge - 1 > (int)history.size())
+		{
+			DamageRect all = { 0, 0, width, height };
+			rects.push_back(all);
+			return rects;
+		}
+		for (size_t i = 0; i < pending.size(); i++)
+			insert(pending[i]);
+		for (int age = 1; age < bufferAge; age++)
+			for (size_t i = 0; i < history[age - 1].size(); i++)
+				insert(history[age - 1][i]);
+		return rects;
+	}
+
+	void endFrame()
+	{
+		if (full)
+		{
+			DamageRect all = { 0, 0, width, height };
+			pending.assign(1, all);
+		}
+		history.push_front(pending);
+		if ((int)history.size() > MAX_BUFFER_AGE - 1)
+			history.pop_back();
+		pending.clear();
+		full = false;
+	}
+
+	long long damagedPixels() const
+	{
+		long long pixels = 0;
+		for (size_t i = 0; i < rects.size(); i++)
+			pixels += rects[i].area();
+		return pixels;
+	}
+
+	float damagedFraction() const
+	{
+		return width > 0 && height > 0 ? (float)damagedPixels() / ((float)width * height) : 0.0f;
+	}
+
+private:
+	int maxRects;
+	int width, height;
+	bool full;
+	std::vector<DamageRect> previous, pending, rects;
+	std::deque<std::vector<DamageRect> > history;	// damage of the frames before, newest first
+
+	DamageRect clip(const DamageRect &rect) const
+	{
+		int x0 = std::max(rect.x, 0), y0 = std::max(rect.y, 0);
+		int x1 = std::min(rect.x + rect.width, width), y1 = std::min(rect.y + rect.height, height);
+		DamageRect r = { x0, y0, x1 - x0, y1 - y0 };
+		return r;
+	}
+
+	void insert(DamageRect rect)
+	{
+		// absorb every rectangle whose union with this one is no larger than both
+		for (bool merging = true; merging; )
+		{
+			merging = false;
+			for (size_t i = 0; i < rects.size(); i++)
+			{
+				DamageRect both = rect.merged(rects[i]);
+				if (both.area() <= rect.area() + rects[i].area())
+				{
+					rect = both;
+					rects.erase(rects.begin() + i);
+					merging = true;
+					break;
+				}
+			}
+		}
+		rects.push_back(rect);
+
+		while ((int)rects.size() > maxRects)
+		{
+			size_t bestA = 0, bestB = 1;
+			long long bestWaste = -1;
+			for (size_t a = 0; a < rects.size(); a++)
+				for (size_t b = a + 1; b < rects.size(); b++)
+				{
+					long long waste = rects[a].merged(rects[b]).area() - rects[a].area() - rects[b].area();
+					if (bestWaste < 0 || waste < bestWaste)
+					{
+						bestWaste = waste;
+						bestA = a;
+						bestB = b;
+					}
+				}
+			rects[bestA] = rects[bestA].merged(rects[bestB]);
+			rects.erase(rects.begin() + bestB);
+		}
+	}
+
+	DamageTracker(const DamageTracker &);
+	DamageTracker &operator=(const DamageTracker &);
+};
+
+// offscreen color target that keeps its content between frames, so only the
+// damaged parts need drawing. for windows whose back buffer can't be used for
+// that: without EGL_EXT_buffer_age its content after a swap is undefined.
+// present() copies the whole image to the window
+class RetainedTarget {
+public:
+	RetainedTarget(int width, int height)
+		: FBO(0), texture(0), w(0), h(0)
+	{
+		glGenFramebuffers(1, &FBO);
+		glGenTextures(1, &texture);
+		resize(width, height);
+	}
+
+	~RetainedTarget()
+	{
+		glDeleteFramebuffers(1, &FBO);
+		glDeleteTextures(1, &texture);
+	}
+
+	// content is lost, redraw everything afterwards
+	void resize(int width, int height)
+	{
+		w = std::max(width, 1);
+		h = std::max(height, 1);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "ERROR::RETAINED_TARGET::FRAMEBUFFER_INCOMPLETE" << std::endl;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	// draw into the retained image, viewport covers it
+	void bind() const
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glViewport(0, 0, w, h);
+	}
+
+	// copy to the default framebuffer and make it current again
+	void present() const
+	{
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		glBlitFramebuffer(0, 0, w, h, 0, 0, w, h, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	int width() const { return w; }
+	int height() const { return h; }
+
+private:
+	unsigned int FBO, texture;
+	int w, h;
+
+	RetainedTarget(const RetainedTarget &);
+	RetainedTarget &operator=(const RetainedTarget &);
+};
+
+// where a DamageTracker's frames are drawn and how they reach the window. on an
+// EGL surface with EGL_EXT_buffer_age they go straight into the back buffer and
+// only the damage since that buffer was last shown is redrawn; otherwise into a
+// RetainedTarget that is copied to the window. the swap hands the damage to the
+// compositor where EGL_KHR_swap_buffers_with_damage (or _EXT) is available.
+// GLFW uses EGL surfaces on Wayland, or anywhere with GLFW_CONTEXT_CREATION_API
+// set to GLFW_EGL_CONTEXT_API
+//
+//   const std::vector<DamageRect> &damage = tracker.collect(presenter.beginFrame());
+//   ... scissored clears and draws ...
+//   presenter.swap(damage);
+//   tracker.endFrame();
+class DamagePresenter {
+public:
+	DamagePresenter(GLFWwindow *glfwWindow, int width, int height)
+		: window(glfwWindow), display(glfwGetEGLDisplay()), surface(glfwGetEGLSurface(glfwWindow)),
+		swapWithDamage(NULL), retained(NULL), w(std::max(width, 1)), h(std::max(height, 1))
+	{
+		bool bufferAge = false;
+		if (display != EGL_NO_DISPLAY && surface != EGL_NO_SURFACE)
+		{
+			bufferAge = hasExtension("EGL_EXT_buffer_age");
+			if (hasExtension("EGL_KHR_swap_buffers_with_damage"))
+				swapWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageKHR");
+			else if (hasExtension("EGL_EXT_swap_buffers_with_damage"))
+				swapWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC)eglGetProcAddress("eglSwapBuffersWithDamageEXT");
+		}
+		if (!bufferAge)
+			retained = new RetainedTarget(w, h);
+	}
+
+	~DamagePresenter()
+	{
+		delete retained;
+	}
+
+	// frames go straight into the window's back buffer
+	bool direct() const { return retained == NULL; }
+	// the compositor is told what changed
+	bool damageHints() const { return swapWithDamage != NULL; }
+
+	// redraw everything afterwards
+	void resize(int width, int height)
+	{
+		w = std::max(width, 1);
+		h = std::max(height, 1);
+		if (retained)
+			retained->resize(w, h);
+	}
+
+	// binds the image to draw into and returns how many frames old its content
+	// is, for DamageTracker::collect
+	int beginFrame()
+	{
+		if (retained)
+		{
+			retained->bind();
+			return 1;
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(0, 0, w, h);
+		EGLint age = 0;
+		if (!eglQuerySurface(display, surface, EGL_BUFFER_AGE_EXT, &age))
+			age = 0;
+		return age;
+	}
+
+	// shows the frame, instead of glfwSwapBuffers. 'damage' is what was redrawn
+	void swap(const std::vector<DamageRect> &damage)
+	{
+		if (retained)
+			retained->present();
+		if (!swapWithDamage)
+		{
+			glfwSwapBuffers(window);
+			return;
+		}
+		// same origin as glScissor, bottom left. no rectangles means everything
+		rects.resize(damage.size() * 4);
+		for (size_t i = 0; i < damage.size(); i++)
+		{
+			rects[i * 4 + 0] = damage[i].x;
+			rects[i * 4 + 1] = damage[i].y;
+			rects[i * 4 + 2] = damage[i].width;
+			rects[i * 4 + 3] = damage[i].height;
+		}
+		swapWithDamage(display, surface, rects.empty() ? NULL : &rects[0], (EGLint)damage.size());
+	}
+
+	int width() const { return w; }
+	int height() const { return h; }
+
+private:
+	GLFWwindow *window;
+	EGLDisplay display;
+	EGLSurface surface;
+	PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swapWithDamage;
+	RetainedTarget *retained;
+	int w, h;
+	std::vector<EGLint> rects;
+
+	bool hasExtension(const char *name) const
+	{
+		const char *extensions = eglQueryString(display, EGL_EXTENSIONS);
+		size_t length = strlen(name);
+		for (const char *at = extensions; at && (at = strstr(at, name)) != NULL; at += length)
+			if ((at == extensions || at[-1] == ' ') && (at[length] == ' ' || at[length] == '\0'))
+				return true;
+		return false;
+	}
+
+	DamagePresenter(const DamagePresenter &);
+	DamagePresenter &operator=(const DamagePresenter &);
+};
+
+#endif
@@ -0,0 +1,234 @@
+#ifndef DRAW_BATCHER_H
+#define DRAW_BATCHER_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+#include "buffer_arena.h"
+#include "procedural_draw.h"
+
+// turns many small draws that share program, VAO and state into a handful of GL
+// calls. each draw carries 'floatsPerDraw' floats of its own (transform, color,
+// ...) which the vertex shader fetches from a buffer texture:
+//
+//   layout(location = 1) in uint drawIndex;	// 'drawIndexLocation'
+//   uniform samplerBuffer drawData;
+//   uniform int drawBase;
+//   ...
+//   int index = int(drawIndex) + drawBase;
+//   vec4 first = texelFetch(drawData, index * texelsPerDraw);
+//
+// drawIndex is an instanced attribute over 0, 1, 2, ... so it follows the base
+// instance of an indirect command. with GL 4.3 the whole batch is one
+// glMultiDrawElementsIndirect. on 3.3 draws of the same mesh are grouped and
+// each group becomes one instanced call with drawBase at the group start, the
+// same shader serves both. batched draws may run in any order, keep blended
+// draws that depend on order out of a batch
+//
+//   batcher.clear();
+//   for (...) batcher.add(arena.range(mesh), data);
+//   batcher.bind(0);	// data texture on unit 0
+//   batcher.draw(drawBaseLoc);
+class DrawBatcher {
+public:
+	struct Stats {
+		size_t draws;		// add() calls
+		size_t calls;		// GL draw calls actually issued
+		size_t commands;	// indirect commands, 0 without indirect
+	};
+
+	// 'vertexArray' gets the drawIndex attribute, e.g. BufferArena::vertexArray().
+	// 'floatsPerDraw' is rounded up to whole RGBA32F texels
+	DrawBatcher(GLuint vertexArray, GLuint drawIndexLocation, int floatsPerDraw, GLenum indexType = GL_UNSIGNED_SHORT,
+		bool allowIndirect = true)
+		: VAO(vertexArray), floats(floatsPerDraw), texels((floatsPerDraw + 3) / 4), type(indexType),
+		indexSize((int)indexTypeSize(indexType)), useIndirect(allowIndirect && GLAD_GL_VERSION_4_3),
+		drawIndexCapacity(0), commandBuffer(0)
+	{
+		memset(&stats, 0, sizeof(stats));
+		glGenBuffers(1, &drawIndexBuffer);
+		glBindVertexArray(VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+		glVertexAttribIPointer(drawIndexLocation, 1, GL_UNSIGNED_INT, 0, (void*)0);
+		glVertexAttribDivisor(drawIndexLocation, 1);
+		glEnableVertexAttribArray(drawIndexLocation);
+		glBindVertexArray(0);
+		reserveDrawIndices(1024);
+		if (GLAD_GL_VERSION_4_3)
+			glGenBuffers(1, &commandBuffer);
+	}
+
+	~DrawBatcher()
+	{
+		glDeleteBuffers(1, &drawIndexBuffer);
+		if (commandBuffer)
+			glDeleteBuffers(1, &commandBuffer);
+	}
+
+	void clear()
+	{
+		ranges.clear();
+		data.clear();
+	}
+
+	// 'values' holds the floatsPerDraw floats given to the constructor, the
+	// rest of the last texel stays zero
+	void add(const BufferArena::Range &range, const float *values)
+	{
+		ranges.push_back(range);
+		size_t at = data.size();
+		data.resize(at + texels * 4, 0.0f);
+		memcpy(&data[at], values, floats * sizeof(float));
+	}
+
+	// data texture on 'unit', set the drawData sampler to it
+	void bind(int unit) const
+	{
+		dataTexture.bind(unit);
+	}
+
+	// everything added since clear(), the program must be in use
+	void draw(GLint drawBaseLocation)
+	{
+		stats.draws = ranges.size();
+		stats.calls = stats.commands = 0;
+		if (ranges.empty())
+			return;
+		reserveDrawIndices(ranges.size());
+		glBindVertexArray(VAO);
+		if (useIndirect)
+			drawIndirect(drawBaseLocation);
+		else
+			drawGrouped(drawBaseLocation);
+	}
+
+	// one glDrawElementsBaseVertex per draw, what the batch replaces
+	void drawDirect(GLint drawBaseLocation)
+	{
+		stats.draws = stats.calls = ranges.size();
+		stats.commands = 0;
+		if (ranges.empty())
+			return;
+		dataTexture.upload(&data[0], (GLsizeiptr)(data.size() * sizeof(float)), GL_STREAM_DRAW);
+		glBindVertexArray(VAO);
+		for (size_t i = 0; i < ranges.size(); i++)
+		{
+			glUniform1i(drawBaseLocation, (GLint)i);
+			glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)ranges[i].count, type,
+				(void*)((size_t)ranges[i].firstIndex * indexSize), ranges[i].baseVertex);
+		}
+	}
+
+	// the instanced fallback can be forced for comparison, indirect needs 4.3
+	void setIndirect(bool enabled) { useIndirect = enabled && GLAD_GL_VERSION_4_3; }
+	bool indirect() const { return useIndirect; }
+	const Stats &statistics() const { return stats; }
+
+private:
+	// layout fixed by GL
+	struct DrawElementsIndirectCommand {
+		GLuint count, instanceCount, firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+	GLuint VAO;
+	int floats, texels;
+	GLenum type;
+	int indexSize;
+	bool useIndirect;
+	GLuint drawIndexBuffer;
+	size_t drawIndexCapacity;
+	GLuint commandBuffer;
+	InstanceTexture dataTexture;
+	std::vector<BufferArena::Range> ranges;
+	std::vector<float> data, grouped;
+	std::vector<unsigned int> order;
+	std::vector<DrawElementsIndirectCommand> commands;
+	Stats stats;
+
+	DrawBatcher(const DrawBatcher &);
+	DrawBatcher &operator=(const DrawBatcher &);
+
+	static bool sameMesh(const BufferArena::Range &a, const BufferArena::Range &b)
+	{
+		return a.firstIndex == b.firstIndex && a.baseVertex == b.baseVertex && a.count == b.count;
+	}
+
+	// instance i of any call reads drawIndex i
+	void reserveDrawIndices(size_t count)
+	{
+		if (count <= drawIndexCapacity)
+			return;
+		drawIndexCapacity = std::max(count, drawIndexCapacity * 2);
+		std::vector<GLuint> indices(drawIndexCapacity);
+		for (size_t i = 0; i < indices.size(); i++)
+			indices[i] = (GLuint)i;
+		glBindBuffer(GL_ARRAY_BUFFER, drawIndexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(indices.size() * sizeof(GLuint)), &indices[0], GL_STATIC_DRAW);
+	}
+
+	// one command per run of the same mesh, baseInstance points at its data
+	void drawIndirect(GLint drawBaseLocation)
+	{
+		commands.clear();
+		for (size_t i = 0; i < ranges.size(); i++)
+		{
+			if (!commands.empty() && sameMesh(ranges[i], ranges[i - 1]))
+			{
+				commands.back().instanceCount++;
+				continue;
+			}
+			DrawElementsIndirectCommand command = { ranges[i].count, 1, ranges[i].firstIndex, ranges[i].baseVertex, (GLuint)i };
+			commands.push_back(command);
+		}
+		dataTexture.upload(&data[0], (GLsizeiptr)(data.size() * sizeof(float)), GL_STREAM_DRAW);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commandBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, (GLsizeiptr)(commands.size() * sizeof(DrawElementsIndirectCommand)),
+			&commands[0], GL_STREAM_DRAW);
+		glUniform1i(drawBaseLocation, 0);
+		glMultiDrawElementsIndirect(GL_TRIANGLES, type, (void*)0, (GLsizei)commands.size(), 0);
+		stats.calls = 1;
+		stats.commands = commands.size();
+	}
+
+	// no base instance: sort the draws by mesh, upload their data in that
+	// order and draw each mesh instanced with drawBase at its first draw
+	void drawGrouped(GLint drawBaseLocation)
+	{
+		order.resize(ranges.size());
+		for (size_t i = 0; i < order.size(); i++)
+			order[i] = (unsigned int)i;
+		const std::vector<BufferArena::Range> &r = ranges;
+		std::stable_sort(order.begin(), order.end(), [&r](unsigned int a, unsigned int b) {
+			if (r[a].firstIndex != r[b].firstIndex)
+				return r[a].firstIndex < r[b].firstIndex;
+			return r[a].baseVertex < r[b].baseVertex;
+		});
+
+		size_t stride = texels * 4;
+		grouped.resize(data.size());
+		for (size_t i = 0; i < order.size(); i++)
+			memcpy(&grouped[i * stride], &data[order[i] * stride], stride * sizeof(float));
+		dataTexture.upload(&grouped[0], (GLsizeiptr)(grouped.size() * sizeof(float)), GL_STREAM_DRAW);
+
+		size_t begin = 0;
+		while (begin < order.size())
+		{
+			const BufferArena::Range &mesh = ranges[order[begin]];
+			size_t end = begin + 1;
+			while (end < order.size() && sameMesh(ranges[order[end]], mesh))
+				end++;
+			glUniform1i(drawBaseLocation, (GLint)begin);
+			glDrawElementsInstancedBaseVertex(GL_TRIANGLES, (GLsizei)mesh.count, type,
+				(void*)((size_t)mesh.firstIndex * indexSize), (GLsizei)(end - begin), mesh.baseVertex);
+			stats.calls++;
+			begin = end;
+		}
+	}
+};
+
+#endif
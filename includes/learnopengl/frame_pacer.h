@@ -0,0 +1,193 @@
+#ifndef FRAME_PACER_H
+#define FRAME_PACER_H
+
+#include <GLFW/glfw3.h>
+
+#include <atomic>
+#include <cstring>
+
+// render on demand: instead of redrawing the same frame as fast as possible the
+// loop sleeps in glfwWaitEventsTimeout and only renders when something changed
+//
+//   FramePacer pacer(window);
+//   while (!glfwWindowShouldClose(window))
+//   {
+//       processInput(window);
+//       if (pacer.beginFrame())
+//       {
+//           ... render ...
+//           glfwSwapBuffers(window);
+//       }
+//       pacer.waitEvents();
+//   }
+//
+// key, mouse button, scroll, resize, expose, focus and iconify events
+// invalidate the frame by themselves. everything else the picture depends on
+// has to say so: invalidate() for one change (cursor moves, a loaded
+// resource), setAnimating() while it changes every frame, invalidateAsync()
+// from other threads. with 'onDemand' false the loop renders every iteration
+// as before and only counts how many of those frames changed nothing.
+//
+// the pacer installs its callbacks over the window's and calls the previous
+// ones, so create it after the sample set its own. it owns the window's
+// user pointer
+class FramePacer {
+public:
+	struct Stats {
+		unsigned long long rendered;	// frames drawn
+		unsigned long long skipped;		// wakeups with nothing to draw (on demand)
+		unsigned long long unchanged;	// frames drawn although nothing changed (continuous)
+	};
+
+	// 'timeout' bounds the sleep, so a loop still wakes up now and then to
+	// report or to poll what has no event
+	FramePacer(GLFWwindow *glfwWindow, bool onDemand = true, double timeout = 0.5)
+		: window(glfwWindow), demand(onDemand), waitTimeout(timeout), dirty(true), animating(false), pending(false)
+	{
+		memset(&counts, 0, sizeof(counts));
+		glfwSetWindowUserPointer(window, this);
+		previousKey = glfwSetKeyCallback(window, keyCallback);
+		previousButton = glfwSetMouseButtonCallback(window, buttonCallback);
+		previousScroll = glfwSetScrollCallback(window, scrollCallback);
+		previousSize = glfwSetFramebufferSizeCallback(window, sizeCallback);
+		previousRefresh = glfwSetWindowRefreshCallback(window, refreshCallback);
+		previousFocus = glfwSetWindowFocusCallback(window, focusCallback);
+		previousIconify = glfwSetWindowIconifyCallback(window, iconifyCallback);
+	}
+
+	~FramePacer()
+	{
+		glfwSetKeyCallback(window, previousKey);
+		glfwSetMouseButtonCallback(window, previousButton);
+		glfwSetScrollCallback(window, previousScroll);
+		glfwSetFramebufferSizeCallback(window, previousSize);
+		glfwSetWindowRefreshCallback(window, previousRefresh);
+		glfwSetWindowFocusCallback(window, previousFocus);
+		glfwSetWindowIconifyCallback(window, previousIconify);
+		glfwSetWindowUserPointer(window, NULL);
+	}
+
+	// the next frame differs from the last one
+	void invalidate() { dirty = true; }
+
+	// any thread, wakes the GL thread up when it is waiting
+	void invalidateAsync()
+	{
+		pending = true;
+		glfwPostEmptyEvent();
+	}
+
+	// render every frame while set, e.g. during a time based animation
+	void setAnimating(bool enabled) { animating = enabled; }
+	bool isAnimating() const { return animating; }
+	bool onDemand() const { return demand; }
+
+	// true when this iteration has to render
+	bool beginFrame()
+	{
+		bool changed = dirty || animating || pending.exchange(false);
+		dirty = false;
+		if (!demand)
+		{
+			counts.rendered++;
+			if (!changed)
+				counts.unchanged++;
+			return true;
+		}
+		if (changed)
+			counts.rendered++;
+		else
+			counts.skipped++;
+		return changed;
+	}
+
+	// instead of glfwPollEvents(): blocks until an event or the timeout unless
+	// the next frame is already known to change
+	void waitEvents()
+	{
+		if (demand && !dirty && !animating && !pending)
+			glfwWaitEventsTimeout(waitTimeout);
+		else
+			glfwPollEvents();
+	}
+
+	const Stats &stats() const { return counts; }
+	void resetStats() { memset(&counts, 0, sizeof(counts)); }
+
+private:
+	GLFWwindow *window;
+	bool demand;
+	double waitTimeout;
+	bool dirty, animating;
+	std::atomic<bool> pending;
+	Stats counts;
+
+	GLFWkeyfun previousKey;
+	GLFWmousebuttonfun previousButton;
+	GLFWscrollfun previousScroll;
+	GLFWframebuffersizefun previousSize;
+	GLFWwindowrefreshfun previousRefresh;
+	GLFWwindowfocusfun previousFocus;
+	GLFWwindowiconifyfun previousIconify;
+
+	FramePacer(const FramePacer &);
+	FramePacer &operator=(const FramePacer &);
+
+	static FramePacer *from(GLFWwindow *window)
+	{
+		FramePacer *pacer = (FramePacer*)glfwGetWindowUserPointer(window);
+		pacer->dirty = true;
+		return pacer;
+	}
+
+	static void keyCallback(GLFWwindow *window, int key, int scancode, int action, int mods)
+	{
+		FramePacer *pacer = from(window);
+		if (pacer->previousKey)
+			pacer->previousKey(window, key, scancode, action, mods);
+	}
+
+	static void buttonCallback(GLFWwindow *window, int button, int action, int mods)
+	{
+		FramePacer *pacer = from(window);
+		if (pacer->previousButton)
+			pacer->previousButton(window, button, action, mods);
+	}
+
+	static void scrollCallback(GLFWwindow *window, double x, double y)
+	{
+		FramePacer *pacer = from(window);
+		if (pacer->previousScroll)
+			pacer->previousScroll(window, x, y);
+	}
+
+	static void sizeCallback(GLFWwindow *window, int width, int height)
+	{
+		FramePacer *pacer = from(window);
+		if (pacer->previousSize)
+			pacer->previousSize(window, width, height);
+	}
+
+	static void refreshCallback(GLFWwindow *window)
+	{
+		FramePacer *pacer = from(window);
+		if (pacer->previousRefresh)
+			pacer->previousRefresh(window);
+	}
+
+	static void focusCallback(GLFWwindow *window, int focused)
+	{
+		FramePacer *pacer = from(window);
+		if (pacer->previousFocus)
+			pacer->previousFocus(window, focused);
+	}
+
+	static void iconifyCallback(GLFWwindow *window, int iconified)
+	{
+		FramePacer *pacer = from(window);
+		if (pacer->previousIconify)
+			pacer->previousIconify(window, iconified);
+	}
+};
+
+#endif
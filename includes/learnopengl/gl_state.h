@@ -0,0 +1,429 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+#include <glad/glad.h>
+
+#include <cstring>
+#include <iostream>
+
+// shadow of the GL state the samples touch every frame: program, VAO, active
+// texture unit and texture bindings, buffer bindings, capabilities, blend and
+// depth state, viewport and clear color. calls go through here and only reach
+// GL when they change something.
+//
+//   GLState state;
+//   state.useProgram(shader.ID);
+//   state.bindTexture(0, GL_TEXTURE_2D, texture);	// unit 0
+//   state.enable(GL_BLEND);
+//   ...
+//   state.endFrame();	// per frame counts in lastFrame()
+//
+// state set around the tracker (glViewport in a callback, a helper binding its
+// own buffers) makes the shadow wrong; call invalidate() afterwards, or turn on
+// validation, which compares the shadow against glGet* after every call and
+// reports the first call that finds it out of date
+class GLState {
+public:
+	enum Kind { PROGRAM, VERTEX_ARRAY, ACTIVE_TEXTURE, TEXTURE, BUFFER, CAPABILITY, BLEND, DEPTH, VIEWPORT, CLEAR_COLOR, KIND_COUNT };
+	enum { MAX_UNITS = 16, TARGETS = 5, BUFFER_TARGETS = 6, CAPABILITIES = 6 };
+
+	struct Counts {
+		unsigned long long forwarded[KIND_COUNT];
+		unsigned long long elided[KIND_COUNT];
+		unsigned long long mismatches;	// only counted with validation on
+
+		unsigned long long totalForwarded() const { return sum(forwarded); }
+		unsigned long long totalElided() const { return sum(elided); }
+
+	private:
+		static unsigned long long sum(const unsigned long long *values)
+		{
+			unsigned long long total = 0;
+			for (int i = 0; i < KIND_COUNT; i++)
+				total += values[i];
+			return total;
+		}
+	};
+
+	GLState(bool validation = false) : validating(validation)
+	{
+		invalidate();
+		memset(&frame, 0, sizeof(frame));
+		memset(&previous, 0, sizeof(previous));
+	}
+
+	// forget everything, the next call of each kind goes to GL
+	void invalidate()
+	{
+		program = vertexArray = UNKNOWN;
+		activeUnit = UNKNOWN;
+		for (int unit = 0; unit < MAX_UNITS; unit++)
+			for (int target = 0; target < TARGETS; target++)
+				textures[unit][target] = UNKNOWN;
+		for (int target = 0; target < BUFFER_TARGETS; target++)
+			buffers[target] = UNKNOWN;
+		for (int cap = 0; cap < CAPABILITIES; cap++)
+			capabilities[cap] = UNKNOWN;
+		blend[0] = blend[1] = blend[2] = blend[3] = UNKNOWN;
+		depthFunction = depthWrite = UNKNOWN;
+		viewportRect[0] = viewportRect[1] = viewportRect[2] = viewportRect[3] = -1;
+		clearKnown = false;
+	}
+
+	void setValidation(bool enabled) { validating = enabled; }
+	bool validation() const { return validating; }
+
+	void useProgram(GLuint id)
+	{
+		if (change(program, id, PROGRAM))
+			glUseProgram(id);
+		check(PROGRAM, "useProgram");
+	}
+
+	void bindVertexArray(GLuint id)
+	{
+		if (change(vertexArray, id, VERTEX_ARRAY))
+		{
+			glBindVertexArray(id);
+			// the element buffer binding belongs to the VAO
+			buffers[bufferIndex(GL_ELEMENT_ARRAY_BUFFER)] = UNKNOWN;
+		}
+		check(VERTEX_ARRAY, "bindVertexArray");
+	}
+
+	// 'unit' as GL_TEXTURE0 + n like glActiveTexture
+	void activeTexture(GLenum unit)
+	{
+		if (change(activeUnit, unit, ACTIVE_TEXTURE))
+			glActiveTexture(unit);
+		check(ACTIVE_TEXTURE, "activeTexture");
+	}
+
+	// bind on the active unit
+	void bindTexture(GLenum target, GLuint texture)
+	{
+		int t = targetIndex(target);
+		int unit = (int)activeUnit - GL_TEXTURE0;
+		if (t < 0 || activeUnit == UNKNOWN || unit >= MAX_UNITS)
+		{
+			glBindTexture(target, texture);
+			frame.forwarded[TEXTURE]++;
+			return;
+		}
+		if (change(textures[unit][t], texture, TEXTURE))
+			glBindTexture(target, texture);
+		check(TEXTURE, "bindTexture");
+	}
+
+	// select 'unit' (0 based) only if the binding there has to change
+	void bindTexture(int unit, GLenum target, GLuint texture)
+	{
+		int t = targetIndex(target);
+		if (t >= 0 && unit < MAX_UNITS && textures[unit][t] == texture)
+		{
+			frame.elided[TEXTURE]++;
+			check(TEXTURE, "bindTexture");
+			return;
+		}
+		activeTexture(GL_TEXTURE0 + unit);
+		bindTexture(target, texture);
+	}
+
+	void bindBuffer(GLenum target, GLuint buffer)
+	{
+		int t = bufferIndex(target);
+		if (t < 0)
+		{
+			glBindBuffer(target, buffer);
+			frame.forwarded[BUFFER]++;
+			return;
+		}
+		if (change(buffers[t], buffer, BUFFER))
+			glBindBuffer(target, buffer);
+		check(BUFFER, "bindBuffer");
+	}
+
+	void enable(GLenum cap) { setEnabled(cap, true); }
+	void disable(GLenum cap) { setEnabled(cap, false); }
+
+	void setEnabled(GLenum cap, bool enabled)
+	{
+		int c = capabilityIndex(cap);
+		if (c < 0 || change(capabilities[c], enabled ? 1u : 0u, CAPABILITY))
+		{
+			if (enabled)
+				glEnable(cap);
+			else
+				glDisable(cap);
+			if (c < 0)
+				frame.forwarded[CAPABILITY]++;
+		}
+		check(CAPABILITY, "setEnabled");
+	}
+
+	void blendFunc(GLenum source, GLenum destination)
+	{
+		blendFuncSeparate(source, destination, source, destination);
+	}
+
+	void blendFuncSeparate(GLenum sourceRGB, GLenum destinationRGB, GLenum sourceAlpha, GLenum destinationAlpha)
+	{
+		GLuint wanted[4] = { sourceRGB, destinationRGB, sourceAlpha, destinationAlpha };
+		if (memcmp(blend, wanted, sizeof(wanted)) == 0)
+			frame.elided[BLEND]++;
+		else
+		{
+			memcpy(blend, wanted, sizeof(wanted));
+			glBlendFuncSeparate(sourceRGB, destinationRGB, sourceAlpha, destinationAlpha);
+			frame.forwarded[BLEND]++;
+		}
+		check(BLEND, "blendFunc");
+	}
+
+	void depthFunc(GLenum function)
+	{
+		if (change(depthFunction, function, DEPTH))
+			glDepthFunc(function);
+		check(DEPTH, "depthFunc");
+	}
+
+	void depthMask(GLboolean write)
+	{
+		if (change(depthWrite, write ? 1u : 0u, DEPTH))
+			glDepthMask(write);
+		check(DEPTH, "depthMask");
+	}
+
+	void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+	{
+		GLint wanted[4] = { x, y, width, height };
+		if (memcmp(viewportRect, wanted, sizeof(wanted)) == 0)
+			frame.elided[VIEWPORT]++;
+		else
+		{
+			memcpy(viewportRect, wanted, sizeof(wanted));
+			glViewport(x, y, width, height);
+			frame.forwarded[VIEWPORT]++;
+		}
+		check(VIEWPORT, "viewport");
+	}
+
+	void clearColor(GLfloat r, GLfloat g, GLfloat b, GLfloat a)
+	{
+		GLfloat wanted[4] = { r, g, b, a };
+		if (clearKnown && memcmp(clear, wanted, sizeof(wanted)) == 0)
+			frame.elided[CLEAR_COLOR]++;
+		else
+		{
+			memcpy(clear, wanted, sizeof(wanted));
+			clearKnown = true;
+			glClearColor(r, g, b, a);
+			frame.forwarded[CLEAR_COLOR]++;
+		}
+		check(CLEAR_COLOR, "clearColor");
+	}
+
+	// compare every known part of the shadow with GL, returns the number of mismatches
+	int validate()
+	{
+		int mismatches = 0;
+		for (int kind = 0; kind < KIND_COUNT; kind++)
+			mismatches += compare(kind, "validate");
+		return mismatches;
+	}
+
+	// close the frame's counts, they are kept in lastFrame() until the next one
+	void endFrame()
+	{
+		previous = frame;
+		memset(&frame, 0, sizeof(frame));
+	}
+
+	const Counts &lastFrame() const { return previous; }
+	const Counts &currentFrame() const { return frame; }
+
+	static const char *kindName(int kind)
+	{
+		static const char *names[KIND_COUNT] = { "program", "vertex array", "active texture", "texture", "buffer",
+			"capability", "blend", "depth", "viewport", "clear color" };
+		return names[kind];
+	}
+
+private:
+	static const GLuint UNKNOWN = 0xffffffffu;
+
+	bool validating;
+	GLuint program, vertexArray, activeUnit;
+	GLuint textures[MAX_UNITS][TARGETS];
+	GLuint buffers[BUFFER_TARGETS];
+	GLuint capabilities[CAPABILITIES];
+	GLuint blend[4];
+	GLuint depthFunction, depthWrite;
+	GLint viewportRect[4];
+	GLfloat clear[4];
+	bool clearKnown;
+	Counts frame, previous;
+
+	static const GLenum *textureTargets()
+	{
+		static const GLenum targets[TARGETS] = { GL_TEXTURE_2D, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_BUFFER };
+		return targets;
+	}
+
+	static const GLenum *textureBindings()
+	{
+		static const GLenum bindings[TARGETS] = { GL_TEXTURE_BINDING_2D, GL_TEXTURE_BINDING_2D_ARRAY, GL_TEXTURE_BINDING_3D,
+			GL_TEXTURE_BINDING_CUBE_MAP, GL_TEXTURE_BINDING_BUFFER };
+		return bindings;
+	}
+
+	static const GLenum *bufferTargets()
+	{
+		static const GLenum targets[BUFFER_TARGETS] = { GL_ARRAY_BUFFER, GL_ELEMENT_ARRAY_BUFFER, GL_UNIFORM_BUFFER,
+			GL_TEXTURE_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER };
+		return targets;
+	}
+
+	static const GLenum *bufferBindings()
+	{
+		static const GLenum bindings[BUFFER_TARGETS] = { GL_ARRAY_BUFFER_BINDING, GL_ELEMENT_ARRAY_BUFFER_BINDING,
+			GL_UNIFORM_BUFFER_BINDING, GL_TEXTURE_BUFFER, GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER };
+		return bindings;
+	}
+
+	static const GLenum *capabilityList()
+	{
+		static const GLenum caps[CAPABILITIES] = { GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_SCISSOR_TEST, GL_STENCIL_TEST,
+			GL_PROGRAM_POINT_SIZE };
+		return caps;
+	}
+
+	static int find(const GLenum *list, int count, GLenum value)
+	{
+		for (int i = 0; i < count; i++)
+			if (list[i] == value)
+				return i;
+		return -1;
+	}
+
+	static int targetIndex(GLenum target) { return find(textureTargets(), TARGETS, target); }
+	static int bufferIndex(GLenum target) { return find(bufferTargets(), BUFFER_TARGETS, target); }
+	static int capabilityIndex(GLenum cap) { return find(capabilityList(), CAPABILITIES, cap); }
+
+	// update one shadow value, true when GL has to be told
+	bool change(GLuint &shadow, GLuint value, Kind kind)
+	{
+		if (shadow == value)
+		{
+			frame.elided[kind]++;
+			return false;
+		}
+		shadow = value;
+		frame.forwarded[kind]++;
+		return true;
+	}
+
+	void check(int kind, const char *call)
+	{
+		if (validating)
+			compare(kind, call);
+	}
+
+	int report(const char *call, const char *what, GLint shadow, GLint actual)
+	{
+		std::cout << "ERROR::GL_STATE::MISMATCH after " << call << ": " << what << " is " << actual << ", shadow has " << shadow
+			<< std::endl;
+		frame.mismatches++;
+		return 1;
+	}
+
+	int compareValue(const char *call, const char *what, GLuint shadow, GLenum query)
+	{
+		if (shadow == UNKNOWN)
+			return 0;
+		GLint actual;
+		glGetIntegerv(query, &actual);
+		return (GLuint)actual != shadow ? report(call, what, (GLint)shadow, actual) : 0;
+	}
+
+	int compare(int kind, const char *call)
+	{
+		int mismatches = 0;
+		switch (kind)
+		{
+		case PROGRAM:
+			return compareValue(call, "GL_CURRENT_PROGRAM", program, GL_CURRENT_PROGRAM);
+		case VERTEX_ARRAY:
+			return compareValue(call, "GL_VERTEX_ARRAY_BINDING", vertexArray, GL_VERTEX_ARRAY_BINDING);
+		case ACTIVE_TEXTURE:
+			return compareValue(call, "GL_ACTIVE_TEXTURE", activeUnit, GL_ACTIVE_TEXTURE);
+		case TEXTURE:
+		{
+			// every known unit, the active one restored afterwards
+			GLint active;
+			glGetIntegerv(GL_ACTIVE_TEXTURE, &active);
+			for (int unit = 0; unit < MAX_UNITS; unit++)
+				for (int t = 0; t < TARGETS; t++)
+					if (textures[unit][t] != UNKNOWN)
+					{
+						glActiveTexture(GL_TEXTURE0 + unit);
+						mismatches += compareValue(call, "texture binding", textures[unit][t], textureBindings()[t]);
+					}
+			glActiveTexture(active);
+			return mismatches;
+		}
+		case BUFFER:
+			for (int t = 0; t < BUFFER_TARGETS; t++)
+				mismatches += compareValue(call, "buffer binding", buffers[t], bufferBindings()[t]);
+			return mismatches;
+		case CAPABILITY:
+			for (int c = 0; c < CAPABILITIES; c++)
+				if (capabilities[c] != UNKNOWN && (GLuint)glIsEnabled(capabilityList()[c]) != capabilities[c])
+					mismatches += report(call, "capability", capabilities[c], !capabilities[c]);
+			return mismatches;
+		case BLEND:
+			mismatches += compareValue(call, "GL_BLEND_SRC_RGB", blend[0], GL_BLEND_SRC_RGB);
+			mismatches += compareValue(call, "GL_BLEND_DST_RGB", blend[1], GL_BLEND_DST_RGB);
+			mismatches += compareValue(call, "GL_BLEND_SRC_ALPHA", blend[2], GL_BLEND_SRC_ALPHA);
+			mismatches += compareValue(call, "GL_BLEND_DST_ALPHA", blend[3], GL_BLEND_DST_ALPHA);
+			return mismatches;
+		case DEPTH:
+		{
+			mismatches += compareValue(call, "GL_DEPTH_FUNC", depthFunction, GL_DEPTH_FUNC);
+			GLboolean write;
+			glGetBooleanv(GL_DEPTH_WRITEMASK, &write);
+			if (depthWrite != UNKNOWN && (GLuint)(write ? 1 : 0) != depthWrite)
+				mismatches += report(call, "GL_DEPTH_WRITEMASK", depthWrite, write);
+			return mismatches;
+		}
+		case VIEWPORT:
+		{
+			if (viewportRect[2] < 0)
+				return 0;
+			GLint actual[4];
+			glGetIntegerv(GL_VIEWPORT, actual);
+			for (int i = 0; i < 4; i++)
+				if (actual[i] != viewportRect[i])
+					mismatches += report(call, "GL_VIEWPORT", viewportRect[i], actual[i]);
+			return mismatches;
+		}
+		case CLEAR_COLOR:
+		{
+			if (!clearKnown)
+				return 0;
+			GLfloat actual[4];
+			glGetFloatv(GL_COLOR_CLEAR_VALUE, actual);
+			for (int i = 0; i < 4; i++)
+				if (actual[i] != clear[i])
+					mismatches += report(call, "GL_COLOR_CLEAR_VALUE", (GLint)(clear[i] * 255.0f), (GLint)(actual[i] * 255.0f));
+			return mismatches;
+		}
+		}
+		return 0;
+	}
+
+	GLState(const GLState &);
+	GLState &operator=(const GLState &);
+};
+
+#endif
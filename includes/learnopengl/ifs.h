@@ -0,0 +1,713 @@
+#ifndef IFS_H
+#define IFS_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <queue>
+#include <cmath>
+#include <cstring>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IFS_X86 1
+#endif
+
+#include "thread_pool.h"
+
+// iterated function systems: a set of contracting affine maps whose repeated
+// composition approximates a fractal. expandIFS builds every composition up to
+// a depth breadth first, level n holding maps^n transforms, and stores them as
+// structure of arrays so each map can be applied to 4 or 8 parents at once.
+//
+//   std::vector<AffineMap> maps = ...;
+//   IFSTransforms transforms;
+//   expandIFS(maps, depth, transforms);
+//   uploadIFSInstances(transforms, transforms.levelBegin(depth - 1), transforms.size(), VBO, 3);
+
+// x' = a x + b y + e
+// y' = c x + d y + f
+struct AffineMap {
+	float a, b, c, d, e, f;
+};
+
+inline AffineMap makeAffineMap(float a, float b, float c, float d, float e, float f)
+{
+	AffineMap m = { a, b, c, d, e, f };
+	return m;
+}
+
+// uniform scale and rotation (radians) followed by a translation
+inline AffineMap makeSimilarity(float scale, float rotation, float tx, float ty)
+{
+	float cs = scale * cosf(rotation), sn = scale * sinf(rotation);
+	return makeAffineMap(cs, -sn, sn, cs, tx, ty);
+}
+
+// the map applying 'inner' first and 'outer' second
+inline AffineMap composeAffine(const AffineMap &outer, const AffineMap &inner)
+{
+	return makeAffineMap(outer.a * inner.a + outer.b * inner.c, outer.a * inner.b + outer.b * inner.d,
+		outer.c * inner.a + outer.d * inner.c, outer.c * inner.b + outer.d * inner.d,
+		outer.a * inner.e + outer.b * inner.f + outer.e, outer.c * inner.e + outer.d * inner.f + outer.f);
+}
+
+// all transforms of an expansion, one array per coefficient. level n starts at
+// levelBegin(n); child k of the parent at index p of the previous level sits at
+// levelBegin(n) + k * parents + p, so every map writes one contiguous run
+struct IFSTransforms {
+	std::vector<float> a, b, c, d, e, f;
+	std::vector<size_t> levels;	// start of every level and the end of the last one
+
+	size_t size() const { return a.size(); }
+	int depth() const { return levels.empty() ? 0 : (int)levels.size() - 1; }
+	size_t levelBegin(int level) const { return levels[level]; }
+	size_t levelEnd(int level) const { return levels[level + 1]; }
+
+	AffineMap get(size_t i) const
+	{
+		return makeAffineMap(a[i], b[i], c[i], d[i], e[i], f[i]);
+	}
+
+	void set(size_t i, const AffineMap &m)
+	{
+		a[i] = m.a; b[i] = m.b; c[i] = m.c; d[i] = m.d; e[i] = m.e; f[i] = m.f;
+	}
+
+	void resize(size_t count)
+	{
+		a.resize(count); b.resize(count); c.resize(count);
+		d.resize(count); e.resize(count); f.resize(count);
+	}
+};
+
+struct IFSStats {
+	double seconds;
+	size_t transforms;
+	int threads;
+	const char *isa;
+};
+
+// pointers to the six coefficient arrays of a run of transforms
+struct IFSSpan {
+	float *a, *b, *c, *d, *e, *f;
+};
+
+inline IFSSpan ifsSpan(IFSTransforms &t, size_t offset)
+{
+	IFSSpan s = { &t.a[offset], &t.b[offset], &t.c[offset], &t.d[offset], &t.e[offset], &t.f[offset] };
+	return s;
+}
+
+// child[i] = parent[i] composed with m, for i in [begin, end)
+inline void ifsApplyScalar(const IFSSpan &parent, const IFSSpan &child, const AffineMap &m, int begin, int end)
+{
+	for (int i = begin; i < end; i++)
+	{
+		float pa = parent.a[i], pb = parent.b[i], pc = parent.c[i], pd = parent.d[i];
+		child.a[i] = pa * m.a + pb * m.c;
+		child.b[i] = pa * m.b + pb * m.d;
+		child.c[i] = pc * m.a + pd * m.c;
+		child.d[i] = pc * m.b + pd * m.d;
+		child.e[i] = pa * m.e + pb * m.f + parent.e[i];
+		child.f[i] = pc * m.e + pd * m.f + parent.f[i];
+	}
+}
+
+#ifdef IFS_X86
+inline void ifsApplySSE2(const IFSSpan &parent, const IFSSpan &child, const AffineMap &m, int begin, int end)
+{
+	__m128 ma = _mm_set1_ps(m.a), mb = _mm_set1_ps(m.b), mc = _mm_set1_ps(m.c);
+	__m128 md = _mm_set1_ps(m.d), me = _mm_set1_ps(m.e), mf = _mm_set1_ps(m.f);
+	int i = begin;
+	for (; i + 4 <= end; i += 4)
+	{
+		__m128 pa = _mm_loadu_ps(parent.a + i), pb = _mm_loadu_ps(parent.b + i);
+		__m128 pc = _mm_loadu_ps(parent.c + i), pd = _mm_loadu_ps(parent.d + i);
+		_mm_storeu_ps(child.a + i, _mm_add_ps(_mm_mul_ps(pa, ma), _mm_mul_ps(pb, mc)));
+		_mm_storeu_ps(child.b + i, _mm_add_ps(_mm_mul_ps(pa, mb), _mm_mul_ps(pb, md)));
+		_mm_storeu_ps(child.c + i, _mm_add_ps(_mm_mul_ps(pc, ma), _mm_mul_ps(pd, mc)));
+		_mm_storeu_ps(child.d + i, _mm_add_ps(_mm_mul_ps(pc, mb), _mm_mul_ps(pd, md)));
+		_mm_storeu_ps(child.e + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(pa, me), _mm_mul_ps(pb, mf)), _mm_loadu_ps(parent.e + i)));
+		_mm_storeu_ps(child.f + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(pc, me), _mm_mul_ps(pd, mf)), _mm_loadu_ps(parent.f + i)));
+	}
+	ifsApplyScalar(parent, child, m, i, end);
+}
+
+__attribute__((target("avx2,fma")))
+inline void ifsApplyAVX2(const IFSSpan &parent, const IFSSpan &child, const AffineMap &m, int begin, int end)
+{
+	__m256 ma = _mm256_set1_ps(m.a), mb = _mm256_set1_ps(m.b), mc = _mm256_set1_ps(m.c);
+	__m256 md = _mm256_set1_ps(m.d), me = _mm256_set1_ps(m.e), mf = _mm256_set1_ps(m.f);
+	int i = begin;
+	for (; i + 8 <= end; i += 8)
+	{
+		__m256 pa = _mm256_loadu_ps(parent.a + i), pb = _mm256_loadu_ps(parent.b + i);
+		__m256 pc = _mm256_loadu_ps(parent.c + i), pd = _mm256_loadu_ps(parent.d + i);
+		_mm256_storeu_ps(child.a + i, _mm256_fmadd_ps(pa, ma, _mm256_mul_ps(pb, mc)));
+		_mm256_storeu_ps(child.b + i, _mm256_fmadd_ps(pa, mb, _mm256_mul_ps(pb, md)));
+		_mm256_storeu_ps(child.c + i, _mm256_fmadd_ps(pc, ma, _mm256_mul_ps(pd, mc)));
+		_mm256_storeu_ps(child.d + i, _mm256_fmadd_ps(pc, mb, _mm256_mul_ps(pd, md)));
+		_mm256_storeu_ps(child.e + i, _mm256_fmadd_ps(pa, me, _mm256_fmadd_ps(pb, mf, _mm256_loadu_ps(parent.e + i))));
+		_mm256_storeu_ps(child.f + i, _mm256_fmadd_ps(pc, me, _mm256_fmadd_ps(pd, mf, _mm256_loadu_ps(parent.f + i))));
+	}
+	ifsApplyScalar(parent, child, m, i, end);
+}
+#endif
+
+// number of transforms in levels 0 to depth - 1
+inline size_t ifsTransformCount(size_t maps, int depth)
+{
+	size_t count = 0, level = 1;
+	for (int i = 0; i < depth; i++, level *= maps)
+		count += level;
+	return count;
+}
+
+// largest depth up to 'depth' whose expansion stays within 'maxTransforms'
+// (the default keeps it within a few hundred MB)
+inline int ifsClampDepth(size_t maps, int depth, size_t maxTransforms = 1u << 22)
+{
+	while (depth > 1 && ifsTransformCount(maps, depth) > maxTransforms)
+		depth--;
+	return depth;
+}
+
+// maps of a few well known systems, all drawn on the unit square: "fern",
+// "dragon", "carpet", anything else gives the Sierpinski triangle.
+// 'defaultDepth' receives a depth that shows the shape well
+inline std::vector<AffineMap> ifsPreset(const char *name, int *defaultDepth = NULL)
+{
+	std::vector<AffineMap> maps;
+	int depth;
+	if (strcmp(name, "fern") == 0)
+	{
+		maps.push_back(makeAffineMap(0.0f, 0.0f, 0.0f, 0.16f, 0.0f, 0.0f));
+		maps.push_back(makeAffineMap(0.85f, 0.04f, -0.04f, 0.85f, 0.0f, 1.6f));
+		maps.push_back(makeAffineMap(0.2f, -0.26f, 0.23f, 0.22f, 0.0f, 1.6f));
+		maps.push_back(makeAffineMap(-0.15f, 0.28f, 0.26f, 0.24f, 0.0f, 0.44f));
+		depth = 10;
+	}
+	else if (strcmp(name, "dragon") == 0)
+	{
+		maps.push_back(makeSimilarity(0.70710678f, 0.78539816f, 0.0f, 0.0f));
+		maps.push_back(makeSimilarity(0.70710678f, 2.35619449f, 1.0f, 0.0f));
+		depth = 18;
+	}
+	else if (strcmp(name, "carpet") == 0)
+	{
+		for (int y = 0; y < 3; y++)
+			for (int x = 0; x < 3; x++)
+				if (x != 1 || y != 1)
+					maps.push_back(makeAffineMap(1.0f / 3.0f, 0.0f, 0.0f, 1.0f / 3.0f, x / 3.0f, y / 3.0f));
+		depth = 7;
+	}
+	else
+	{
+		maps.push_back(makeAffineMap(0.5f, 0.0f, 0.0f, 0.5f, 0.0f, 0.0f));
+		maps.push_back(makeAffineMap(0.5f, 0.0f, 0.0f, 0.5f, 0.5f, 0.0f));
+		maps.push_back(makeAffineMap(0.5f, 0.0f, 0.0f, 0.5f, 0.25f, 0.5f));
+		depth = 11;
+	}
+	if (defaultDepth)
+		*defaultDepth = depth;
+	return maps;
+}
+
+// expand 'depth' levels of the system, level 0 being 'root' alone. each level
+// is split into ranges of parents, every range producing its children for all
+// maps, so the subtrees below them are built on all cores
+inline void expandIFS(const std::vector<AffineMap> &maps, int depth, IFSTransforms &out,
+	ThreadPool &pool = ThreadPool::shared(), IFSStats *stats = NULL,
+	const AffineMap &root = makeAffineMap(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f))
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const char *isa = "scalar";
+	void (*apply)(const IFSSpan&, const IFSSpan&, const AffineMap&, int, int) = ifsApplyScalar;
+#ifdef IFS_X86
+	apply = ifsApplySSE2;
+	isa = "SSE2";
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		apply = ifsApplyAVX2;
+		isa = "AVX2";
+	}
+#endif
+	if (maps.empty() && depth > 1)
+		depth = 1;
+
+	out.levels.clear();
+	out.resize(depth > 0 ? ifsTransformCount(maps.size(), depth) : 0);
+	if (depth > 0)
+	{
+		out.levels.push_back(0);
+		out.levels.push_back(1);
+		out.set(0, root);
+	}
+	for (int level = 1; level < depth; level++)
+	{
+		size_t begin = out.levels[level - 1], parents = out.levels[level] - begin;
+		IFSSpan parent = ifsSpan(out, begin);
+		std::vector<IFSSpan> children;
+		for (size_t k = 0; k < maps.size(); k++)
+			children.push_back(ifsSpan(out, out.levels[level] + k * parents));
+		pool.parallelFor((int)parents, [&](int first, int last) {
+			for (size_t k = 0; k < maps.size(); k++)
+				apply(parent, children[k], maps[k], first, last);
+		}, 8);
+		out.levels.push_back(out.levels[level] + maps.size() * parents);
+	}
+
+	if (stats)
+	{
+		stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		stats->transforms = out.size();
+		stats->threads = pool.size();
+		stats->isa = isa;
+	}
+}
+
+// bounding box of the translations in [begin, end), which for a deep enough
+// level approximates the attractor
+inline void ifsBounds(const IFSTransforms &t, size_t begin, size_t end, float low[2], float high[2])
+{
+	low[0] = low[1] = 1e30f;
+	high[0] = high[1] = -1e30f;
+	for (size_t i = begin; i < end; i++)
+	{
+		low[0] = t.e[i] < low[0] ? t.e[i] : low[0];
+		high[0] = t.e[i] > high[0] ? t.e[i] : high[0];
+		low[1] = t.f[i] < low[1] ? t.f[i] : low[1];
+		high[1] = t.f[i] > high[1] ? t.f[i] : high[1];
+	}
+}
+
+// ---------------------------------------------------------------------------
+// view dependent refinement
+
+// a view in double precision, so zooming keeps working long after float runs out:
+// ndc.x = (x - centerX) * scale / aspect, ndc.y = (y - centerY) * scale
+struct IFSView {
+	double centerX, centerY, scale, aspect;
+	int width, height;	// viewport in pixels
+};
+
+struct IFSRefineStats {
+	size_t visited, emitted, culled;
+	bool budgetHit;
+	int maxDepth;
+	double seconds;
+};
+
+// node of the refinement, transform in NDC and its projected size in pixels
+struct IFSRefineNode {
+	double m[6];
+	double pixels;
+	int depth;
+
+	bool operator<(const IFSRefineNode &other) const { return pixels < other.pixels; }
+};
+
+// project the box [low, high] through m, returns false when it misses the viewport
+inline bool ifsProjectBox(const double m[6], const float low[2], const float high[2], const IFSView &view, double &pixels)
+{
+	double x0 = 1e300, y0 = 1e300, x1 = -1e300, y1 = -1e300;
+	for (int corner = 0; corner < 4; corner++)
+	{
+		double x = corner & 1 ? high[0] : low[0], y = corner & 2 ? high[1] : low[1];
+		double px = m[0] * x + m[1] * y + m[4], py = m[2] * x + m[3] * y + m[5];
+		x0 = px < x0 ? px : x0;
+		x1 = px > x1 ? px : x1;
+		y0 = py < y0 ? py : y0;
+		y1 = py > y1 ? py : y1;
+	}
+	double w = (x1 - x0) * 0.5 * view.width, h = (y1 - y0) * 0.5 * view.height;
+	pixels = w > h ? w : h;
+	return x1 >= -1.0 && x0 <= 1.0 && y1 >= -1.0 && y0 <= 1.0;
+}
+
+// box that holds the shape drawn for a node and everything drawn below it, in
+// node space: grown until every map sends it into itself, plus a small margin
+inline void ifsSubtreeBounds(const std::vector<AffineMap> &maps, const float shapeLow[2], const float shapeHigh[2],
+	float low[2], float high[2])
+{
+	double box[4] = { shapeLow[0], shapeLow[1], shapeHigh[0], shapeHigh[1] };
+	for (int iteration = 0; iteration < 100; iteration++)
+	{
+		double grown[4] = { shapeLow[0], shapeLow[1], shapeHigh[0], shapeHigh[1] };
+		for (size_t k = 0; k < maps.size(); k++)
+			for (int corner = 0; corner < 4; corner++)
+			{
+				double x = corner & 1 ? box[2] : box[0], y = corner & 2 ? box[3] : box[1];
+				double px = maps[k].a * x + maps[k].b * y + maps[k].e, py = maps[k].c * x + maps[k].d * y + maps[k].f;
+				grown[0] = px < grown[0] ? px : grown[0];
+				grown[1] = py < grown[1] ? py : grown[1];
+				grown[2] = px > grown[2] ? px : grown[2];
+				grown[3] = py > grown[3] ? py : grown[3];
+			}
+		bool stable = true;
+		for (int i = 0; i < 4; i++)
+		{
+			stable = stable && grown[i] == box[i];
+			box[i] = grown[i];
+		}
+		if (stable)
+			break;
+	}
+	double marginX = (box[2] - box[0]) * 0.01, marginY = (box[3] - box[1]) * 0.01;
+	low[0] = (float)(box[0] - marginX);
+	low[1] = (float)(box[1] - marginY);
+	high[0] = (float)(box[2] + marginX);
+	high[1] = (float)(box[3] + marginY);
+}
+
+// instead of a fixed depth, descend only into nodes that are on screen and
+// larger than 'pixelThreshold', largest first, until 'budget' transforms are
+// reached. [low, high] must contain every node's subtree in node space (the
+// attractor plus the drawn shape). the output is in NDC, one level, and small
+// enough in magnitude to stay exact in float however deep the zoom goes
+inline void refineIFS(const std::vector<AffineMap> &maps, const IFSView &view, const float low[2], const float high[2],
+	float pixelThreshold, size_t budget, IFSTransforms &out, IFSRefineStats *stats = NULL, int maxDepth = 128)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	IFSRefineStats s;
+	s.visited = s.emitted = s.culled = 0;
+	s.budgetHit = false;
+	s.maxDepth = 0;
+
+	std::vector<IFSRefineNode> emitted;
+	std::priority_queue<IFSRefineNode> queue;
+	IFSRefineNode root;
+	double sx = view.scale / view.aspect, sy = view.scale;
+	double rootMap[6] = { sx, 0.0, 0.0, sy, -view.centerX * sx, -view.centerY * sy };
+	memcpy(root.m, rootMap, sizeof(rootMap));
+	root.depth = 0;
+	if (ifsProjectBox(root.m, low, high, view, root.pixels))
+		queue.push(root);
+	else
+		s.culled++;
+
+	while (!queue.empty())
+	{
+		IFSRefineNode node = queue.top();
+		queue.pop();
+		s.visited++;
+		// everything still queued is emitted as is, expanding adds up to maps - 1
+		bool fits = emitted.size() + queue.size() + maps.size() <= budget;
+		if (node.pixels < pixelThreshold || node.depth >= maxDepth || maps.empty() || !fits)
+		{
+			s.budgetHit = s.budgetHit || (!fits && node.pixels >= pixelThreshold);
+			s.maxDepth = node.depth > s.maxDepth ? node.depth : s.maxDepth;
+			emitted.push_back(node);
+			continue;
+		}
+		for (size_t k = 0; k < maps.size(); k++)
+		{
+			const AffineMap &map = maps[k];
+			const double *p = node.m;
+			IFSRefineNode child;
+			child.m[0] = p[0] * map.a + p[1] * map.c;
+			child.m[1] = p[0] * map.b + p[1] * map.d;
+			child.m[2] = p[2] * map.a + p[3] * map.c;
+			child.m[3] = p[2] * map.b + p[3] * map.d;
+			child.m[4] = p[0] * map.e + p[1] * map.f + p[4];
+			child.m[5] = p[2] * map.e + p[3] * map.f + p[5];
+			child.depth = node.depth + 1;
+			if (ifsProjectBox(child.m, low, high, view, child.pixels))
+				queue.push(child);
+			else
+				s.culled++;
+		}
+	}
+
+	out.resize(emitted.size());
+	out.levels.clear();
+	out.levels.push_back(0);
+	out.levels.push_back(emitted.size());
+	for (size_t i = 0; i < emitted.size(); i++)
+	{
+		const double *m = emitted[i].m;
+		out.set(i, makeAffineMap((float)m[0], (float)m[1], (float)m[2], (float)m[3], (float)m[4], (float)m[5]));
+	}
+
+	if (stats)
+	{
+		s.emitted = emitted.size();
+		s.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		*stats = s;
+	}
+}
+
+// upload transforms [begin, end) into VBO as six float arrays and feed them to the
+// bound VAO as per instance float attributes 'location' to 'location' + 5 (a to f),
+// no conversion to matrices or interleaved data needed
+inline void uploadIFSInstances(const IFSTransforms &t, size_t begin, size_t end, unsigned int VBO, GLuint location)
+{
+	size_t count = end - begin;
+	const std::vector<float> *arrays[6] = { &t.a, &t.b, &t.c, &t.d, &t.e, &t.f };
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, 6 * count * sizeof(float), NULL, GL_STATIC_DRAW);
+	for (int k = 0; k < 6; k++)
+	{
+		if (count > 0)
+			glBufferSubData(GL_ARRAY_BUFFER, k * count * sizeof(float), count * sizeof(float), &(*arrays[k])[begin]);
+		glVertexAttribPointer(location + k, 1, GL_FLOAT, GL_FALSE, sizeof(float), (void*)(k * count * sizeof(float)));
+		glEnableVertexAttribArray(location + k);
+		glVertexAttribDivisor(location + k, 1);
+	}
+}
+
+// ---------------------------------------------------------------------------
+// chaos game
+
+// the attractor as a point cloud: walkers start anywhere, apply a randomly
+// picked map per step and after a few steps every position lies on the
+// attractor. maps are picked with probability proportional to the area they
+// cover (|det|), so the density comes out even. one walker per SIMD lane, each
+// with its own xorshift generator, and independent blocks of points per thread
+//
+//   IFSChaosTable table = ifsChaosTable(maps);
+//   ifsChaosGame(table, xy, count, frame);	// count points as x, y pairs
+
+// steps taken before the first point is written, enough for 0.85^n to drop
+// well under a pixel
+#define IFS_CHAOS_WARMUP 64
+// points per independent walker set, every block pays the warmup once
+#define IFS_CHAOS_BLOCK 16384
+
+// a, b, c, d, e, f and the lower end of the map's probability range, per map
+struct IFSChaosTable {
+	std::vector<float> coefficients;
+	int maps;
+};
+
+inline IFSChaosTable ifsChaosTable(const std::vector<AffineMap> &maps)
+{
+	IFSChaosTable table;
+	table.maps = (int)maps.size();
+	double total = 0.0;
+	std::vector<double> weights;
+	for (size_t k = 0; k < maps.size(); k++)
+	{
+		// degenerate maps such as the fern's stem still get picked now and then
+		double det = fabs((double)maps[k].a * maps[k].d - (double)maps[k].b * maps[k].c);
+		weights.push_back(det > 0.01 ? det : 0.01);
+		total += weights.back();
+	}
+	double start = 0.0;
+	for (size_t k = 0; k < maps.size(); k++)
+	{
+		const AffineMap &m = maps[k];
+		float entry[7] = { m.a, m.b, m.c, m.d, m.e, m.f, (float)(start / total) };
+		table.coefficients.insert(table.coefficients.end(), entry, entry + 7);
+		start += weights[k];
+	}
+	return table;
+}
+
+struct IFSChaosStats {
+	double seconds;
+	size_t points;
+	int threads;
+	const char *isa;
+};
+
+// murmur3 finalizer, decorrelates the generators of neighbouring lanes and
+// blocks. xorshift never leaves 0, so that one is avoided
+inline unsigned int ifsChaosSeed(unsigned int seed, unsigned int stream)
+{
+	unsigned int h = seed ^ (stream * 0x9e3779b9u);
+	h ^= h >> 16;
+	h *= 0x85ebca6bu;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35u;
+	h ^= h >> 16;
+	return h ? h : 1;
+}
+
+// count points into xy, one walker
+inline void ifsChaosScalar(const IFSChaosTable &table, unsigned int seed, float *xy, int count)
+{
+	const float *maps = table.maps > 0 ? &table.coefficients[0] : NULL;
+	unsigned int state = ifsChaosSeed(seed, 0);
+	float x = 0.0f, y = 0.0f;
+	for (int i = -IFS_CHAOS_WARMUP; i < count; i++)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		float r = (state >> 8) * (1.0f / 16777216.0f);
+		const float *m = maps;
+		for (int k = 1; k < table.maps; k++)
+			if (r >= maps[k * 7 + 6])
+				m = maps + k * 7;
+		if (m)
+		{
+			float nx = m[0] * x + m[1] * y + m[4];
+			y = m[2] * x + m[3] * y + m[5];
+			x = nx;
+		}
+		if (i >= 0)
+		{
+			xy[i * 2] = x;
+			xy[i * 2 + 1] = y;
+		}
+	}
+}
+
+#ifdef IFS_X86
+// 4 walkers, the map of each lane is picked with compare and select over all maps
+inline void ifsChaosSSE2(const IFSChaosTable &table, unsigned int seed, float *xy, int count)
+{
+	if (table.maps == 0)
+	{
+		ifsChaosScalar(table, seed, xy, count);
+		return;
+	}
+	const float *maps = &table.coefficients[0];
+	__m128i state = _mm_setr_epi32(ifsChaosSeed(seed, 0), ifsChaosSeed(seed, 1), ifsChaosSeed(seed, 2), ifsChaosSeed(seed, 3));
+	__m128 one = _mm_set1_ps(1.0f);
+	__m128i exponent = _mm_set1_epi32(0x3f800000);
+	__m128 x = _mm_setzero_ps(), y = _mm_setzero_ps();
+	for (int i = -IFS_CHAOS_WARMUP * 4; i < count; i += 4)
+	{
+		state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+		state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+		state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+		// 23 random bits as mantissa of a float in [1, 2)
+		__m128 r = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(state, 9), exponent)), one);
+
+		__m128 ma = _mm_set1_ps(maps[0]), mb = _mm_set1_ps(maps[1]), mc = _mm_set1_ps(maps[2]);
+		__m128 md = _mm_set1_ps(maps[3]), me = _mm_set1_ps(maps[4]), mf = _mm_set1_ps(maps[5]);
+		for (int k = 1; k < table.maps; k++)
+		{
+			const float *m = maps + k * 7;
+			__m128 pick = _mm_cmpge_ps(r, _mm_set1_ps(m[6]));
+			ma = _mm_or_ps(_mm_and_ps(pick, _mm_set1_ps(m[0])), _mm_andnot_ps(pick, ma));
+			mb = _mm_or_ps(_mm_and_ps(pick, _mm_set1_ps(m[1])), _mm_andnot_ps(pick, mb));
+			mc = _mm_or_ps(_mm_and_ps(pick, _mm_set1_ps(m[2])), _mm_andnot_ps(pick, mc));
+			md = _mm_or_ps(_mm_and_ps(pick, _mm_set1_ps(m[3])), _mm_andnot_ps(pick, md));
+			me = _mm_or_ps(_mm_and_ps(pick, _mm_set1_ps(m[4])), _mm_andnot_ps(pick, me));
+			mf = _mm_or_ps(_mm_and_ps(pick, _mm_set1_ps(m[5])), _mm_andnot_ps(pick, mf));
+		}
+		__m128 nx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ma, x), _mm_mul_ps(mb, y)), me);
+		y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(mc, x), _mm_mul_ps(md, y)), mf);
+		x = nx;
+
+		if (i < 0)
+			continue;
+		// lanes interleaved to x, y pairs, a partial last group goes through a copy
+		__m128 low = _mm_unpacklo_ps(x, y), high = _mm_unpackhi_ps(x, y);
+		if (i + 4 <= count)
+		{
+			_mm_storeu_ps(xy + i * 2, low);
+			_mm_storeu_ps(xy + i * 2 + 4, high);
+		}
+		else
+		{
+			float last[8];
+			_mm_storeu_ps(last, low);
+			_mm_storeu_ps(last + 4, high);
+			memcpy(xy + i * 2, last, (count - i) * 2 * sizeof(float));
+		}
+	}
+}
+
+// 8 walkers
+__attribute__((target("avx2,fma")))
+inline void ifsChaosAVX2(const IFSChaosTable &table, unsigned int seed, float *xy, int count)
+{
+	if (table.maps == 0)
+	{
+		ifsChaosScalar(table, seed, xy, count);
+		return;
+	}
+	const float *maps = &table.coefficients[0];
+	__m256i state = _mm256_setr_epi32(ifsChaosSeed(seed, 0), ifsChaosSeed(seed, 1), ifsChaosSeed(seed, 2), ifsChaosSeed(seed, 3),
+		ifsChaosSeed(seed, 4), ifsChaosSeed(seed, 5), ifsChaosSeed(seed, 6), ifsChaosSeed(seed, 7));
+	__m256 one = _mm256_set1_ps(1.0f);
+	__m256i exponent = _mm256_set1_epi32(0x3f800000);
+	__m256 x = _mm256_setzero_ps(), y = _mm256_setzero_ps();
+	for (int i = -IFS_CHAOS_WARMUP * 8; i < count; i += 8)
+	{
+		state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 13));
+		state = _mm256_xor_si256(state, _mm256_srli_epi32(state, 17));
+		state = _mm256_xor_si256(state, _mm256_slli_epi32(state, 5));
+		__m256 r = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(state, 9), exponent)), one);
+
+		__m256 ma = _mm256_broadcast_ss(maps), mb = _mm256_broadcast_ss(maps + 1), mc = _mm256_broadcast_ss(maps + 2);
+		__m256 md = _mm256_broadcast_ss(maps + 3), me = _mm256_broadcast_ss(maps + 4), mf = _mm256_broadcast_ss(maps + 5);
+		for (int k = 1; k < table.maps; k++)
+		{
+			const float *m = maps + k * 7;
+			__m256 pick = _mm256_cmp_ps(r, _mm256_broadcast_ss(m + 6), _CMP_GE_OQ);
+			ma = _mm256_blendv_ps(ma, _mm256_broadcast_ss(m), pick);
+			mb = _mm256_blendv_ps(mb, _mm256_broadcast_ss(m + 1), pick);
+			mc = _mm256_blendv_ps(mc, _mm256_broadcast_ss(m + 2), pick);
+			md = _mm256_blendv_ps(md, _mm256_broadcast_ss(m + 3), pick);
+			me = _mm256_blendv_ps(me, _mm256_broadcast_ss(m + 4), pick);
+			mf = _mm256_blendv_ps(mf, _mm256_broadcast_ss(m + 5), pick);
+		}
+		__m256 nx = _mm256_fmadd_ps(ma, x, _mm256_fmadd_ps(mb, y, me));
+		y = _mm256_fmadd_ps(mc, x, _mm256_fmadd_ps(md, y, mf));
+		x = nx;
+
+		if (i < 0)
+			continue;
+		// unpack works per 128 bit half, the point order doesn't matter for a cloud
+		__m256 low = _mm256_unpacklo_ps(x, y), high = _mm256_unpackhi_ps(x, y);
+		if (i + 8 <= count)
+		{
+			_mm256_storeu_ps(xy + i * 2, low);
+			_mm256_storeu_ps(xy + i * 2 + 8, high);
+		}
+		else
+		{
+			float last[16];
+			_mm256_storeu_ps(last, low);
+			_mm256_storeu_ps(last + 8, high);
+			memcpy(xy + i * 2, last, (count - i) * 2 * sizeof(float));
+		}
+	}
+}
+#endif
+
+// count points into xy (x, y pairs) on all threads of the pool. 'seed' picks
+// the sequence, a new one per frame gives new points
+inline void ifsChaosGame(const IFSChaosTable &table, float *xy, size_t count, unsigned int seed,
+	ThreadPool &pool = ThreadPool::shared(), IFSChaosStats *stats = NULL)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	const char *isa = "scalar";
+	void (*kernel)(const IFSChaosTable&, unsigned int, float*, int) = ifsChaosScalar;
+#ifdef IFS_X86
+	kernel = ifsChaosSSE2;
+	isa = "SSE2";
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		kernel = ifsChaosAVX2;
+		isa = "AVX2";
+	}
+#endif
+
+	int blocks = (int)((count + IFS_CHAOS_BLOCK - 1) / IFS_CHAOS_BLOCK);
+	pool.parallelFor(blocks, [&](int first, int last) {
+		for (int block = first; block < last; block++)
+		{
+			size_t begin = (size_t)block * IFS_CHAOS_BLOCK;
+			int points = (int)(count - begin < (size_t)IFS_CHAOS_BLOCK ? count - begin : (size_t)IFS_CHAOS_BLOCK);
+			kernel(table, ifsChaosSeed(seed, block), xy + begin * 2, points);
+		}
+	});
+
+	if (stats)
+	{
+		stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		stats->points = count;
+		stats->threads = pool.size();
+		stats->isa = isa;
+	}
+}
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef IFS_COMPUTE_H
+#define IFS_COMPUTE_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <iostream>
+
+#include "ifs.h"
+
+// expandIFS on the GPU (GL 4.3): a compute shader writes every level into a
+// shader storage buffer laid out exactly like IFSTransforms (six coefficient
+// arrays of 'capacity' floats, child k of parent p at levelBegin + k * parents + p)
+// and the last level also fills a DrawElementsIndirect command, so
+//
+//   ifs.expand(maps, depth);
+//   ifs.bindForDraw(1);		// SSBO binding 1 + GL_DRAW_INDIRECT_BUFFER
+//   glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0);
+//
+// draws the deepest level without the transforms ever reaching the CPU. the
+// vertex shader reads them with gl_InstanceID + levelBegin(depth - 1)
+class IFSCompute {
+public:
+	// 'indexCount' is the element count of the shape drawn for every transform
+	IFSCompute(GLuint indexCount = 6)
+		: program(0), transforms(0), mapBuffer(0), command(0), capacity(0), elementCount(indexCount)
+	{
+		if (!GLAD_GL_VERSION_4_3)
+		{
+			std::cout << "ERROR::IFS_COMPUTE::GL_4_3_NOT_AVAILABLE" << std::endl;
+			return;
+		}
+		program = compile();
+		glGenBuffers(1, &transforms);
+		glGenBuffers(1, &mapBuffer);
+		glGenBuffers(1, &command);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command);
+		GLuint empty[5] = { elementCount, 0, 0, 0, 0 };
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(empty), empty, GL_DYNAMIC_DRAW);
+	}
+
+	~IFSCompute()
+	{
+		glDeleteProgram(program);
+		glDeleteBuffers(1, &transforms);
+		glDeleteBuffers(1, &mapBuffer);
+		glDeleteBuffers(1, &command);
+	}
+
+	bool valid() const { return program != 0; }
+
+	// expand 'depth' levels, level 0 being 'root'. only the root and the maps are
+	// uploaded, every level after that is one dispatch reading the previous one
+	void expand(const std::vector<AffineMap> &maps, int depth,
+		const AffineMap &root = makeAffineMap(1.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f))
+	{
+		if (!program || depth <= 0)
+			return;
+		if (maps.empty())
+			depth = 1;
+		size_t count = ifsTransformCount(maps.size(), depth);
+		levels.clear();
+		levels.push_back(0);
+		levels.push_back(1);
+
+		// the buffer only grows, its contents are rebuilt anyway
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, transforms);
+		if (count > capacity)
+		{
+			capacity = count;
+			glBufferData(GL_SHADER_STORAGE_BUFFER, 6 * capacity * sizeof(float), NULL, GL_DYNAMIC_COPY);
+		}
+		float rootCoefficients[6] = { root.a, root.b, root.c, root.d, root.e, root.f };
+		for (int i = 0; i < 6; i++)
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, i * capacity * sizeof(float), sizeof(float), &rootCoefficients[i]);
+		if (!maps.empty())
+		{
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, mapBuffer);
+			glBufferData(GL_SHADER_STORAGE_BUFFER, maps.size() * sizeof(AffineMap), &maps[0], GL_DYNAMIC_DRAW);
+		}
+
+		// a depth of 1 draws the root alone
+		GLuint draw[5] = { elementCount, 1, 0, 0, 0 };
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command);
+		glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, sizeof(draw), draw);
+
+		glUseProgram(program);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, mapBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, transforms);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, command);
+		glUniform1i(glGetUniformLocation(program, "mapCount"), (int)maps.size());
+		glUniform1i(glGetUniformLocation(program, "capacity"), (int)capacity);
+		int parentBeginLoc = glGetUniformLocation(program, "parentBegin");
+		int parentsLoc = glGetUniformLocation(program, "parents");
+		int writeCommandLoc = glGetUniformLocation(program, "writeCommand");
+		for (int level = 1; level < depth; level++)
+		{
+			size_t begin = levels[level - 1], parents = levels[level] - begin;
+			size_t children = parents * maps.size();
+			glUniform1i(parentBeginLoc, (int)begin);
+			glUniform1i(parentsLoc, (int)parents);
+			glUniform1i(writeCommandLoc, level == depth - 1);
+			glDispatchCompute((GLuint)((children + GROUP_SIZE - 1) / GROUP_SIZE), 1, 1);
+			// the next level reads what this one wrote
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+			levels.push_back(levels[level] + children);
+		}
+		// make the transforms and the command visible to the draw
+		glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT);
+	}
+
+	size_t levelBegin(int level) const { return levels[level]; }
+	size_t levelEnd(int level) const { return levels[level + 1]; }
+	size_t size() const { return levels.empty() ? 0 : levels.back(); }
+	// stride between the coefficient arrays, in floats
+	size_t arrayStride() const { return capacity; }
+
+	void bindForDraw(GLuint binding) const
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, binding, transforms);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command);
+	}
+
+	unsigned int transformBuffer() const { return transforms; }
+	unsigned int commandBuffer() const { return command; }
+
+private:
+	enum { GROUP_SIZE = 256 };
+
+	unsigned int program, transforms, mapBuffer, command;
+	size_t capacity;
+	GLuint elementCount;
+	std::vector<size_t> levels;
+
+	static unsigned int compile()
+	{
+		const char *source =
+			"#version 430 core\n"
+			"layout(local_size_x = 256) in;\n"
+			"layout(std430, binding = 0) readonly buffer Maps { float maps[]; };\n"
+			"layout(std430, binding = 1) buffer Transforms { float coefficients[]; };\n"
+			"layout(std430, binding = 2) writeonly buffer Command { uint count; uint instanceCount; uint firstIndex; int baseVertex; uint baseInstance; };\n"
+			"uniform int mapCount;\n"
+			"uniform int capacity;\n"
+			"uniform int parentBegin;\n"
+			"uniform int parents;\n"
+			"uniform bool writeCommand;\n"
+			"void main()\n"
+			"{\n"
+			"	int id = int(gl_GlobalInvocationID.x);\n"
+			"	if (id >= parents * mapCount)\n"
+			"		return;\n"
+			"	int k = id / parents, p = parentBegin + id - k * parents;\n"
+			"	int child = parentBegin + parents + id;\n"
+			"	float pa = coefficients[p], pb = coefficients[capacity + p];\n"
+			"	float pc = coefficients[2 * capacity + p], pd = coefficients[3 * capacity + p];\n"
+			"	float ma = maps[k * 6], mb = maps[k * 6 + 1], mc = maps[k * 6 + 2];\n"
+			"	float md = maps[k * 6 + 3], me = maps[k * 6 + 4], mf = maps[k * 6 + 5];\n"
+			"	coefficients[child] = pa * ma + pb * mc;\n"
+			"	coefficients[capacity + child] = pa * mb + pb * md;\n"
+			"	coefficients[2 * capacity + child] = pc * ma + pd * mc;\n"
+			"	coefficients[3 * capacity + child] = pc * mb + pd * md;\n"
+			"	coefficients[4 * capacity + child] = pa * me + pb * mf + coefficients[4 * capacity + p];\n"
+			"	coefficients[5 * capacity + child] = pc * me + pd * mf + coefficients[5 * capacity + p];\n"
+			"	if (writeCommand && id == 0)\n"
+			"		instanceCount = uint(parents * mapCount);\n"
+			"}\n";
+		unsigned int shader = glCreateShader(GL_COMPUTE_SHADER);
+		glShaderSource(shader, 1, &source, NULL);
+		glCompileShader(shader);
+		int success;
+		char infoLog[1024];
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+		if (!success)
+		{
+			glGetShaderInfoLog(shader, 1024, NULL, infoLog);
+			std::cout << "ERROR::SHADER::COMPUTE::COMPILATION_FAILED" << std::endl << infoLog << std::endl;
+		}
+		unsigned int id = glCreateProgram();
+		glAttachShader(id, shader);
+		glLinkProgram(id);
+		glDeleteShader(shader);
+		glGetProgramiv(id, GL_LINK_STATUS, &success);
+		if (!success)
+		{
+			glGetProgramInfoLog(id, 1024, NULL, infoLog);
+			std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED" << std::endl << infoLog << std::endl;
+			glDeleteProgram(id);
+			return 0;
+		}
+		return id;
+	}
+
+	IFSCompute(const IFSCompute &);
+	IFSCompute &operator=(const IFSCompute &);
+};
+
+#endif
@@ -0,0 +1,307 @@
+#ifndef IMAGE_RESAMPLE_H
+#define IMAGE_RESAMPLE_H
+
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define IMAGE_RESAMPLE_X86 1
+#endif
+
+#include "thread_pool.h"
+
+// load time image resampling: separable Lanczos3 / Mitchell filtering of 8-bit
+// images, the horizontal pass runs on input rows and the vertical pass on
+// output rows, both split across a thread pool. the vertical pass (the bulk of
+// the arithmetic) has an AVX2+FMA kernel chosen at runtime
+
+enum ResampleFilter {
+	RESAMPLE_LANCZOS3,
+	RESAMPLE_MITCHELL
+};
+
+// resolution cap for textures. the global budget starts from the environment
+// (LOGL_MAX_TEXTURE_SIZE, LOGL_TEXTURE_POT=1) so low memory deployments can
+// shrink the same assets without reprocessing them; a texture may pass its own
+struct ResampleBudget {
+	int maxSize;		// longest side in texels, 0 = unlimited
+	bool powerOfTwo;	// round both sides down to powers of two
+	ResampleFilter filter;
+
+	ResampleBudget(int cap = 0, bool pot = false, ResampleFilter f = RESAMPLE_LANCZOS3)
+		: maxSize(cap), powerOfTwo(pot), filter(f)
+	{
+	}
+
+	static ResampleBudget &global()
+	{
+		static ResampleBudget budget(getenv("LOGL_MAX_TEXTURE_SIZE") ? atoi(getenv("LOGL_MAX_TEXTURE_SIZE")) : 0,
+			getenv("LOGL_TEXTURE_POT") && atoi(getenv("LOGL_TEXTURE_POT")) != 0);
+		return budget;
+	}
+
+	// target size for a width x height image, never larger than the source
+	void fit(int width, int height, int &outWidth, int &outHeight) const
+	{
+		outWidth = width;
+		outHeight = height;
+		int longest = width > height ? width : height;
+		if (maxSize > 0 && longest > maxSize)
+		{
+			outWidth = (int)((long long)width * maxSize / longest);
+			outHeight = (int)((long long)height * maxSize / longest);
+		}
+		if (powerOfTwo)
+		{
+			outWidth = floorPowerOfTwo(outWidth);
+			outHeight = floorPowerOfTwo(outHeight);
+		}
+		outWidth = outWidth < 1 ? 1 : outWidth;
+		outHeight = outHeight < 1 ? 1 : outHeight;
+	}
+
+	static int floorPowerOfTwo(int v)
+	{
+		int p = 1;
+		while (p * 2 <= v)
+			p *= 2;
+		return p;
+	}
+};
+
+struct ResampleStats {
+	double seconds;
+	int threads;
+	const char *isa;
+};
+
+inline float resampleKernel(ResampleFilter filter, float x)
+{
+	x = fabsf(x);
+	if (filter == RESAMPLE_LANCZOS3)
+	{
+		if (x < 1e-6f)
+			return 1.0f;
+		if (x >= 3.0f)
+			return 0.0f;
+		const float pi = 3.14159265358979f;
+		return 3.0f * sinf(pi * x) * sinf(pi * x / 3.0f) / (pi * pi * x * x);
+	}
+	// Mitchell-Netravali, B = C = 1/3
+	const float B = 1.0f / 3.0f, C = 1.0f / 3.0f;
+	if (x < 1.0f)
+		return ((12 - 9 * B - 6 * C) * x * x * x + (-18 + 12 * B + 6 * C) * x * x + (6 - 2 * B)) / 6.0f;
+	if (x < 2.0f)
+		return ((-B - 6 * C) * x * x * x + (6 * B + 30 * C) * x * x + (-12 * B - 48 * C) * x + (8 * B + 24 * C)) / 6.0f;
+	return 0.0f;
+}
+
+// normalized filter taps of every output sample along one axis
+struct ResampleTaps {
+	std::vector<int> first;		// first source index per output sample
+	std::vector<int> count;
+	std::vector<float> weights;	// 'width' weights per output sample
+	int width;
+
+	ResampleTaps(ResampleFilter filter, int inSize, int outSize)
+	{
+		float scale = (float)outSize / inSize;
+		float support = (filter == RESAMPLE_LANCZOS3 ? 3.0f : 2.0f) / (scale < 1.0f ? scale : 1.0f);
+		float step = scale < 1.0f ? scale : 1.0f;
+		width = (int)ceilf(support) * 2 + 1;
+		first.resize(outSize);
+		count.resize(outSize);
+		weights.assign((size_t)outSize * width, 0.0f);
+		for (int o = 0; o < outSize; o++)
+		{
+			float center = (o + 0.5f) / scale - 0.5f;
+			int begin = (int)floorf(center - support) + 1, end = (int)floorf(center + support);
+			begin = begin < 0 ? 0 : begin;
+			end = end > inSize - 1 ? inSize - 1 : end;
+			if (end - begin + 1 > width)
+				end = begin + width - 1;
+			float sum = 0.0f;
+			for (int i = begin; i <= end; i++)
+			{
+				float w = resampleKernel(filter, (i - center) * step);
+				weights[(size_t)o * width + (i - begin)] = w;
+				sum += w;
+			}
+			// edge samples lose taps, renormalize so brightness is kept
+			for (int i = begin; i <= end; i++)
+				weights[(size_t)o * width + (i - begin)] /= (sum != 0.0f ? sum : 1.0f);
+			first[o] = begin;
+			count[o] = end - begin + 1;
+		}
+	}
+};
+
+// horizontal pass of one row: 8-bit input to float, 'channels' interleaved
+inline void resampleRowH(const unsigned char *in, float *out, int channels, const ResampleTaps &taps, int outWidth)
+{
+	for (int o = 0; o < outWidth; o++)
+	{
+		const float *w = &taps.weights[(size_t)o * taps.width];
+		const unsigned char *src = in + (size_t)taps.first[o] * channels;
+		float *dst = out + (size_t)o * channels;
+#ifdef IMAGE_RESAMPLE_X86
+		if (channels == 4)
+		{
+			// one RGBA texel per SSE register
+			__m128 acc = _mm_setzero_ps();
+			for (int k = 0; k < taps.count[o]; k++)
+			{
+				int texel;
+				memcpy(&texel, src + k * 4, 4);
+				__m128i v = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(texel), _mm_setzero_si128()),
+					_mm_setzero_si128());
+				acc = _mm_add_ps(acc, _mm_mul_ps(_mm_cvtepi32_ps(v), _mm_set1_ps(w[k])));
+			}
+			_mm_storeu_ps(dst, acc);
+			continue;
+		}
+#endif
+		for (int c = 0; c < channels; c++)
+		{
+			float acc = 0.0f;
+			for (int k = 0; k < taps.count[o]; k++)
+				acc += w[k] * src[k * channels + c];
+			dst[c] = acc;
+		}
+	}
+}
+
+inline unsigned char resampleToByte(float v)
+{
+	v += 0.5f;
+	return (unsigned char)(v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v));
+}
+
+// vertical pass of one output row: weighted sum of 'count' float rows of n values
+inline void resampleRowVScalar(const float *const *rows, const float *w, int count, int n, unsigned char *out)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float acc = 0.0f;
+		for (int k = 0; k < count; k++)
+			acc += w[k] * rows[k][i];
+		out[i] = resampleToByte(acc);
+	}
+}
+
+#ifdef IMAGE_RESAMPLE_X86
+inline void resampleRowVSSE2(const float *const *rows, const float *w, int count, int n, unsigned char *out)
+{
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128 acc = _mm_setzero_ps();
+		for (int k = 0; k < count; k++)
+			acc = _mm_add_ps(acc, _mm_mul_ps(_mm_loadu_ps(rows[k] + i), _mm_set1_ps(w[k])));
+		__m128i v = _mm_cvtps_epi32(acc);
+		v = _mm_packs_epi32(v, v);
+		v = _mm_packus_epi16(v, v);
+		int packed = _mm_cvtsi128_si32(v);
+		memcpy(out + i, &packed, 4);
+	}
+	for (; i < n; i++)
+	{
+		float acc = 0.0f;
+		for (int k = 0; k < count; k++)
+			acc += w[k] * rows[k][i];
+		out[i] = resampleToByte(acc);
+	}
+}
+
+__attribute__((target("avx2,fma")))
+inline void resampleRowVAVX2(const float *const *rows, const float *w, int count, int n, unsigned char *out)
+{
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256 acc = _mm256_setzero_ps();
+		for (int k = 0; k < count; k++)
+			acc = _mm256_fmadd_ps(_mm256_loadu_ps(rows[k] + i), _mm256_set1_ps(w[k]), acc);
+		__m256i v = _mm256_cvtps_epi32(acc);
+		__m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+		packed = _mm_packus_epi16(packed, packed);
+		_mm_storel_epi64((__m128i*)(out + i), packed);
+	}
+	for (; i < n; i++)
+	{
+		float acc = 0.0f;
+		for (int k = 0; k < count; k++)
+			acc += w[k] * rows[k][i];
+		out[i] = resampleToByte(acc);
+	}
+}
+#endif
+
+// resample a width x height image with 'channels' interleaved 8-bit channels
+inline std::vector<unsigned char> resampleImage(const unsigned char *data, int width, int height, int channels,
+	int outWidth, int outHeight, ResampleFilter filter = RESAMPLE_LANCZOS3,
+	ThreadPool &pool = ThreadPool::shared(), ResampleStats *stats = NULL)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	ResampleTaps horizontal(filter, width, outWidth), vertical(filter, height, outHeight);
+
+	// horizontal pass over every input row
+	std::vector<float> tmp((size_t)height * outWidth * channels);
+	pool.parallelFor(height, [&](int begin, int end) {
+		for (int y = begin; y < end; y++)
+			resampleRowH(data + (size_t)y * width * channels, &tmp[(size_t)y * outWidth * channels], channels,
+				horizontal, outWidth);
+	});
+
+	// vertical pass per output row
+	const char *isa = "scalar";
+	void (*rowV)(const float *const*, const float*, int, int, unsigned char*) = resampleRowVScalar;
+#ifdef IMAGE_RESAMPLE_X86
+	rowV = resampleRowVSSE2;
+	isa = "SSE2";
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+	{
+		rowV = resampleRowVAVX2;
+		isa = "AVX2";
+	}
+#endif
+	std::vector<unsigned char> out((size_t)outWidth * outHeight * channels);
+	int n = outWidth * channels;
+	pool.parallelFor(outHeight, [&](int begin, int end) {
+		std::vector<const float*> rows(vertical.width);
+		for (int y = begin; y < end; y++)
+		{
+			for (int k = 0; k < vertical.count[y]; k++)
+				rows[k] = &tmp[(size_t)(vertical.first[y] + k) * n];
+			rowV(&rows[0], &vertical.weights[(size_t)y * vertical.width], vertical.count[y], n,
+				&out[(size_t)y * n]);
+		}
+	});
+
+	if (stats)
+	{
+		stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		stats->threads = pool.size();
+		stats->isa = isa;
+	}
+	return out;
+}
+
+// apply a budget to a decoded image: returns true and fills 'out' when the image
+// had to shrink, false when it already fits and can be uploaded as is
+inline bool resampleToBudget(const unsigned char *data, int width, int height, int channels,
+	std::vector<unsigned char> &out, int &outWidth, int &outHeight,
+	const ResampleBudget &budget = ResampleBudget::global(), ResampleStats *stats = NULL)
+{
+	budget.fit(width, height, outWidth, outHeight);
+	if (outWidth == width && outHeight == height)
+		return false;
+	out = resampleImage(data, width, height, channels, outWidth, outHeight, budget.filter, ThreadPool::shared(), stats);
+	return true;
+}
+
+#endif
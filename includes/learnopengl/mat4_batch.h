@@ -0,0 +1,462 @@
+#ifndef MAT4_BATCH_H
+#define MAT4_BATCH_H
+
+#include <cstddef>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define MAT4_X86 1
+#endif
+
+// 4x4 matrix kernels over whole arrays instead of one glm operator* at a time.
+// matrices are 16 floats in glm's layout (column major), so an array of
+// glm::mat4 passes as glm::value_ptr(m[0]) and the results read back as glm::mat4:
+//
+//   mat4ComposeTRS(trs, glm::value_ptr(model[0]), count);
+//   mat4MultiplyOne(glm::value_ptr(view), glm::value_ptr(model[0]), glm::value_ptr(modelView[0]), count);
+//
+// every kernel has a scalar, SSE2, AVX2 and AVX-512 version; the calls above
+// use the best the CPU supports, picked once. the scalar and SSE2 versions do
+// exactly glm's multiplications and additions in glm's order. AVX2 and AVX-512
+// fuse them, which moves results by about an ulp
+enum Mat4ISA { MAT4_SCALAR, MAT4_SSE2, MAT4_AVX2, MAT4_AVX512, MAT4_ISA_COUNT };
+
+// translation, rotation and scale of 'count' objects as structure of arrays.
+// rotations are unit quaternions like glm::quat
+struct Mat4TRS {
+	const float *tx, *ty, *tz;
+	const float *qx, *qy, *qz, *qw;
+	const float *sx, *sy, *sz;
+};
+
+// out[i] = a[i] * b[i]. out may be a or b
+inline void mat4MultiplyScalar(const float *a, const float *b, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++, a += 16, b += 16, out += 16)
+	{
+		float r[16];
+		for (int j = 0; j < 4; j++)
+			for (int k = 0; k < 4; k++)
+				r[j * 4 + k] = a[k] * b[j * 4] + a[4 + k] * b[j * 4 + 1] + a[8 + k] * b[j * 4 + 2] + a[12 + k] * b[j * 4 + 3];
+		for (int k = 0; k < 16; k++)
+			out[k] = r[k];
+	}
+}
+
+// out[i] = m * b[i], e.g. a parent or view matrix applied to many
+inline void mat4MultiplyOneScalar(const float *m, const float *b, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++, b += 16, out += 16)
+		mat4MultiplyScalar(m, b, out, 1);
+}
+
+// out[i] = m * vec4(points[i], 1): xyz in, xyzw out
+inline void mat4TransformPointsScalar(const float *m, const float *points, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++, points += 3, out += 4)
+	{
+		float x = points[0], y = points[1], z = points[2];
+		for (int k = 0; k < 4; k++)
+			out[k] = (m[k] * x + m[4 + k] * y) + (m[8 + k] * z + m[12 + k]);
+	}
+}
+
+// out[i] = translate(t) * mat4_cast(q) * scale(s)
+inline void mat4ComposeTRSScalar(const Mat4TRS &trs, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++, out += 16)
+	{
+		float x = trs.qx[i], y = trs.qy[i], z = trs.qz[i], w = trs.qw[i];
+		float xx = x * x, yy = y * y, zz = z * z, xz = x * z, xy = x * y, yz = y * z;
+		float wx = w * x, wy = w * y, wz = w * z;
+		float sx = trs.sx[i], sy = trs.sy[i], sz = trs.sz[i];
+		out[0] = (1.0f - 2.0f * (yy + zz)) * sx;
+		out[1] = 2.0f * (xy + wz) * sx;
+		out[2] = 2.0f * (xz - wy) * sx;
+		out[3] = 0.0f;
+		out[4] = 2.0f * (xy - wz) * sy;
+		out[5] = (1.0f - 2.0f * (xx + zz)) * sy;
+		out[6] = 2.0f * (yz + wx) * sy;
+		out[7] = 0.0f;
+		out[8] = 2.0f * (xz + wy) * sz;
+		out[9] = 2.0f * (yz - wx) * sz;
+		out[10] = (1.0f - 2.0f * (xx + yy)) * sz;
+		out[11] = 0.0f;
+		out[12] = trs.tx[i];
+		out[13] = trs.ty[i];
+		out[14] = trs.tz[i];
+		out[15] = 1.0f;
+	}
+}
+
+#ifdef MAT4_X86
+// one matrix per iteration, a column per register
+inline void mat4ProductSSE2(__m128 a0, __m128 a1, __m128 a2, __m128 a3, const float *b, float *out)
+{
+	__m128 r[4];
+	for (int j = 0; j < 4; j++)
+	{
+		const float *c = b + j * 4;
+		r[j] = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(a0, _mm_set1_ps(c[0])), _mm_mul_ps(a1, _mm_set1_ps(c[1]))),
+			_mm_mul_ps(a2, _mm_set1_ps(c[2]))), _mm_mul_ps(a3, _mm_set1_ps(c[3])));
+	}
+	for (int j = 0; j < 4; j++)
+		_mm_storeu_ps(out + j * 4, r[j]);
+}
+
+inline void mat4MultiplySSE2(const float *a, const float *b, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++, a += 16, b += 16, out += 16)
+		mat4ProductSSE2(_mm_loadu_ps(a), _mm_loadu_ps(a + 4), _mm_loadu_ps(a + 8), _mm_loadu_ps(a + 12), b, out);
+}
+
+inline void mat4MultiplyOneSSE2(const float *m, const float *b, float *out, size_t count)
+{
+	__m128 a0 = _mm_loadu_ps(m), a1 = _mm_loadu_ps(m + 4), a2 = _mm_loadu_ps(m + 8), a3 = _mm_loadu_ps(m + 12);
+	for (size_t i = 0; i < count; i++, b += 16, out += 16)
+		mat4ProductSSE2(a0, a1, a2, a3, b, out);
+}
+
+inline void mat4TransformPointsSSE2(const float *m, const float *points, float *out, size_t count)
+{
+	__m128 c0 = _mm_loadu_ps(m), c1 = _mm_loadu_ps(m + 4), c2 = _mm_loadu_ps(m + 8), c3 = _mm_loadu_ps(m + 12);
+	for (size_t i = 0; i < count; i++, points += 3, out += 4)
+	{
+		__m128 xy = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(points[0])), _mm_mul_ps(c1, _mm_set1_ps(points[1])));
+		_mm_storeu_ps(out, _mm_add_ps(xy, _mm_add_ps(_mm_mul_ps(c2, _mm_set1_ps(points[2])), c3)));
+	}
+}
+
+// r0..r3 hold one column element each for four matrices, written out as that
+// column of the four
+inline void mat4StoreColumnSSE2(__m128 r0, __m128 r1, __m128 r2, __m128 r3, float *out, int column)
+{
+	_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	_mm_storeu_ps(out + column * 4, r0);
+	_mm_storeu_ps(out + 16 + column * 4, r1);
+	_mm_storeu_ps(out + 32 + column * 4, r2);
+	_mm_storeu_ps(out + 48 + column * 4, r3);
+}
+
+// four matrices per iteration, one per lane
+inline void mat4ComposeTRSSSE2(const Mat4TRS &trs, float *out, size_t count)
+{
+	__m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4, out += 64)
+	{
+		__m128 x = _mm_loadu_ps(trs.qx + i), y = _mm_loadu_ps(trs.qy + i);
+		__m128 z = _mm_loadu_ps(trs.qz + i), w = _mm_loadu_ps(trs.qw + i);
+		__m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+		__m128 xz = _mm_mul_ps(x, z), xy = _mm_mul_ps(x, y), yz = _mm_mul_ps(y, z);
+		__m128 wx = _mm_mul_ps(w, x), wy = _mm_mul_ps(w, y), wz = _mm_mul_ps(w, z);
+		__m128 sx = _mm_loadu_ps(trs.sx + i), sy = _mm_loadu_ps(trs.sy + i), sz = _mm_loadu_ps(trs.sz + i);
+
+		mat4StoreColumnSSE2(_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), sx), _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), sx),
+			zero, out, 0);
+		mat4StoreColumnSSE2(_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), sy),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), sy), zero, out, 1);
+		mat4StoreColumnSSE2(_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), sz),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), sz),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz), zero, out, 2);
+		mat4StoreColumnSSE2(_mm_loadu_ps(trs.tx + i), _mm_loadu_ps(trs.ty + i), _mm_loadu_ps(trs.tz + i), one, out, 3);
+	}
+	Mat4TRS rest = { trs.tx + i, trs.ty + i, trs.tz + i, trs.qx + i, trs.qy + i, trs.qz + i, trs.qw + i,
+		trs.sx + i, trs.sy + i, trs.sz + i };
+	mat4ComposeTRSScalar(rest, out, count - i);
+}
+
+// two columns per register, column k of 'a' in both halves
+__attribute__((target("avx2,fma")))
+inline void mat4ProductAVX2(__m256 a0, __m256 a1, __m256 a2, __m256 a3, const float *b, float *out)
+{
+	__m256 b01 = _mm256_loadu_ps(b), b23 = _mm256_loadu_ps(b + 8);
+	__m256 r01 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b01, b01, 0x00));
+	r01 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b01, b01, 0x55), r01);
+	r01 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b01, b01, 0xAA), r01);
+	r01 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b01, b01, 0xFF), r01);
+	__m256 r23 = _mm256_mul_ps(a0, _mm256_shuffle_ps(b23, b23, 0x00));
+	r23 = _mm256_fmadd_ps(a1, _mm256_shuffle_ps(b23, b23, 0x55), r23);
+	r23 = _mm256_fmadd_ps(a2, _mm256_shuffle_ps(b23, b23, 0xAA), r23);
+	r23 = _mm256_fmadd_ps(a3, _mm256_shuffle_ps(b23, b23, 0xFF), r23);
+	_mm256_storeu_ps(out, r01);
+	_mm256_storeu_ps(out + 8, r23);
+}
+
+__attribute__((target("avx2,fma")))
+inline void mat4MultiplyAVX2(const float *a, const float *b, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++, a += 16, b += 16, out += 16)
+		mat4ProductAVX2(_mm256_broadcast_ps((const __m128*)a), _mm256_broadcast_ps((const __m128*)(a + 4)),
+			_mm256_broadcast_ps((const __m128*)(a + 8)), _mm256_broadcast_ps((const __m128*)(a + 12)), b, out);
+}
+
+__attribute__((target("avx2,fma")))
+inline void mat4MultiplyOneAVX2(const float *m, const float *b, float *out, size_t count)
+{
+	__m256 a0 = _mm256_broadcast_ps((const __m128*)m), a1 = _mm256_broadcast_ps((const __m128*)(m + 4));
+	__m256 a2 = _mm256_broadcast_ps((const __m128*)(m + 8)), a3 = _mm256_broadcast_ps((const __m128*)(m + 12));
+	for (size_t i = 0; i < count; i++, b += 16, out += 16)
+		mat4ProductAVX2(a0, a1, a2, a3, b, out);
+}
+
+// two points per iteration, one per half
+__attribute__((target("avx2,fma")))
+inline void mat4TransformPointsAVX2(const float *m, const float *points, float *out, size_t count)
+{
+	__m256 c0 = _mm256_broadcast_ps((const __m128*)m), c1 = _mm256_broadcast_ps((const __m128*)(m + 4));
+	__m256 c2 = _mm256_broadcast_ps((const __m128*)(m + 8)), c3 = _mm256_broadcast_ps((const __m128*)(m + 12));
+	__m256i six = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+	__m256i ix = _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3), one = _mm256_set1_epi32(1);
+	__m256i iy = _mm256_add_epi32(ix, one), iz = _mm256_add_epi32(iy, one);
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2, points += 6, out += 8)
+	{
+		__m256 p = _mm256_maskload_ps(points, six);
+		__m256 xy = _mm256_fmadd_ps(c1, _mm256_permutevar8x32_ps(p, iy), _mm256_mul_ps(c0, _mm256_permutevar8x32_ps(p, ix)));
+		_mm256_storeu_ps(out, _mm256_add_ps(xy, _mm256_fmadd_ps(c2, _mm256_permutevar8x32_ps(p, iz), c3)));
+	}
+	mat4TransformPointsScalar(m, points, out, count - i);
+}
+
+// 4x4 transposes within each 128-bit half: half h of row k ends up as the
+// column of matrix 4h + k
+__attribute__((target("avx2,fma")))
+inline void mat4StoreColumnAVX2(__m256 r0, __m256 r1, __m256 r2, __m256 r3, float *out, int column)
+{
+	__m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+	__m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+	__m256 rows[4] = {
+		_mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+		_mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))
+	};
+	for (int k = 0; k < 4; k++)
+	{
+		_mm_storeu_ps(out + k * 16 + column * 4, _mm256_castps256_ps128(rows[k]));
+		_mm_storeu_ps(out + (4 + k) * 16 + column * 4, _mm256_extractf128_ps(rows[k], 1));
+	}
+}
+
+// eight matrices per iteration
+__attribute__((target("avx2,fma")))
+inline void mat4ComposeTRSAVX2(const Mat4TRS &trs, float *out, size_t count)
+{
+	__m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f), two = _mm256_set1_ps(2.0f);
+	size_t i = 0;
+	for (; i + 8 <= count; i += 8, out += 128)
+	{
+		__m256 x = _mm256_loadu_ps(trs.qx + i), y = _mm256_loadu_ps(trs.qy + i);
+		__m256 z = _mm256_loadu_ps(trs.qz + i), w = _mm256_loadu_ps(trs.qw + i);
+		__m256 xx = _mm256_mul_ps(x, x), yy = _mm256_mul_ps(y, y), zz = _mm256_mul_ps(z, z);
+		__m256 xz = _mm256_mul_ps(x, z), xy = _mm256_mul_ps(x, y), yz = _mm256_mul_ps(y, z);
+		__m256 wx = _mm256_mul_ps(w, x), wy = _mm256_mul_ps(w, y), wz = _mm256_mul_ps(w, z);
+		__m256 sx = _mm256_loadu_ps(trs.sx + i), sy = _mm256_loadu_ps(trs.sy + i), sz = _mm256_loadu_ps(trs.sz + i);
+
+		mat4StoreColumnAVX2(_mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one), sx),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xy, wz)), sx),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xz, wy)), sx), zero, out, 0);
+		mat4StoreColumnAVX2(_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(xy, wz)), sy),
+			_mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one), sy),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(yz, wx)), sy), zero, out, 1);
+		mat4StoreColumnAVX2(_mm256_mul_ps(_mm256_mul_ps(two, _mm256_add_ps(xz, wy)), sz),
+			_mm256_mul_ps(_mm256_mul_ps(two, _mm256_sub_ps(yz, wx)), sz),
+			_mm256_mul_ps(_mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one), sz), zero, out, 2);
+		mat4StoreColumnAVX2(_mm256_loadu_ps(trs.tx + i), _mm256_loadu_ps(trs.ty + i), _mm256_loadu_ps(trs.tz + i), one, out, 3);
+	}
+	Mat4TRS rest = { trs.tx + i, trs.ty + i, trs.tz + i, trs.qx + i, trs.qy + i, trs.qz + i, trs.qw + i,
+		trs.sx + i, trs.sy + i, trs.sz + i };
+	mat4ComposeTRSScalar(rest, out, count - i);
+}
+
+// gcc 12 warns about the undefined upper lanes inside its own AVX-512
+// intrinsics (gcc bug 105593)
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+// the whole matrix in one register, column k of 'a' in all four quarters
+// (_mm512_shuffle_f32x4 of the loaded matrix)
+__attribute__((target("avx512f")))
+inline void mat4ProductAVX512(__m512 a0, __m512 a1, __m512 a2, __m512 a3, const float *b, float *out)
+{
+	__m512 m = _mm512_loadu_ps(b);
+	__m512 r = _mm512_mul_ps(a0, _mm512_permute_ps(m, 0x00));
+	r = _mm512_fmadd_ps(a1, _mm512_permute_ps(m, 0x55), r);
+	r = _mm512_fmadd_ps(a2, _mm512_permute_ps(m, 0xAA), r);
+	r = _mm512_fmadd_ps(a3, _mm512_permute_ps(m, 0xFF), r);
+	_mm512_storeu_ps(out, r);
+}
+
+__attribute__((target("avx512f")))
+inline void mat4MultiplyAVX512(const float *a, const float *b, float *out, size_t count)
+{
+	for (size_t i = 0; i < count; i++, a += 16, b += 16, out += 16)
+	{
+		__m512 m = _mm512_loadu_ps(a);
+		mat4ProductAVX512(_mm512_shuffle_f32x4(m, m, 0x00), _mm512_shuffle_f32x4(m, m, 0x55),
+			_mm512_shuffle_f32x4(m, m, 0xAA), _mm512_shuffle_f32x4(m, m, 0xFF), b, out);
+	}
+}
+
+__attribute__((target("avx512f")))
+inline void mat4MultiplyOneAVX512(const float *m, const float *b, float *out, size_t count)
+{
+	__m512 all = _mm512_loadu_ps(m);
+	__m512 a0 = _mm512_shuffle_f32x4(all, all, 0x00), a1 = _mm512_shuffle_f32x4(all, all, 0x55);
+	__m512 a2 = _mm512_shuffle_f32x4(all, all, 0xAA), a3 = _mm512_shuffle_f32x4(all, all, 0xFF);
+	for (size_t i = 0; i < count; i++, b += 16, out += 16)
+		mat4ProductAVX512(a0, a1, a2, a3, b, out);
+}
+
+// four points per iteration, one per quarter
+__attribute__((target("avx512f")))
+inline void mat4TransformPointsAVX512(const float *m, const float *points, float *out, size_t count)
+{
+	__m512 all = _mm512_loadu_ps(m);
+	__m512 c0 = _mm512_shuffle_f32x4(all, all, 0x00), c1 = _mm512_shuffle_f32x4(all, all, 0x55);
+	__m512 c2 = _mm512_shuffle_f32x4(all, all, 0xAA), c3 = _mm512_shuffle_f32x4(all, all, 0xFF);
+	__m512i ix = _mm512_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3, 6, 6, 6, 6, 9, 9, 9, 9), one = _mm512_set1_epi32(1);
+	__m512i iy = _mm512_add_epi32(ix, one), iz = _mm512_add_epi32(iy, one);
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4, points += 12, out += 16)
+	{
+		__m512 p = _mm512_maskz_loadu_ps(0x0FFF, points);
+		__m512 xy = _mm512_fmadd_ps(c1, _mm512_permutexvar_ps(iy, p), _mm512_mul_ps(c0, _mm512_permutexvar_ps(ix, p)));
+		_mm512_storeu_ps(out, _mm512_add_ps(xy, _mm512_fmadd_ps(c2, _mm512_permutexvar_ps(iz, p), c3)));
+	}
+	mat4TransformPointsScalar(m, points, out, count - i);
+}
+
+// quarter q of row k ends up as the column of matrix 4q + k
+__attribute__((target("avx512f")))
+inline void mat4StoreColumnAVX512(__m512 r0, __m512 r1, __m512 r2, __m512 r3, float *out, int column)
+{
+	__m512 t0 = _mm512_unpacklo_ps(r0, r1), t1 = _mm512_unpackhi_ps(r0, r1);
+	__m512 t2 = _mm512_unpacklo_ps(r2, r3), t3 = _mm512_unpackhi_ps(r2, r3);
+	__m512 rows[4] = {
+		_mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0)), _mm512_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2)),
+		_mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0)), _mm512_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2))
+	};
+	for (int k = 0; k < 4; k++)
+	{
+		_mm_storeu_ps(out + k * 16 + column * 4, _mm512_extractf32x4_ps(rows[k], 0));
+		_mm_storeu_ps(out + (4 + k) * 16 + column * 4, _mm512_extractf32x4_ps(rows[k], 1));
+		_mm_storeu_ps(out + (8 + k) * 16 + column * 4, _mm512_extractf32x4_ps(rows[k], 2));
+		_mm_storeu_ps(out + (12 + k) * 16 + column * 4, _mm512_extractf32x4_ps(rows[k], 3));
+	}
+}
+
+// sixteen matrices per iteration
+__attribute__((target("avx512f")))
+inline void mat4ComposeTRSAVX512(const Mat4TRS &trs, float *out, size_t count)
+{
+	__m512 zero = _mm512_setzero_ps(), one = _mm512_set1_ps(1.0f), two = _mm512_set1_ps(2.0f);
+	size_t i = 0;
+	for (; i + 16 <= count; i += 16, out += 256)
+	{
+		__m512 x = _mm512_loadu_ps(trs.qx + i), y = _mm512_loadu_ps(trs.qy + i);
+		__m512 z = _mm512_loadu_ps(trs.qz + i), w = _mm512_loadu_ps(trs.qw + i);
+		__m512 xx = _mm512_mul_ps(x, x), yy = _mm512_mul_ps(y, y), zz = _mm512_mul_ps(z, z);
+		__m512 xz = _mm512_mul_ps(x, z), xy = _mm512_mul_ps(x, y), yz = _mm512_mul_ps(y, z);
+		__m512 wx = _mm512_mul_ps(w, x), wy = _mm512_mul_ps(w, y), wz = _mm512_mul_ps(w, z);
+		__m512 sx = _mm512_loadu_ps(trs.sx + i), sy = _mm512_loadu_ps(trs.sy + i), sz = _mm512_loadu_ps(trs.sz + i);
+
+		mat4StoreColumnAVX512(_mm512_mul_ps(_mm512_fnmadd_ps(two, _mm512_add_ps(yy, zz), one), sx),
+			_mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(xy, wz)), sx),
+			_mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(xz, wy)), sx), zero, out, 0);
+		mat4StoreColumnAVX512(_mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(xy, wz)), sy),
+			_mm512_mul_ps(_mm512_fnmadd_ps(two, _mm512_add_ps(xx, zz), one), sy),
+			_mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(yz, wx)), sy), zero, out, 1);
+		mat4StoreColumnAVX512(_mm512_mul_ps(_mm512_mul_ps(two, _mm512_add_ps(xz, wy)), sz),
+			_mm512_mul_ps(_mm512_mul_ps(two, _mm512_sub_ps(yz, wx)), sz),
+			_mm512_mul_ps(_mm512_fnmadd_ps(two, _mm512_add_ps(xx, yy), one), sz), zero, out, 2);
+		mat4StoreColumnAVX512(_mm512_loadu_ps(trs.tx + i), _mm512_loadu_ps(trs.ty + i), _mm512_loadu_ps(trs.tz + i), one, out, 3);
+	}
+	Mat4TRS rest = { trs.tx + i, trs.ty + i, trs.tz + i, trs.qx + i, trs.qy + i, trs.qz + i, trs.qw + i,
+		trs.sx + i, trs.sy + i, trs.sz + i };
+	mat4ComposeTRSScalar(rest, out, count - i);
+}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
+
+struct Mat4Kernels {
+	const char *isa;
+	void (*multiply)(const float*, const float*, float*, size_t);
+	void (*multiplyOne)(const float*, const float*, float*, size_t);
+	void (*transformPoints)(const float*, const float*, float*, size_t);
+	void (*composeTRS)(const Mat4TRS&, float*, size_t);
+};
+
+inline bool mat4Supported(int isa)
+{
+#ifdef MAT4_X86
+	if (isa == MAT4_AVX512)
+		return __builtin_cpu_supports("avx512f");
+	if (isa == MAT4_AVX2)
+		return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+	return isa == MAT4_SSE2 || isa == MAT4_SCALAR;
+#else
+	return isa == MAT4_SCALAR;
+#endif
+}
+
+// the kernels of one instruction set, check mat4Supported() first
+inline Mat4Kernels mat4KernelsFor(int isa)
+{
+	Mat4Kernels k = { "scalar", mat4MultiplyScalar, mat4MultiplyOneScalar, mat4TransformPointsScalar, mat4ComposeTRSScalar };
+#ifdef MAT4_X86
+	if (isa == MAT4_SSE2)
+	{
+		Mat4Kernels sse2 = { "SSE2", mat4MultiplySSE2, mat4MultiplyOneSSE2, mat4TransformPointsSSE2, mat4ComposeTRSSSE2 };
+		k = sse2;
+	}
+	else if (isa == MAT4_AVX2)
+	{
+		Mat4Kernels avx2 = { "AVX2", mat4MultiplyAVX2, mat4MultiplyOneAVX2, mat4TransformPointsAVX2, mat4ComposeTRSAVX2 };
+		k = avx2;
+	}
+	else if (isa == MAT4_AVX512)
+	{
+		Mat4Kernels avx512 = { "AVX-512", mat4MultiplyAVX512, mat4MultiplyOneAVX512, mat4TransformPointsAVX512,
+			mat4ComposeTRSAVX512 };
+		k = avx512;
+	}
+#endif
+	return k;
+}
+
+// the widest supported set, chosen on first use
+inline const Mat4Kernels &mat4Kernels()
+{
+	static const Mat4Kernels best = mat4KernelsFor(mat4Supported(MAT4_AVX512) ? MAT4_AVX512 :
+		mat4Supported(MAT4_AVX2) ? MAT4_AVX2 : mat4Supported(MAT4_SSE2) ? MAT4_SSE2 : MAT4_SCALAR);
+	return best;
+}
+
+inline void mat4Multiply(const float *a, const float *b, float *out, size_t count)
+{
+	mat4Kernels().multiply(a, b, out, count);
+}
+
+inline void mat4MultiplyOne(const float *m, const float *b, float *out, size_t count)
+{
+	mat4Kernels().multiplyOne(m, b, out, count);
+}
+
+inline void mat4TransformPoints(const float *m, const float *points, float *out, size_t count)
+{
+	mat4Kernels().transformPoints(m, points, out, count);
+}
+
+inline void mat4ComposeTRS(const Mat4TRS &trs, float *out, size_t count)
+{
+	mat4Kernels().composeTRS(trs, out, count);
+}
+
+#endif
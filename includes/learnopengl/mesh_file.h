@@ -0,0 +1,583 @@
+#ifndef MESH_FILE_H
+#define MESH_FILE_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "vertex_layout.h"
+#include "mesh_optimizer.h"
+
+// binary mesh file: everything the GPU needs in the layout it needs it, so
+// loading is mmap + glBufferData without any parsing
+//
+//   MeshFileHeader
+//   vertices   vertexCount x MeshFileVertex (16 bytes)
+//   indices    indexCount x GL_UNSIGNED_SHORT or GL_UNSIGNED_INT, cache/overdraw/fetch optimized
+//   meshlets   meshletCount x MeshFileMeshlet, consecutive ranges of the index buffer
+//
+// sections start on 16 byte boundaries. positions are quantized to 16 bits
+// inside the bounding box, the vertex shader restores them with
+//   position = boundsMin + aPos.xyz * (boundsMax - boundsMin)
+
+struct MeshFileVertex {
+	UNorm16x4 position;
+	SNorm1010102 normal;
+	Half2 texCoord;
+};
+
+typedef VertexLayout<MeshFileVertex,
+	VERTEX_ATTRIB(MeshFileVertex, position, 0),
+	VERTEX_ATTRIB(MeshFileVertex, normal, 1),
+	VERTEX_ATTRIB(MeshFileVertex, texCoord, 2)> MeshFileLayout;
+
+// up to 64 vertices and 124 triangles with a bounding sphere and a normal cone:
+// the meshlet faces away from a camera at 'eye' (and can be skipped) when
+//   dot(center - eye, coneAxis) >= coneCutoff * length(center - eye) + radius
+struct MeshFileMeshlet {
+	unsigned int indexOffset, indexCount;
+	float center[3], radius;
+	float coneAxis[3], coneCutoff;	// cutoff is sin of the cone angle, 1 disables culling
+};
+
+struct MeshFileHeader {
+	char magic[4];			// "LOGM"
+	unsigned int version;
+	unsigned int vertexCount, indexCount, meshletCount;
+	unsigned int indexType;
+	float boundsMin[3], boundsMax[3];
+	float sphere[4];		// bounding sphere center and radius
+	unsigned long long vertexOffset, indexOffset, meshletOffset;
+};
+
+static const unsigned int MESH_FILE_VERSION = 1;
+static const unsigned int MESHLET_MAX_VERTICES = 64;
+static const unsigned int MESHLET_MAX_TRIANGLES = 124;
+
+// ---------------------------------------------------------------------------
+// offline conversion from OBJ
+
+struct MeshConvertStats {
+	double parseSeconds, optimizeSeconds, writeSeconds;
+	size_t triangles, objVertices, vertices, meshlets;
+	VertexCacheStats before, after;
+	size_t fileBytes;
+};
+
+// hand rolled number parsing, strtod is locale dependent and several times slower
+inline const char *objSkipSpace(const char *p, const char *end)
+{
+	while (p < end && (*p == ' ' || *p == '\t'))
+		p++;
+	return p;
+}
+
+inline const char *objParseFloat(const char *p, const char *end, float &value)
+{
+	p = objSkipSpace(p, end);
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+	double result = 0.0;
+	while (p < end && *p >= '0' && *p <= '9')
+		result = result * 10.0 + (*p++ - '0');
+	if (p < end && *p == '.')
+	{
+		p++;
+		double scale = 0.1;
+		while (p < end && *p >= '0' && *p <= '9')
+		{
+			result += (*p++ - '0') * scale;
+			scale *= 0.1;
+		}
+	}
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		p++;
+		bool negativeExponent = false;
+		if (p < end && (*p == '-' || *p == '+'))
+			negativeExponent = *p++ == '-';
+		int exponent = 0;
+		while (p < end && *p >= '0' && *p <= '9')
+			exponent = exponent * 10 + (*p++ - '0');
+		result *= pow(10.0, negativeExponent ? -exponent : exponent);
+	}
+	value = (float)(negative ? -result : result);
+	return p;
+}
+
+inline const char *objParseInt(const char *p, const char *end, int &value)
+{
+	bool negative = false;
+	if (p < end && (*p == '-' || *p == '+'))
+		negative = *p++ == '-';
+	int result = 0;
+	while (p < end && *p >= '0' && *p <= '9')
+		result = result * 10 + (*p++ - '0');
+	value = negative ? -result : result;
+	return p;
+}
+
+// read a whole file into memory
+inline bool readFileBytes(const char *path, std::vector<char> &bytes)
+{
+	FILE *file = fopen(path, "rb");
+	if (!file)
+		return false;
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	bytes.resize(size > 0 ? (size_t)size : 0);
+	bool ok = bytes.empty() || fread(&bytes[0], 1, bytes.size(), file) == bytes.size();
+	fclose(file);
+	return ok;
+}
+
+// positions, normals and uvs of an OBJ, plus one (position, uv, normal) index
+// triple per triangle corner; missing uvs and normals are ~0u. polygons are fanned.
+// a face that references a vertex the file doesn't define rejects the whole file
+inline bool parseOBJ(const char *path, std::vector<float> &positions, std::vector<float> &normals,
+	std::vector<float> &texCoords, std::vector<unsigned int> &corners)
+{
+	std::vector<char> text;
+	if (!readFileBytes(path, text))
+		return false;
+	const char *p = text.empty() ? NULL : &text[0], *end = p + text.size();
+	std::vector<unsigned int> face;
+	unsigned int line = 0;
+	while (p < end)
+	{
+		line++;
+		const char *lineEnd = (const char*)memchr(p, '\n', end - p);
+		if (!lineEnd)
+			lineEnd = end;
+		if (p[0] == 'v' && lineEnd - p > 1 && (p[1] == ' ' || p[1] == '\t'))
+		{
+			float v[3];
+			const char *q = p + 1;
+			for (int k = 0; k < 3; k++)
+				q = objParseFloat(q, lineEnd, v[k]);
+			positions.insert(positions.end(), v, v + 3);
+		}
+		else if (p[0] == 'v' && lineEnd - p > 2 && p[1] == 'n')
+		{
+			float v[3];
+			const char *q = p + 2;
+			for (int k = 0; k < 3; k++)
+				q = objParseFloat(q, lineEnd, v[k]);
+			normals.insert(normals.end(), v, v + 3);
+		}
+		else if (p[0] == 'v' && lineEnd - p > 2 && p[1] == 't')
+		{
+			float v[2];
+			const char *q = p + 2;
+			for (int k = 0; k < 2; k++)
+				q = objParseFloat(q, lineEnd, v[k]);
+			texCoords.insert(texCoords.end(), v, v + 2);
+		}
+		else if (p[0] == 'f' && lineEnd - p > 1)
+		{
+			face.clear();
+			const char *q = p + 1;
+			while (true)
+			{
+				q = objSkipSpace(q, lineEnd);
+				if (q >= lineEnd || *q == '\r')
+					break;
+				// v, v/vt, v//vn or v/vt/vn; negative indices count from the end
+				int index[3] = { 0, 0, 0 };
+				size_t counts[3] = { positions.size() / 3, texCoords.size() / 2, normals.size() / 3 };
+				for (int k = 0; k < 3; k++)
+				{
+					if (k > 0)
+					{
+						if (q >= lineEnd || *q != '/')
+							break;
+						q++;
+					}
+					q = objParseInt(q, lineEnd, index[k]);
+				}
+				// the position is required, uv and normal may be left out but not point past the end
+				for (int k = 0; k < 3; k++)
+				{
+					if (k > 0 && index[k] == 0)
+					{
+						face.push_back(~0u);
+						continue;
+					}
+					long long resolved = index[k] > 0 ? (long long)index[k] - 1 : (long long)counts[k] + index[k];
+					if (index[k] == 0 || resolved < 0 || resolved >= (long long)counts[k])
+					{
+						std::cout << "ERROR::MESH::OBJ_FACE_INDEX_OUT_OF_RANGE " << path << ":" << line << std::endl;
+						return false;
+					}
+					face.push_back((unsigned int)resolved);
+				}
+				while (q < lineEnd && *q != ' ' && *q != '\t')
+					q++;
+			}
+			for (size_t c = 2; c < face.size() / 3; c++)
+			{
+				corners.insert(corners.end(), face.begin(), face.begin() + 3);
+				corners.insert(corners.end(), face.begin() + (c - 1) * 3, face.begin() + (c + 1) * 3);
+			}
+		}
+		p = lineEnd + 1;
+	}
+	return true;
+}
+
+// split an optimized index buffer into meshlets in order, with bounds and normal cones
+inline void buildMeshlets(const std::vector<unsigned int> &indices, const std::vector<float> &positions,
+	std::vector<MeshFileMeshlet> &meshlets)
+{
+	std::vector<unsigned int> seen(positions.size() / 3, ~0u);
+	size_t start = 0;
+	while (start < indices.size())
+	{
+		// grow the meshlet triangle by triangle until a limit is hit
+		unsigned int id = (unsigned int)meshlets.size(), vertices = 0;
+		size_t end = start;
+		while (end < indices.size() && (end - start) / 3 < MESHLET_MAX_TRIANGLES)
+		{
+			unsigned int added = 0;
+			for (int k = 0; k < 3; k++)
+				added += seen[indices[end + k]] != id;
+			if (vertices + added > MESHLET_MAX_VERTICES)
+				break;
+			for (int k = 0; k < 3; k++)
+				if (seen[indices[end + k]] != id)
+				{
+					seen[indices[end + k]] = id;
+					vertices++;
+				}
+			end += 3;
+		}
+
+		MeshFileMeshlet m;
+		m.indexOffset = (unsigned int)start;
+		m.indexCount = (unsigned int)(end - start);
+
+		// sphere around the box centre, cone around the area weighted mean normal
+		float low[3] = { 1e30f, 1e30f, 1e30f }, high[3] = { -1e30f, -1e30f, -1e30f }, axis[3] = { 0.0f, 0.0f, 0.0f };
+		std::vector<float> triangleNormals;
+		for (size_t i = start; i < end; i += 3)
+		{
+			const float *a = &positions[indices[i] * 3], *b = &positions[indices[i + 1] * 3], *c = &positions[indices[i + 2] * 3];
+			for (int k = 0; k < 3; k++)
+			{
+				low[k] = std::min(low[k], std::min(a[k], std::min(b[k], c[k])));
+				high[k] = std::max(high[k], std::max(a[k], std::max(b[k], c[k])));
+			}
+			float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] }, e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float length = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			for (int k = 0; k < 3; k++)
+				axis[k] += n[k];
+			if (length > 0.0f)
+				for (int k = 0; k < 3; k++)
+					triangleNormals.push_back(n[k] / length);
+		}
+		m.radius = 0.0f;
+		for (int k = 0; k < 3; k++)
+			m.center[k] = 0.5f * (low[k] + high[k]);
+		for (size_t i = start; i < end; i++)
+		{
+			const float *v = &positions[indices[i] * 3];
+			float dx = v[0] - m.center[0], dy = v[1] - m.center[1], dz = v[2] - m.center[2];
+			m.radius = std::max(m.radius, sqrtf(dx * dx + dy * dy + dz * dz));
+		}
+		float axisLength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+		float minDot = 1.0f;
+		for (int k = 0; k < 3; k++)
+			m.coneAxis[k] = axisLength > 0.0f ? axis[k] / axisLength : 0.0f;
+		for (size_t t = 0; t < triangleNormals.size(); t += 3)
+			minDot = std::min(minDot, triangleNormals[t] * m.coneAxis[0] + triangleNormals[t + 1] * m.coneAxis[1] +
+				triangleNormals[t + 2] * m.coneAxis[2]);
+		// cones wider than about 84 degrees never cull anything
+		m.coneCutoff = axisLength > 0.0f && minDot > 0.1f ? sqrtf(1.0f - minDot * minDot) : 1.0f;
+		meshlets.push_back(m);
+		start = end;
+	}
+}
+
+inline void writePadding(FILE *file, unsigned long long &offset)
+{
+	static const char zeros[16] = { 0 };
+	unsigned long long aligned = (offset + 15) & ~15ull;
+	if (aligned > offset)
+		fwrite(zeros, 1, (size_t)(aligned - offset), file);
+	offset = aligned;
+}
+
+// convert an OBJ into the binary format; normals are generated when missing
+inline bool convertOBJToMeshFile(const char *objPath, const char *meshPath, MeshConvertStats *stats = NULL)
+{
+	MeshConvertStats s;
+	memset(&s, 0, sizeof(s));
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	std::vector<float> positions, normals, texCoords;
+	std::vector<unsigned int> corners;
+	if (!parseOBJ(objPath, positions, normals, texCoords, corners) || corners.empty())
+	{
+		std::cout << "ERROR::MESH::OBJ_NOT_SUCCESSFULLY_READ " << objPath << std::endl;
+		return false;
+	}
+	size_t cornerCount = corners.size() / 3;
+	s.triangles = cornerCount / 3;
+	s.objVertices = positions.size() / 3;
+	std::chrono::steady_clock::time_point parsed = std::chrono::steady_clock::now();
+
+	// smooth normals per position where the file has none
+	std::vector<float> generated;
+	bool missingNormals = false;
+	for (size_t c = 0; c < cornerCount && !missingNormals; c++)
+		missingNormals = corners[c * 3 + 2] == ~0u;
+	if (missingNormals)
+	{
+		generated.assign(positions.size(), 0.0f);
+		for (size_t t = 0; t < cornerCount; t += 3)
+		{
+			const float *a = &positions[corners[t * 3] * 3], *b = &positions[corners[t * 3 + 3] * 3], *c = &positions[corners[t * 3 + 6] * 3];
+			float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] }, e2[3] = { c[0] - a[0], c[1] - a[1], c[2] - a[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			for (int corner = 0; corner < 3; corner++)
+				for (int k = 0; k < 3; k++)
+					generated[corners[(t + corner) * 3] * 3 + k] += n[k];
+		}
+	}
+
+	MeshFileHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "LOGM", 4);
+	header.version = MESH_FILE_VERSION;
+	for (int k = 0; k < 3; k++)
+	{
+		header.boundsMin[k] = 1e30f;
+		header.boundsMax[k] = -1e30f;
+	}
+	for (size_t v = 0; v < positions.size(); v += 3)
+		for (int k = 0; k < 3; k++)
+		{
+			header.boundsMin[k] = std::min(header.boundsMin[k], positions[v + k]);
+			header.boundsMax[k] = std::max(header.boundsMax[k], positions[v + k]);
+		}
+	float extent[3];
+	for (int k = 0; k < 3; k++)
+		extent[k] = header.boundsMax[k] > header.boundsMin[k] ? header.boundsMax[k] - header.boundsMin[k] : 1.0f;
+
+	// quantize every corner, then weld: identical quantized vertices become one
+	std::vector<MeshFileVertex> soup(cornerCount);
+	for (size_t c = 0; c < cornerCount; c++)
+	{
+		unsigned int p = corners[c * 3], t = corners[c * 3 + 1], n = corners[c * 3 + 2];
+		const float *pos = &positions[p * 3];
+		const float *nrm = missingNormals ? &generated[p * 3] : &normals[n * 3];
+		float length = sqrtf(nrm[0] * nrm[0] + nrm[1] * nrm[1] + nrm[2] * nrm[2]);
+		length = length > 0.0f ? length : 1.0f;
+		MeshFileVertex &v = soup[c];
+		v.position = makeUNorm16x4((pos[0] - header.boundsMin[0]) / extent[0], (pos[1] - header.boundsMin[1]) / extent[1],
+			(pos[2] - header.boundsMin[2]) / extent[2]);
+		v.normal = makeSNorm1010102(nrm[0] / length, nrm[1] / length, nrm[2] / length);
+		v.texCoord = t != ~0u ? makeHalf2(texCoords[t * 2], texCoords[t * 2 + 1]) : makeHalf2(0.0f, 0.0f);
+	}
+	std::vector<unsigned int> indices;
+	size_t vertexCount = weldVertices(&soup[0], cornerCount, sizeof(MeshFileVertex), indices);
+	std::vector<unsigned char> vertices;
+	remapVertexBuffer(&soup[0], cornerCount, sizeof(MeshFileVertex), indices, vertexCount, vertices);
+	std::vector<MeshFileVertex>().swap(soup);
+	s.before = analyzeVertexCache(indices, vertexCount);
+
+	// dequantized positions drive the overdraw sort and the meshlet bounds
+	std::vector<float> quantized(vertexCount * 3);
+	for (size_t v = 0; v < vertexCount; v++)
+	{
+		const MeshFileVertex *vertex = (const MeshFileVertex*)&vertices[v * sizeof(MeshFileVertex)];
+		const unsigned short *q = &vertex->position.x;
+		for (int k = 0; k < 3; k++)
+			quantized[v * 3 + k] = header.boundsMin[k] + q[k] / 65535.0f * extent[k];
+	}
+	optimizeOverdraw(indices, &quantized[0], 3 * sizeof(float), vertexCount);
+	s.after = analyzeVertexCache(indices, vertexCount);
+
+	// every welded vertex is referenced, so the fetch order keeps the vertex count
+	std::vector<unsigned int> remap;
+	optimizeVertexFetchRemap(indices, vertexCount, remap);
+	remapVertexBuffer(&vertices[0], vertexCount, sizeof(MeshFileVertex), remap, vertexCount, vertices);
+	std::vector<float> orderedPositions(vertexCount * 3);
+	for (size_t v = 0; v < vertexCount; v++)
+		memcpy(&orderedPositions[remap[v] * 3], &quantized[v * 3], 3 * sizeof(float));
+	remapIndexBuffer(indices, remap);
+
+	std::vector<MeshFileMeshlet> meshlets;
+	buildMeshlets(indices, orderedPositions, meshlets);
+
+	float radius = 0.0f;
+	for (int k = 0; k < 3; k++)
+	{
+		header.sphere[k] = 0.5f * (header.boundsMin[k] + header.boundsMax[k]);
+		radius += 0.25f * extent[k] * extent[k];
+	}
+	header.sphere[3] = sqrtf(radius);
+	header.vertexCount = (unsigned int)vertexCount;
+	header.indexCount = (unsigned int)indices.size();
+	header.meshletCount = (unsigned int)meshlets.size();
+	std::vector<unsigned char> packed;
+	header.indexType = packIndices(indices, vertexCount, packed, false);
+	std::chrono::steady_clock::time_point optimized = std::chrono::steady_clock::now();
+
+	unsigned long long offset = sizeof(header);
+	offset = (offset + 15) & ~15ull;
+	header.vertexOffset = offset;
+	offset = (offset + vertices.size() + 15) & ~15ull;
+	header.indexOffset = offset;
+	offset = (offset + packed.size() + 15) & ~15ull;
+	header.meshletOffset = offset;
+
+	FILE *file = fopen(meshPath, "wb");
+	if (!file)
+	{
+		std::cout << "ERROR::MESH::FILE_NOT_SUCCESSFULLY_WRITTEN " << meshPath << std::endl;
+		return false;
+	}
+	unsigned long long written = sizeof(header);
+	fwrite(&header, sizeof(header), 1, file);
+	writePadding(file, written);
+	fwrite(&vertices[0], 1, vertices.size(), file);
+	written += vertices.size();
+	writePadding(file, written);
+	fwrite(&packed[0], 1, packed.size(), file);
+	written += packed.size();
+	writePadding(file, written);
+	fwrite(&meshlets[0], sizeof(MeshFileMeshlet), meshlets.size(), file);
+	written += meshlets.size() * sizeof(MeshFileMeshlet);
+	bool ok = ferror(file) == 0;
+	fclose(file);
+
+	if (stats)
+	{
+		s.parseSeconds = std::chrono::duration<double>(parsed - start).count();
+		s.optimizeSeconds = std::chrono::duration<double>(optimized - parsed).count();
+		s.writeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - optimized).count();
+		s.vertices = vertexCount;
+		s.meshlets = meshlets.size();
+		s.fileBytes = (size_t)written;
+		*stats = s;
+	}
+	return ok;
+}
+
+// ---------------------------------------------------------------------------
+// runtime loading
+
+struct MeshFile {
+	bool valid;
+	unsigned int VAO, VBO, EBO;
+	GLsizei indexCount;
+	GLenum indexType;
+	MeshFileHeader header;
+	std::vector<MeshFileMeshlet> meshlets;
+	double loadSeconds;
+};
+
+// map the file and upload vertices and indices straight from the mapping. the
+// VAO is set up for MeshFileLayout; the position needs dequantizing in the shader
+inline MeshFile loadMeshFile(const char *path)
+{
+	MeshFile mesh;
+	mesh.valid = false;
+	mesh.VAO = mesh.VBO = mesh.EBO = 0;
+	mesh.indexCount = 0;
+	mesh.indexType = GL_UNSIGNED_INT;
+	mesh.loadSeconds = 0.0;
+	memset(&mesh.header, 0, sizeof(mesh.header));
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	const unsigned char *bytes = NULL;
+	size_t size = 0;
+#ifndef _WIN32
+	int fd = open(path, O_RDONLY);
+	struct stat info;
+	if (fd >= 0 && fstat(fd, &info) == 0 && info.st_size > 0)
+	{
+		size = (size_t)info.st_size;
+		void *mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapping != MAP_FAILED)
+		{
+			bytes = (const unsigned char*)mapping;
+			madvise(mapping, size, MADV_WILLNEED);
+		}
+	}
+	if (fd >= 0)
+		close(fd);
+#else
+	std::vector<char> fallback;
+	if (readFileBytes(path, fallback) && !fallback.empty())
+	{
+		bytes = (const unsigned char*)&fallback[0];
+		size = fallback.size();
+	}
+#endif
+
+	const MeshFileHeader *header = (const MeshFileHeader*)bytes;
+	bool valid = bytes && size >= sizeof(MeshFileHeader) && memcmp(header->magic, "LOGM", 4) == 0 &&
+		header->version == MESH_FILE_VERSION;
+	size_t indexSize = valid && header->indexType == GL_UNSIGNED_SHORT ? 2 : 4;
+	valid = valid && header->vertexOffset + (unsigned long long)header->vertexCount * sizeof(MeshFileVertex) <= size &&
+		header->indexOffset + (unsigned long long)header->indexCount * indexSize <= size &&
+		header->meshletOffset + (unsigned long long)header->meshletCount * sizeof(MeshFileMeshlet) <= size;
+	if (!valid)
+		std::cout << "ERROR::MESH::FILE_NOT_SUCCESSFULLY_READ " << path << std::endl;
+	else
+	{
+		mesh.header = *header;
+		mesh.indexCount = (GLsizei)header->indexCount;
+		mesh.indexType = header->indexType;
+		const MeshFileMeshlet *meshlets = (const MeshFileMeshlet*)(bytes + header->meshletOffset);
+		mesh.meshlets.assign(meshlets, meshlets + header->meshletCount);
+
+		glGenVertexArrays(1, &mesh.VAO);
+		glGenBuffers(1, &mesh.VBO);
+		glGenBuffers(1, &mesh.EBO);
+		glBindVertexArray(mesh.VAO);
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
+		glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)header->vertexCount * sizeof(MeshFileVertex), bytes + header->vertexOffset, GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)header->indexCount * indexSize, bytes + header->indexOffset, GL_STATIC_DRAW);
+		MeshFileLayout::apply();
+		glBindVertexArray(0);
+		mesh.valid = true;
+	}
+
+#ifndef _WIN32
+	if (bytes)
+		munmap((void*)bytes, size);
+#endif
+	mesh.loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return mesh;
+}
+
+inline void deleteMeshFile(MeshFile &mesh)
+{
+	glDeleteVertexArrays(1, &mesh.VAO);
+	glDeleteBuffers(1, &mesh.VBO);
+	glDeleteBuffers(1, &mesh.EBO);
+	mesh.valid = false;
+}
+
+#endif
@@ -0,0 +1,347 @@
+#ifndef MESH_OPTIMIZER_H
+#define MESH_OPTIMIZER_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// index and vertex buffer optimization for indexed triangle lists:
+//   weldVertices        merge byte-identical vertices
+//   optimizeVertexCache reorder triangles for the post-transform cache (Tipsify,
+//                       Sander et al. 2007)
+//   optimizeOverdraw    cache optimize, then reorder clusters of that order so
+//                       outward facing ones come first, giving up at most
+//                       'threshold' of the ACMR
+//   optimizeVertexFetch renumber vertices in first use order for fetch locality
+//   packIndices         store indices in the narrowest GL index type
+// the passes run in this order; each keeps the triangles, only their order changes
+
+// average cache miss ratio (transformed vertices per triangle, 0.5 at best for
+// large grids, 3 at worst) and average transform to vertex ratio (1 is ideal)
+struct VertexCacheStats {
+	float acmr;
+	float atvr;
+};
+
+// FIFO cache simulation, the model post-transform caches are closest to
+inline VertexCacheStats analyzeVertexCache(const std::vector<unsigned int> &indices, size_t vertexCount, int cacheSize = 16)
+{
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	unsigned int time = (unsigned int)cacheSize + 1;
+	size_t misses = 0;
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		unsigned int v = indices[i];
+		if (time - timestamps[v] > (unsigned int)cacheSize)
+		{
+			timestamps[v] = time++;
+			misses++;
+		}
+	}
+	VertexCacheStats stats;
+	stats.acmr = indices.empty() ? 0.0f : (float)misses / (indices.size() / 3);
+	stats.atvr = vertexCount == 0 ? 0.0f : (float)misses / vertexCount;
+	return stats;
+}
+
+// remap[i] is the new index of vertex i; returns the number of unique vertices.
+// the first occurrence of every vertex keeps the lowest new index
+inline size_t weldVertices(const void *vertices, size_t vertexCount, size_t stride, std::vector<unsigned int> &remap)
+{
+	const unsigned char *bytes = (const unsigned char*)vertices;
+	remap.assign(vertexCount, ~0u);
+
+	// open addressing hash table of first occurrences
+	size_t buckets = 1;
+	while (buckets < vertexCount * 2)
+		buckets *= 2;
+	std::vector<unsigned int> table(buckets, ~0u);
+	size_t unique = 0;
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		const unsigned char *v = bytes + i * stride;
+		unsigned int hash = 2166136261u;
+		for (size_t b = 0; b < stride; b++)
+			hash = (hash ^ v[b]) * 16777619u;
+		size_t slot = hash & (buckets - 1);
+		while (table[slot] != ~0u && memcmp(bytes + (size_t)table[slot] * stride, v, stride) != 0)
+			slot = (slot + 1) & (buckets - 1);
+		if (table[slot] == ~0u)
+		{
+			table[slot] = (unsigned int)i;
+			remap[i] = (unsigned int)unique++;
+		}
+		else
+			remap[i] = remap[table[slot]];
+	}
+	return unique;
+}
+
+// compact a vertex buffer with a remap table from weldVertices or optimizeVertexFetch
+inline void remapVertexBuffer(const void *vertices, size_t vertexCount, size_t stride,
+	const std::vector<unsigned int> &remap, size_t newCount, std::vector<unsigned char> &out)
+{
+	std::vector<unsigned char> result(newCount * stride);
+	for (size_t i = 0; i < vertexCount; i++)
+		if (remap[i] != ~0u)
+			memcpy(&result[(size_t)remap[i] * stride], (const unsigned char*)vertices + i * stride, stride);
+	out.swap(result);
+}
+
+inline void remapIndexBuffer(std::vector<unsigned int> &indices, const std::vector<unsigned int> &remap)
+{
+	for (size_t i = 0; i < indices.size(); i++)
+		indices[i] = remap[indices[i]];
+}
+
+// Tipsify. 'clusters' receives the triangle offsets where the walk hit a dead end
+// and had to jump, used by optimizeOverdraw as hard cluster boundaries
+inline void optimizeVertexCache(std::vector<unsigned int> &indices, size_t vertexCount, int cacheSize = 16,
+	std::vector<unsigned int> *clusters = NULL)
+{
+	size_t triangleCount = indices.size() / 3;
+
+	// vertex -> triangle adjacency
+	std::vector<unsigned int> offsets(vertexCount + 1, 0), live(vertexCount, 0);
+	for (size_t i = 0; i < indices.size(); i++)
+		live[indices[i]]++;
+	for (size_t v = 0; v < vertexCount; v++)
+		offsets[v + 1] = offsets[v] + live[v];
+	std::vector<unsigned int> adjacency(indices.size()), fill(offsets.begin(), offsets.end() - 1);
+	for (size_t t = 0; t < triangleCount; t++)
+		for (int k = 0; k < 3; k++)
+			adjacency[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+
+	std::vector<unsigned int> timestamps(vertexCount, 0), deadEnd, candidates, result;
+	std::vector<char> emitted(triangleCount, 0);
+	result.reserve(indices.size());
+	deadEnd.reserve(indices.size());
+	unsigned int time = (unsigned int)cacheSize + 1;
+	size_t cursor = 0;
+	if (clusters)
+		clusters->clear();
+
+	int fanning = vertexCount > 0 && !indices.empty() ? (int)indices[0] : -1;
+	if (clusters && fanning >= 0)
+		clusters->push_back(0);
+	while (fanning >= 0)
+	{
+		// emit all remaining triangles around the fanning vertex
+		candidates.clear();
+		for (unsigned int a = offsets[fanning]; a < offsets[fanning + 1]; a++)
+		{
+			unsigned int t = adjacency[a];
+			if (emitted[t])
+				continue;
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = indices[t * 3 + k];
+				result.push_back(v);
+				deadEnd.push_back(v);
+				candidates.push_back(v);
+				live[v]--;
+				if (time - timestamps[v] > (unsigned int)cacheSize)
+					timestamps[v] = time++;
+			}
+			emitted[t] = 1;
+		}
+
+		// next fanning vertex: the candidate still in cache that will stay there the longest.
+		// one that would drop out of the cache has priority 0 and is left to the dead-end stack
+		int next = -1, best = 0;
+		for (size_t c = 0; c < candidates.size(); c++)
+		{
+			unsigned int v = candidates[c];
+			if (live[v] == 0)
+				continue;
+			int priority = 0;
+			if ((int)(time - timestamps[v]) + 2 * (int)live[v] <= cacheSize)
+				priority = (int)(time - timestamps[v]);
+			if (priority > best)
+			{
+				best = priority;
+				next = (int)v;
+			}
+		}
+		if (next < 0)
+		{
+			// dead end: most recently used vertex with triangles left, else the next one in input order
+			while (!deadEnd.empty() && next < 0)
+			{
+				unsigned int v = deadEnd.back();
+				deadEnd.pop_back();
+				if (live[v] > 0)
+					next = (int)v;
+			}
+			while (next < 0 && cursor < vertexCount)
+			{
+				if (live[cursor] > 0)
+					next = (int)cursor;
+				cursor++;
+			}
+			if (clusters && next >= 0)
+				clusters->push_back((unsigned int)(result.size() / 3));
+		}
+		fanning = next;
+	}
+	indices.swap(result);
+}
+
+// split the clusters of a cache optimized order further wherever the ACMR of
+// the cluster so far is within 'threshold' of the whole mesh, then sort the
+// clusters so outward facing ones (likely occluders) are drawn first
+inline void optimizeOverdraw(std::vector<unsigned int> &indices, const float *positions, size_t stride,
+	size_t vertexCount, float threshold = 1.05f, int cacheSize = 16)
+{
+	std::vector<unsigned int> hard;
+	optimizeVertexCache(indices, vertexCount, cacheSize, &hard);
+	size_t triangleCount = indices.size() / 3;
+	if (triangleCount == 0)
+		return;
+	hard.push_back((unsigned int)triangleCount);
+	float limit = analyzeVertexCache(indices, vertexCount, cacheSize).acmr * threshold;
+	const size_t floats = stride / sizeof(float);
+
+	// soft boundaries
+	std::vector<unsigned int> soft;
+	std::vector<unsigned int> timestamps(vertexCount, 0);
+	unsigned int time = (unsigned int)cacheSize + 1;
+	for (size_t h = 0; h + 1 < hard.size(); h++)
+	{
+		size_t start = hard[h], misses = 0;
+		soft.push_back((unsigned int)start);
+		time += (unsigned int)cacheSize + 1;	// flush
+		for (size_t t = hard[h]; t < hard[h + 1]; t++)
+		{
+			for (int k = 0; k < 3; k++)
+			{
+				unsigned int v = indices[t * 3 + k];
+				if (time - timestamps[v] > (unsigned int)cacheSize)
+				{
+					timestamps[v] = time++;
+					misses++;
+				}
+			}
+			// a cluster needs a few triangles for its normal to mean anything
+			if (t + 1 < hard[h + 1] && t + 1 - start >= 8 && (float)misses / (t + 1 - start) <= limit)
+			{
+				start = t + 1;
+				misses = 0;
+				soft.push_back((unsigned int)start);
+				time += (unsigned int)cacheSize + 1;
+			}
+		}
+	}
+	soft.push_back((unsigned int)triangleCount);
+
+	// mesh centroid
+	float center[3] = { 0.0f, 0.0f, 0.0f };
+	for (size_t v = 0; v < vertexCount; v++)
+		for (int k = 0; k < 3; k++)
+			center[k] += positions[v * floats + k] / vertexCount;
+
+	// sort key per cluster: how far its area weighted centroid lies along its average normal
+	std::vector<std::pair<float, unsigned int> > order;
+	for (size_t c = 0; c + 1 < soft.size(); c++)
+	{
+		float centroid[3] = { 0.0f, 0.0f, 0.0f }, normal[3] = { 0.0f, 0.0f, 0.0f }, area = 0.0f;
+		for (size_t t = soft[c]; t < soft[c + 1]; t++)
+		{
+			const float *a = positions + indices[t * 3] * floats;
+			const float *b = positions + indices[t * 3 + 1] * floats;
+			const float *d = positions + indices[t * 3 + 2] * floats;
+			float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] }, e2[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float w = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+			for (int k = 0; k < 3; k++)
+			{
+				centroid[k] += (a[k] + b[k] + d[k]) / 3.0f * w;
+				normal[k] += n[k];
+			}
+			area += w;
+		}
+		float length = sqrtf(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		float key = 0.0f;
+		if (area > 0.0f && length > 0.0f)
+			for (int k = 0; k < 3; k++)
+				key += (centroid[k] / area - center[k]) * normal[k] / length;
+		order.push_back(std::make_pair(-key, (unsigned int)c));
+	}
+	std::stable_sort(order.begin(), order.end());
+
+	std::vector<unsigned int> result;
+	result.reserve(indices.size());
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		unsigned int c = order[i].second;
+		result.insert(result.end(), indices.begin() + (size_t)soft[c] * 3, indices.begin() + (size_t)soft[c + 1] * 3);
+	}
+	indices.swap(result);
+}
+
+// remap table that numbers vertices in the order the index buffer first uses
+// them; unreferenced vertices map to ~0u and are dropped. returns the new count
+inline size_t optimizeVertexFetchRemap(const std::vector<unsigned int> &indices, size_t vertexCount,
+	std::vector<unsigned int> &remap)
+{
+	remap.assign(vertexCount, ~0u);
+	size_t next = 0;
+	for (size_t i = 0; i < indices.size(); i++)
+		if (remap[indices[i]] == ~0u)
+			remap[indices[i]] = (unsigned int)next++;
+	return next;
+}
+
+// reorder the vertex buffer in place of its first use and rewrite the indices
+inline size_t optimizeVertexFetch(std::vector<unsigned int> &indices, std::vector<unsigned char> &vertices, size_t stride)
+{
+	std::vector<unsigned int> remap;
+	size_t vertexCount = vertices.size() / stride;
+	size_t used = optimizeVertexFetchRemap(indices, vertexCount, remap);
+	remapVertexBuffer(&vertices[0], vertexCount, stride, remap, used, vertices);
+	remapIndexBuffer(indices, remap);
+	return used;
+}
+
+// narrowest of GL_UNSIGNED_BYTE / SHORT / INT that can index 'vertexCount' vertices.
+// byte indices are a slow path on some hardware, pass allowBytes = false to skip them
+inline GLenum narrowestIndexType(size_t vertexCount, bool allowBytes = true)
+{
+	if (allowBytes && vertexCount <= 0x100)
+		return GL_UNSIGNED_BYTE;
+	if (vertexCount <= 0x10000)
+		return GL_UNSIGNED_SHORT;
+	return GL_UNSIGNED_INT;
+}
+
+inline size_t indexTypeSize(GLenum type)
+{
+	return type == GL_UNSIGNED_BYTE ? 1 : (type == GL_UNSIGNED_SHORT ? 2 : 4);
+}
+
+// pack indices for glBufferData, returns the type to pass to glDrawElements
+inline GLenum packIndices(const std::vector<unsigned int> &indices, size_t vertexCount, std::vector<unsigned char> &out,
+	bool allowBytes = true)
+{
+	GLenum type = narrowestIndexType(vertexCount, allowBytes);
+	size_t size = indexTypeSize(type);
+	out.resize(indices.size() * size);
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		if (size == 1)
+			out[i] = (unsigned char)indices[i];
+		else if (size == 2)
+		{
+			unsigned short v = (unsigned short)indices[i];
+			memcpy(&out[i * 2], &v, 2);
+		}
+		else
+			memcpy(&out[i * 4], &indices[i], 4);
+	}
+	return type;
+}
+
+#endif
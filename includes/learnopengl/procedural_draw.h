@@ -0,0 +1,110 @@
+#ifndef PROCEDURAL_DRAW_H
+#define PROCEDURAL_DRAW_H
+
+#include <glad/glad.h>
+
+// attribute-less drawing: the vertex shader derives the corners from
+// gl_VertexID and reads per instance data itself, so there are no vertex
+// buffers and no vertex fetch at all. core profile still wants a VAO bound
+// for drawing, this one simply has no attributes enabled.
+//
+// corners in the vertex shader:
+//   quads (strip of 4)	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);			// 0..1
+//   triangles (3)		vec2 corner = vec2(gl_VertexID == 1, gl_VertexID == 2);			// 0..1
+//   fullscreen (3)		vec2 corner = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);	// 0..2, covers the viewport
+//
+// per instance data comes from an InstanceTexture, a buffer texture read with
+//   uniform samplerBuffer instances;
+//   vec4 data = texelFetch(instances, gl_InstanceID * texelsPerInstance + i);
+class ProceduralDraw {
+public:
+	ProceduralDraw()
+	{
+		glGenVertexArrays(1, &VAO);
+	}
+
+	~ProceduralDraw()
+	{
+		glDeleteVertexArrays(1, &VAO);
+	}
+
+	// 'instances' quads drawn as 4 vertex triangle strips
+	void quads(GLsizei instances) const
+	{
+		glBindVertexArray(VAO);
+		glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances);
+	}
+
+	void triangles(GLsizei instances) const
+	{
+		glBindVertexArray(VAO);
+		glDrawArraysInstanced(GL_TRIANGLES, 0, 3, instances);
+	}
+
+	// one oversized triangle, cheaper than a quad for post processing passes
+	void fullscreenTriangle() const
+	{
+		glBindVertexArray(VAO);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	unsigned int vertexArray() const { return VAO; }
+
+private:
+	unsigned int VAO;
+
+	ProceduralDraw(const ProceduralDraw &);
+	ProceduralDraw &operator=(const ProceduralDraw &);
+};
+
+// buffer object exposed to shaders as a samplerBuffer (GL 3.1 core). texel
+// fetches go through the texture cache instead of the vertex fetch path
+class InstanceTexture {
+public:
+	InstanceTexture(GLenum internalFormat = GL_RGBA32F)
+		: format(internalFormat), bytes(0)
+	{
+		glGenBuffers(1, &buffer);
+		glGenTextures(1, &texture);
+	}
+
+	~InstanceTexture()
+	{
+		glDeleteTextures(1, &texture);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	// replace the contents, reallocating only when the size changes
+	void upload(const void *data, GLsizeiptr size, GLenum usage = GL_STATIC_DRAW)
+	{
+		glBindBuffer(GL_TEXTURE_BUFFER, buffer);
+		if (size != bytes)
+		{
+			glBufferData(GL_TEXTURE_BUFFER, size, data, usage);
+			glBindTexture(GL_TEXTURE_BUFFER, texture);
+			glTexBuffer(GL_TEXTURE_BUFFER, format, buffer);
+			bytes = size;
+		}
+		else
+			glBufferSubData(GL_TEXTURE_BUFFER, 0, size, data);
+	}
+
+	void bind(int unit) const
+	{
+		glActiveTexture(GL_TEXTURE0 + unit);
+		glBindTexture(GL_TEXTURE_BUFFER, texture);
+	}
+
+	unsigned int bufferID() const { return buffer; }
+	GLsizeiptr size() const { return bytes; }
+
+private:
+	unsigned int buffer, texture;
+	GLenum format;
+	GLsizeiptr bytes;
+
+	InstanceTexture(const InstanceTexture &);
+	InstanceTexture &operator=(const InstanceTexture &);
+};
+
+#endif
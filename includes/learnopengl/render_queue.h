@@ -0,0 +1,321 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cstring>
+#include <chrono>
+
+// draws are submitted in any order as (sort key, command) pairs, radix sorted
+// once per frame and executed in one pass that only touches GL where the state
+// actually differs from the previous draw.
+//
+// key layout, most significant bits first:
+//   63..62  layer, drawn in order (world, overlay, ...)
+//   61      blended, drawn after everything opaque in the layer
+//   opaque:   60..51 program, 50..39 texture set, 38..29 VAO, 28..5 depth front to back
+//   blended:  60..37 depth back to front, the rest 0
+// blended draws carry no state bits, so draws at the same depth keep the order
+// they were submitted in (the sort is stable) and overlap exactly like before
+//
+//   queue.clear();
+//   queue.submit(renderElements(shader.ID, VAO, set, 6), depth, glm::value_ptr(trans));
+//   queue.sort();
+//   queue.execute();
+enum RenderBlend { BLEND_NONE, BLEND_ALPHA, BLEND_ADDITIVE, BLEND_PREMULTIPLIED };
+
+struct RenderCommand {
+	unsigned int program, vertexArray;
+	unsigned int textureSet;	// from addTextureSet, 0 binds nothing
+	int blend;					// RenderBlend, blended draws don't write depth
+	GLenum mode;
+	GLsizei count;
+	GLenum indexType;			// 0 draws arrays
+	GLintptr first;				// first vertex, or byte offset into the element buffer
+	GLsizei instances;
+	int matrixLocation;			// mat4 uniform set from the matrix given to submit, -1 for none
+	unsigned int matrix;		// filled in by submit
+};
+
+inline RenderCommand renderElements(unsigned int program, unsigned int vertexArray, unsigned int textureSet, GLsizei count,
+	int blend = BLEND_NONE, int matrixLocation = -1, GLenum mode = GL_TRIANGLES)
+{
+	RenderCommand c = { program, vertexArray, textureSet, blend, mode, count, GL_UNSIGNED_INT, 0, 1, matrixLocation, 0 };
+	return c;
+}
+
+inline RenderCommand renderArrays(unsigned int program, unsigned int vertexArray, unsigned int textureSet, GLsizei count,
+	int blend = BLEND_NONE, int matrixLocation = -1, GLenum mode = GL_TRIANGLES)
+{
+	RenderCommand c = { program, vertexArray, textureSet, blend, mode, count, 0, 0, 1, matrixLocation, 0 };
+	return c;
+}
+
+class RenderQueue {
+public:
+	enum { MAX_SET_TEXTURES = 4 };
+
+	struct Stats {
+		size_t draws;
+		size_t programBinds, vertexArrayBinds, textureBinds, blendChanges, matrixUploads;
+		size_t stateChanges;			// all of the above except the uniforms
+		size_t submissionStateChanges;	// what executing in submission order would have taken
+		int sortPasses;					// radix passes not skipped, out of 8
+		double sortSeconds;
+	};
+
+	RenderQueue()
+	{
+		// set 0 binds no textures
+		TextureSet none;
+		none.count = 0;
+		sets.push_back(none);
+		memset(&stats, 0, sizeof(stats));
+	}
+
+	// textures bound to units 0 to count - 1 (GL_TEXTURE_2D), returns the set for RenderCommand
+	unsigned int addTextureSet(const unsigned int *textures, int count)
+	{
+		TextureSet set;
+		set.count = count < MAX_SET_TEXTURES ? count : MAX_SET_TEXTURES;
+		for (int i = 0; i < set.count; i++)
+			set.textures[i] = textures[i];
+		sets.push_back(set);
+		return (unsigned int)sets.size() - 1;
+	}
+
+	unsigned int addTextureSet(unsigned int texture)
+	{
+		return addTextureSet(&texture, 1);
+	}
+
+	// start a new frame, storage is kept
+	void clear()
+	{
+		commands.clear();
+		entries.clear();
+		matrices.clear();
+		stats.submissionStateChanges = 0;
+		stats.sortPasses = 0;
+		stats.sortSeconds = 0.0;
+	}
+
+	// depth is 0 (near) to 1 (far), 'matrix' is 16 floats copied for the
+	// command's matrixLocation
+	void submit(const RenderCommand &command, float depth = 0.0f, const float *matrix = NULL, int layer = 0)
+	{
+		Entry entry;
+		entry.key = makeKey(command, depth, layer);
+		entry.index = (unsigned int)commands.size();
+		entries.push_back(entry);
+		commands.push_back(command);
+		commands.back().matrix = (unsigned int)(matrices.size() / 16);
+		if (matrix)
+			matrices.insert(matrices.end(), matrix, matrix + 16);
+		else
+			commands.back().matrixLocation = -1;
+	}
+
+	// order the draws by key. without calling this, execute keeps submission order
+	void sort()
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		stats.submissionStateChanges = countStateChanges();
+		stats.sortPasses = radixSort();
+		stats.sortSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// issue every draw, binding only what changed since the previous one. the
+	// first draw binds everything, so state left behind by other code is fine
+	void execute()
+	{
+		Stats s = stats;
+		s.draws = entries.size();
+		s.programBinds = s.vertexArrayBinds = s.textureBinds = s.blendChanges = s.matrixUploads = 0;
+
+		unsigned int program = 0, vertexArray = 0;
+		unsigned int bound[MAX_SET_TEXTURES] = { 0 };
+		int blend = -1;
+		bool first = true;
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			const RenderCommand &c = commands[entries[i].index];
+			if (first || c.program != program)
+			{
+				glUseProgram(c.program);
+				program = c.program;
+				s.programBinds++;
+			}
+			if (first || c.vertexArray != vertexArray)
+			{
+				glBindVertexArray(c.vertexArray);
+				vertexArray = c.vertexArray;
+				s.vertexArrayBinds++;
+			}
+			const TextureSet &set = sets[c.textureSet];
+			for (int unit = 0; unit < set.count; unit++)
+				if (first || bound[unit] != set.textures[unit])
+				{
+					glActiveTexture(GL_TEXTURE0 + unit);
+					glBindTexture(GL_TEXTURE_2D, set.textures[unit]);
+					bound[unit] = set.textures[unit];
+					s.textureBinds++;
+				}
+			if (c.blend != blend)
+			{
+				applyBlend(c.blend);
+				blend = c.blend;
+				s.blendChanges++;
+			}
+			first = false;
+
+			if (c.matrixLocation >= 0)
+			{
+				glUniformMatrix4fv(c.matrixLocation, 1, GL_FALSE, &matrices[c.matrix * 16]);
+				s.matrixUploads++;
+			}
+			if (c.indexType)
+				glDrawElementsInstanced(c.mode, c.count, c.indexType, (void*)c.first, c.instances);
+			else
+				glDrawArraysInstanced(c.mode, (GLint)c.first, c.count, c.instances);
+		}
+		if (blend != BLEND_NONE && blend != -1)
+			applyBlend(BLEND_NONE);
+
+		s.stateChanges = s.programBinds + s.vertexArrayBinds + s.textureBinds + s.blendChanges;
+		stats = s;
+	}
+
+	size_t size() const { return entries.size(); }
+	const Stats &statistics() const { return stats; }
+
+	// 0 to 1023, the position of the name among the programs seen so far
+	unsigned int programSlot(unsigned int program) { return slot(programs, program) & 1023; }
+	unsigned int vertexArraySlot(unsigned int vertexArray) { return slot(vertexArrays, vertexArray) & 1023; }
+
+	unsigned long long makeKey(const RenderCommand &command, float depth, int layer = 0)
+	{
+		depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+		unsigned long long key = (unsigned long long)(layer & 3) << 62;
+		if (command.blend != BLEND_NONE)
+		{
+			unsigned long long back = (unsigned long long)((1.0f - depth) * 16777215.0f);
+			return key | 1ull << 61 | back << 37;
+		}
+		unsigned long long front = (unsigned long long)(depth * 16777215.0f);
+		return key | (unsigned long long)programSlot(command.program) << 51 | (unsigned long long)(command.textureSet & 4095) << 39
+			| (unsigned long long)vertexArraySlot(command.vertexArray) << 29 | front << 5;
+	}
+
+private:
+	struct Entry {
+		unsigned long long key;
+		unsigned int index;
+	};
+
+	struct TextureSet {
+		unsigned int textures[MAX_SET_TEXTURES];
+		int count;
+	};
+
+	std::vector<RenderCommand> commands;
+	std::vector<Entry> entries, scratch;
+	std::vector<float> matrices;
+	std::vector<TextureSet> sets;
+	std::vector<unsigned int> programs, vertexArrays;
+	Stats stats;
+
+	static unsigned int slot(std::vector<unsigned int> &names, unsigned int name)
+	{
+		for (size_t i = 0; i < names.size(); i++)
+			if (names[i] == name)
+				return (unsigned int)i;
+		names.push_back(name);
+		return (unsigned int)names.size() - 1;
+	}
+
+	static void applyBlend(int blend)
+	{
+		if (blend == BLEND_NONE)
+		{
+			glDisable(GL_BLEND);
+			glDepthMask(GL_TRUE);
+			return;
+		}
+		glEnable(GL_BLEND);
+		glDepthMask(GL_FALSE);
+		if (blend == BLEND_ADDITIVE)
+			glBlendFunc(GL_ONE, GL_ONE);
+		else if (blend == BLEND_PREMULTIPLIED)
+			glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+		else
+			glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+
+	// LSD radix sort on bytes, stable. all eight histograms come from one pass
+	// over the keys and bytes every key shares are skipped, which with few
+	// programs and textures is most of them
+	int radixSort()
+	{
+		size_t n = entries.size();
+		if (n < 2)
+			return 0;
+		size_t counts[8][256];
+		memset(counts, 0, sizeof(counts));
+		for (size_t i = 0; i < n; i++)
+		{
+			unsigned long long key = entries[i].key;
+			for (int b = 0; b < 8; b++)
+				counts[b][(key >> (b * 8)) & 255]++;
+		}
+
+		scratch.resize(n);
+		int passes = 0;
+		for (int b = 0; b < 8; b++)
+		{
+			if (counts[b][(entries[0].key >> (b * 8)) & 255] == n)
+				continue;
+			size_t offsets[256], sum = 0;
+			for (int d = 0; d < 256; d++)
+			{
+				offsets[d] = sum;
+				sum += counts[b][d];
+			}
+			for (size_t i = 0; i < n; i++)
+				scratch[offsets[(entries[i].key >> (b * 8)) & 255]++] = entries[i];
+			entries.swap(scratch);
+			passes++;
+		}
+		return passes;
+	}
+
+	// state changes the current order needs, counted the way execute counts them
+	size_t countStateChanges() const
+	{
+		size_t changes = 0;
+		const RenderCommand *previous = NULL;
+		unsigned int bound[MAX_SET_TEXTURES] = { 0 };
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			const RenderCommand &c = commands[entries[i].index];
+			const TextureSet &set = sets[c.textureSet];
+			changes += !previous || c.program != previous->program;
+			changes += !previous || c.vertexArray != previous->vertexArray;
+			changes += !previous || c.blend != previous->blend;
+			for (int unit = 0; unit < set.count; unit++)
+				if (!previous || bound[unit] != set.textures[unit])
+				{
+					bound[unit] = set.textures[unit];
+					changes++;
+				}
+			previous = &c;
+		}
+		return changes;
+	}
+
+	RenderQueue(const RenderQueue &);
+	RenderQueue &operator=(const RenderQueue &);
+};
+
+#endif
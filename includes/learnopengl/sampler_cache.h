@@ -0,0 +1,175 @@
+#ifndef SAMPLER_CACHE_H
+#define SAMPLER_CACHE_H
+
+#include <glad/glad.h>
+
+#include <map>
+#include <vector>
+
+// sampling state (wrapping and filtering) kept apart from the texture object,
+// so the same image can be sampled several ways without being duplicated
+struct SamplerState {
+	GLenum wrapS;
+	GLenum wrapT;
+	GLenum wrapR;
+	GLenum minFilter;
+	GLenum magFilter;
+	// 1 disables anisotropic filtering, only honoured on GL 4.6 contexts
+	unsigned int maxAnisotropy;
+
+	SamplerState(GLenum wrap = GL_REPEAT, GLenum minF = GL_LINEAR_MIPMAP_LINEAR, GLenum magF = GL_LINEAR,
+		unsigned int anisotropy = 1)
+		: wrapS(wrap), wrapT(wrap), wrapR(wrap), minFilter(minF), magFilter(magF), maxAnisotropy(anisotropy)
+	{
+	}
+
+	// pack the state into a single word that identifies it in the cache
+	// bits  0-8 : wrap S/T/R (3 bits each)
+	// bits  9-11: min filter
+	// bit  12   : mag filter
+	// bits 13-17: max anisotropy (1..16)
+	unsigned int key() const
+	{
+		unsigned int aniso = maxAnisotropy < 1 ? 1 : (maxAnisotropy > 16 ? 16 : maxAnisotropy);
+		return wrapIndex(wrapS)
+			| (wrapIndex(wrapT) << 3)
+			| (wrapIndex(wrapR) << 6)
+			| (minFilterIndex(minFilter) << 9)
+			| ((magFilter == GL_NEAREST ? 0u : 1u) << 12)
+			| (aniso << 13);
+	}
+
+	static unsigned int wrapIndex(GLenum wrap)
+	{
+		switch (wrap)
+		{
+		case GL_REPEAT:               return 0;
+		case GL_MIRRORED_REPEAT:      return 1;
+		case GL_CLAMP_TO_EDGE:        return 2;
+		case GL_CLAMP_TO_BORDER:      return 3;
+		case GL_MIRROR_CLAMP_TO_EDGE: return 4;
+		default:                      return 0;
+		}
+	}
+
+	static unsigned int minFilterIndex(GLenum filter)
+	{
+		switch (filter)
+		{
+		case GL_NEAREST:                return 0;
+		case GL_LINEAR:                 return 1;
+		case GL_NEAREST_MIPMAP_NEAREST: return 2;
+		case GL_LINEAR_MIPMAP_NEAREST:  return 3;
+		case GL_NEAREST_MIPMAP_LINEAR:  return 4;
+		case GL_LINEAR_MIPMAP_LINEAR:   return 5;
+		default:                        return 5;
+		}
+	}
+};
+
+// deduplicating cache of sampler objects, bound per texture unit
+class SamplerCache {
+public:
+	// statistics, reset by the owner whenever it wants per-frame numbers
+	unsigned int bindsIssued;
+	unsigned int bindsElided;
+
+	SamplerCache() : bindsIssued(0), bindsElided(0), unboundValue(0)
+	{
+	}
+
+	~SamplerCache()
+	{
+		release();
+	}
+
+	// return the sampler object for the given state, creating it on first use
+	unsigned int get(const SamplerState &state)
+	{
+		unsigned int key = state.key();
+		std::map<unsigned int, unsigned int>::iterator it = samplers.find(key);
+		if (it != samplers.end())
+			return it->second;
+
+		unsigned int sampler;
+		glGenSamplers(1, &sampler);
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, state.wrapS);
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, state.wrapT);
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, state.wrapR);
+		glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, state.minFilter);
+		glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, state.magFilter);
+		if (state.maxAnisotropy > 1 && GLAD_GL_VERSION_4_6)
+			glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, (float)state.maxAnisotropy);
+
+		samplers[key] = sampler;
+		return sampler;
+	}
+
+	// bind the sampler for the given state to a texture unit, skipping the call
+	// when that unit already has it bound
+	void bind(unsigned int unit, const SamplerState &state)
+	{
+		bind(unit, get(state));
+	}
+
+	void bind(unsigned int unit, unsigned int sampler)
+	{
+		if (unit >= bound.size())
+			bound.resize(unit + 1, unboundValue);
+		if (bound[unit] == sampler)
+		{
+			bindsElided++;
+			return;
+		}
+		glBindSampler(unit, sampler);
+		bound[unit] = sampler;
+		bindsIssued++;
+	}
+
+	// unbind the sampler from a unit so the texture's own parameters apply again
+	void unbind(unsigned int unit)
+	{
+		bind(unit, 0u);
+	}
+
+	// forget the bindings, e.g. after code outside the cache called glBindSampler.
+	// every unit, also those not used yet, is unknown until bound again
+	void invalidate()
+	{
+		unboundValue = UNKNOWN;
+		bound.assign(bound.size(), (unsigned int)UNKNOWN);
+	}
+
+	unsigned int size() const
+	{
+		return (unsigned int)samplers.size();
+	}
+
+	void resetStats()
+	{
+		bindsIssued = 0;
+		bindsElided = 0;
+	}
+
+	void release()
+	{
+		for (std::map<unsigned int, unsigned int>::iterator it = samplers.begin(); it != samplers.end(); ++it)
+			glDeleteSamplers(1, &it->second);
+		samplers.clear();
+		bound.clear();
+	}
+
+private:
+	// binding of a unit the cache can't vouch for, never equal to a sampler name
+	static const unsigned int UNKNOWN = ~0u;
+
+	std::map<unsigned int, unsigned int> samplers;
+	std::vector<unsigned int> bound;
+	unsigned int unboundValue;	// what units not in 'bound' yet are assumed to hold: 0 or UNKNOWN
+
+	// sampler objects are GL resources, the cache is not copyable
+	SamplerCache(const SamplerCache &);
+	SamplerCache &operator=(const SamplerCache &);
+};
+
+#endif
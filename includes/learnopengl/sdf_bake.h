@@ -0,0 +1,273 @@
+#ifndef SDF_BAKE_H
+#define SDF_BAKE_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SDF_BAKE_X86 1
+#endif
+
+#include "thread_pool.h"
+#include "texture_storage.h"
+
+// exact Euclidean distance transform (Meijster et al.) of a binary mask and
+// baking of alpha masked sprites into small single channel signed distance
+// fields. the column pass runs 8 (AVX2) or 4 (SSE2) columns per instruction,
+// the row pass is scalar; both are split across a thread pool
+
+struct SdfBakeStats {
+	double seconds;
+	int threads;
+	const char *isa;
+};
+
+// column pass, scalar: g = vertical distance to the closest feature in the column
+inline void edtColumnsScalar(const unsigned char *mask, int w, int h, int x0, int x1, int *g, int inf)
+{
+	for (int x = x0; x < x1; x++)
+	{
+		g[x] = mask[x] ? 0 : inf;
+		for (int y = 1; y < h; y++)
+		{
+			int up = g[(size_t)(y - 1) * w + x] + 1;
+			g[(size_t)y * w + x] = mask[(size_t)y * w + x] ? 0 : (up < inf ? up : inf);
+		}
+		for (int y = h - 2; y >= 0; y--)
+		{
+			int down = g[(size_t)(y + 1) * w + x] + 1;
+			if (down < g[(size_t)y * w + x])
+				g[(size_t)y * w + x] = down;
+		}
+	}
+}
+
+#ifdef SDF_BAKE_X86
+// column pass, SSE2: four neighbouring columns per step since rows are contiguous
+inline void edtColumnsSSE2(const unsigned char *mask, int w, int h, int x0, int x1, int *g, int inf)
+{
+	const __m128i one = _mm_set1_epi32(1), infinity = _mm_set1_epi32(inf), zero = _mm_setzero_si128();
+	int x = x0;
+	for (; x + 4 <= x1; x += 4)
+	{
+		__m128i prev = infinity;
+		for (int y = 0; y < h; y++)
+		{
+			int bytes;
+			memcpy(&bytes, mask + (size_t)y * w + x, 4);
+			__m128i m = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bytes), zero), zero);
+			__m128i feature = _mm_cmpgt_epi32(m, zero);
+			__m128i up = _mm_add_epi32(prev, one);
+			// min(up, inf) without SSE4.1
+			up = _mm_xor_si128(infinity, _mm_and_si128(_mm_xor_si128(up, infinity), _mm_cmplt_epi32(up, infinity)));
+			prev = _mm_andnot_si128(feature, up);
+			_mm_storeu_si128((__m128i*)(g + (size_t)y * w + x), prev);
+		}
+		for (int y = h - 2; y >= 0; y--)
+		{
+			__m128i *row = (__m128i*)(g + (size_t)y * w + x);
+			__m128i cur = _mm_loadu_si128(row);
+			__m128i down = _mm_add_epi32(prev, one);
+			prev = _mm_xor_si128(cur, _mm_and_si128(_mm_xor_si128(down, cur), _mm_cmplt_epi32(down, cur)));
+			_mm_storeu_si128(row, prev);
+		}
+	}
+	edtColumnsScalar(mask, w, h, x, x1, g, inf);
+}
+
+// column pass, AVX2: eight columns per step
+__attribute__((target("avx2")))
+inline void edtColumnsAVX2(const unsigned char *mask, int w, int h, int x0, int x1, int *g, int inf)
+{
+	const __m256i one = _mm256_set1_epi32(1), infinity = _mm256_set1_epi32(inf), zero = _mm256_setzero_si256();
+	int x = x0;
+	for (; x + 8 <= x1; x += 8)
+	{
+		__m256i prev = infinity;
+		for (int y = 0; y < h; y++)
+		{
+			__m256i m = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(mask + (size_t)y * w + x)));
+			__m256i feature = _mm256_cmpgt_epi32(m, zero);
+			prev = _mm256_andnot_si256(feature, _mm256_min_epi32(_mm256_add_epi32(prev, one), infinity));
+			_mm256_storeu_si256((__m256i*)(g + (size_t)y * w + x), prev);
+		}
+		for (int y = h - 2; y >= 0; y--)
+		{
+			__m256i *row = (__m256i*)(g + (size_t)y * w + x);
+			prev = _mm256_min_epi32(_mm256_loadu_si256(row), _mm256_add_epi32(prev, one));
+			_mm256_storeu_si256(row, prev);
+		}
+	}
+	edtColumnsSSE2(mask, w, h, x, x1, g, inf);
+}
+#endif
+
+// row pass: lower envelope of the parabolas (x - i)^2 + g(i)^2, writes squared distances
+inline void edtRow(const int *g, int w, int *d, int *s, int *t)
+{
+	int q = 0;
+	s[0] = 0;
+	t[0] = 0;
+	for (int u = 1; u < w; u++)
+	{
+		long long gu = (long long)g[u] * g[u];
+		while (q >= 0)
+		{
+			long long gs = (long long)g[s[q]] * g[s[q]];
+			long long fs = (long long)(t[q] - s[q]) * (t[q] - s[q]) + gs;
+			long long fu = (long long)(t[q] - u) * (t[q] - u) + gu;
+			if (fs <= fu)
+				break;
+			q--;
+		}
+		if (q < 0)
+		{
+			q = 0;
+			s[0] = u;
+		}
+		else
+		{
+			long long gs = (long long)g[s[q]] * g[s[q]];
+			long long sep = ((long long)u * u - (long long)s[q] * s[q] + gu - gs) / (2LL * (u - s[q])) + 1;
+			if (sep < w)
+			{
+				q++;
+				s[q] = u;
+				t[q] = (int)sep;
+			}
+		}
+	}
+	for (int u = w - 1; u >= 0; u--)
+	{
+		long long dx = u - s[q];
+		long long value = dx * dx + (long long)g[s[q]] * g[s[q]];
+		d[u] = value > 0x7fffffff ? 0x7fffffff : (int)value;
+		if (u == t[q])
+			q--;
+	}
+}
+
+// squared distance of every pixel to the closest pixel with mask != 0
+inline const char *distanceTransform(const std::vector<unsigned char> &mask, int w, int h, std::vector<int> &dist,
+	ThreadPool &pool)
+{
+	const int inf = w + h;
+	std::vector<int> g((size_t)w * h);
+	dist.resize((size_t)w * h);
+
+	const char *isa = "scalar";
+	void (*columns)(const unsigned char*, int, int, int, int, int*, int) = edtColumnsScalar;
+#ifdef SDF_BAKE_X86
+	columns = edtColumnsSSE2;
+	isa = "SSE2";
+	if (__builtin_cpu_supports("avx2"))
+	{
+		columns = edtColumnsAVX2;
+		isa = "AVX2";
+	}
+#endif
+	pool.parallelFor(w, [&](int begin, int end) {
+		columns(&mask[0], w, h, begin, end, &g[0], inf);
+	}, 8);
+
+	pool.parallelFor(h, [&](int begin, int end) {
+		std::vector<int> s(w), t(w);
+		for (int y = begin; y < end; y++)
+			edtRow(&g[(size_t)y * w], w, &dist[(size_t)y * w], &s[0], &t[0]);
+	});
+	return isa;
+}
+
+// bake the alpha channel (the only channel of grey images) into an outW x outH
+// distance field. 0.5 is the edge, values grow inside; 'spread' is the distance
+// in output texels mapped to 0 and 1
+inline std::vector<unsigned char> bakeSDF(const unsigned char *data, int w, int h, int channels, int outW, int outH,
+	float spread = 4.0f, ThreadPool &pool = ThreadPool::shared(), SdfBakeStats *stats = NULL)
+{
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	int alpha = channels == 4 ? 3 : (channels == 2 ? 1 : 0);
+	std::vector<unsigned char> inside((size_t)w * h), outside((size_t)w * h);
+	for (size_t i = 0, n = (size_t)w * h; i < n; i++)
+	{
+		inside[i] = data[i * channels + alpha] >= 128;
+		outside[i] = !inside[i];
+	}
+
+	// distance to the shape for outside pixels, to the background for inside ones
+	std::vector<int> toInside, toOutside;
+	const char *isa = distanceTransform(inside, w, h, toInside, pool);
+	distanceTransform(outside, w, h, toOutside, pool);
+
+	// signed distance in source pixels, the edge lies half a pixel from either side
+	std::vector<float> field((size_t)w * h);
+	pool.parallelFor(h, [&](int begin, int end) {
+		size_t i = (size_t)begin * w, last = (size_t)end * w;
+#ifdef SDF_BAKE_X86
+		const __m128 half = _mm_set1_ps(0.5f);
+		for (; i + 4 <= last; i += 4)
+		{
+			__m128 in = _mm_sqrt_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&toOutside[i])));
+			__m128 out = _mm_sqrt_ps(_mm_cvtepi32_ps(_mm_loadu_si128((const __m128i*)&toInside[i])));
+			// exactly one of the two is zero for every pixel
+			_mm_storeu_ps(&field[i], _mm_sub_ps(_mm_max_ps(_mm_sub_ps(in, half), _mm_setzero_ps()),
+				_mm_max_ps(_mm_sub_ps(out, half), _mm_setzero_ps())));
+		}
+#endif
+		for (; i < last; i++)
+			field[i] = std::max(sqrtf((float)toOutside[i]) - 0.5f, 0.0f) - std::max(sqrtf((float)toInside[i]) - 0.5f, 0.0f);
+	});
+
+	// resample at the output texel centres and encode
+	std::vector<unsigned char> sdf((size_t)outW * outH);
+	float scaleX = (float)w / outW, scaleY = (float)h / outH;
+	float range = spread * (scaleX > scaleY ? scaleX : scaleY);
+	pool.parallelFor(outH, [&](int begin, int end) {
+		for (int oy = begin; oy < end; oy++)
+		{
+			float fy = (oy + 0.5f) * scaleY - 0.5f;
+			fy = fy < 0.0f ? 0.0f : (fy > h - 1 ? (float)(h - 1) : fy);
+			int y0 = (int)fy, y1 = y0 + 1 < h ? y0 + 1 : y0;
+			float ty = fy - y0;
+			for (int ox = 0; ox < outW; ox++)
+			{
+				float fx = (ox + 0.5f) * scaleX - 0.5f;
+				fx = fx < 0.0f ? 0.0f : (fx > w - 1 ? (float)(w - 1) : fx);
+				int x0 = (int)fx, x1 = x0 + 1 < w ? x0 + 1 : x0;
+				float tx = fx - x0;
+				float a = field[(size_t)y0 * w + x0] * (1 - tx) + field[(size_t)y0 * w + x1] * tx;
+				float b = field[(size_t)y1 * w + x0] * (1 - tx) + field[(size_t)y1 * w + x1] * tx;
+				float v = 0.5f + (a * (1 - ty) + b * ty) / (2.0f * range);
+				v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+				sdf[(size_t)oy * outW + ox] = (unsigned char)(v * 255.0f + 0.5f);
+			}
+		}
+	});
+
+	if (stats)
+	{
+		stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		stats->threads = pool.size();
+		stats->isa = isa;
+	}
+	return sdf;
+}
+
+// single level R8 texture for a baked field, linear filtering reconstructs the edge
+inline unsigned int createSDFTexture(const std::vector<unsigned char> &sdf, int w, int h)
+{
+	unsigned int texture = createImmutableTexture2D(&sdf[0], w, h, 1, false, false);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	return texture;
+}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef STREAM_BUFFER_H
+#define STREAM_BUFFER_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+
+// buffer for data the CPU rewrites every frame (animated vertices, per frame
+// indices). with GL 4.4 it is one persistently mapped buffer split into
+// 'frames' partitions: the CPU writes partition n while the GPU still reads
+// n-1 and n-2, and a fence per partition makes the CPU wait only if it gets a
+// full ring ahead. without GL 4.4 each frame orphans the buffer instead.
+//
+//   void *dst = stream.begin();		// may wait for the GPU
+//   ... write up to frameSize bytes ...
+//   GLintptr offset = stream.end();	// byte offset of this frame's data
+//   ... draw using offset (baseVertex = offset / stride) ...
+//   stream.fence();					// after the last draw reading it
+//
+// the buffer is only ever bound to GL_COPY_WRITE_BUFFER here, so it can be
+// attached to a VAO as vertex or index buffer once; its name never changes
+class StreamBuffer {
+public:
+	struct Stats {
+		unsigned long long frames;
+		unsigned long long waits;	// frames where the partition was still in use by the GPU,
+									// always 0 when orphaning since the driver hides the stall
+		double waitSeconds;
+		double maxWaitSeconds;
+	};
+
+	StreamBuffer(GLsizeiptr bytesPerFrame, int frameCount = 3, bool allowPersistent = true)
+		: frameSize(bytesPerFrame), frames(frameCount), current(0), mapped(NULL)
+	{
+		persistent = allowPersistent && GLAD_GL_VERSION_4_4;
+		for (int i = 0; i < MAX_FRAMES; i++)
+			fences[i] = 0;
+		if (frames > MAX_FRAMES)
+			frames = MAX_FRAMES;
+		resetStats();
+
+		glGenBuffers(1, &ID);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+		if (persistent)
+		{
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			glBufferStorage(GL_COPY_WRITE_BUFFER, frameSize * frames, NULL, flags);
+			mapped = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, frameSize * frames, flags);
+		}
+		else
+			glBufferData(GL_COPY_WRITE_BUFFER, frameSize, NULL, GL_STREAM_DRAW);
+	}
+
+	~StreamBuffer()
+	{
+		for (int i = 0; i < MAX_FRAMES; i++)
+			if (fences[i])
+				glDeleteSync(fences[i]);
+		if (persistent)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		}
+		glDeleteBuffers(1, &ID);
+	}
+
+	// pointer to frameSize writable bytes for this frame
+	void *begin()
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+		if (!persistent)
+		{
+			// orphan: the driver hands out fresh storage while the GPU keeps the old one
+			glBufferData(GL_COPY_WRITE_BUFFER, frameSize, NULL, GL_STREAM_DRAW);
+			return glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, frameSize, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		}
+		wait(fences[current]);
+		if (fences[current])
+		{
+			glDeleteSync(fences[current]);
+			fences[current] = 0;
+		}
+		return mapped + frameSize * current;
+	}
+
+	// finish writing, returns the byte offset of this frame's data in the buffer
+	GLintptr end()
+	{
+		if (!persistent)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, ID);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			return 0;
+		}
+		return frameSize * current;
+	}
+
+	// mark the partition as in use by the commands issued so far and move on
+	void fence()
+	{
+		if (persistent)
+		{
+			fences[current] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			current = (current + 1) % frames;
+		}
+		stats.frames++;
+	}
+
+	unsigned int buffer() const { return ID; }
+	bool isPersistent() const { return persistent; }
+	int frameCount() const { return persistent ? frames : 1; }
+	const Stats &statistics() const { return stats; }
+
+	void resetStats()
+	{
+		stats.frames = 0;
+		stats.waits = 0;
+		stats.waitSeconds = 0.0;
+		stats.maxWaitSeconds = 0.0;
+	}
+
+private:
+	enum { MAX_FRAMES = 8 };
+
+	unsigned int ID;
+	GLsizeiptr frameSize;
+	int frames;
+	int current;
+	bool persistent;
+	unsigned char *mapped;
+	GLsync fences[MAX_FRAMES];
+	Stats stats;
+
+	// block until the GPU is done with a partition, counting only real waits
+	void wait(GLsync sync)
+	{
+		if (!sync)
+			return;
+		GLenum result = glClientWaitSync(sync, 0, 0);
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+			return;
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		do
+			result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000ull);
+		while (result == GL_TIMEOUT_EXPIRED);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		stats.waits++;
+		stats.waitSeconds += seconds;
+		if (seconds > stats.maxWaitSeconds)
+			stats.maxWaitSeconds = seconds;
+	}
+
+	StreamBuffer(const StreamBuffer &);
+	StreamBuffer &operator=(const StreamBuffer &);
+};
+
+#endif
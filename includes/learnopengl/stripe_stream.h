@@ -0,0 +1,242 @@
+#ifndef STRIPE_STREAM_H
+#define STRIPE_STREAM_H
+
+#include <glad/glad.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+#include "texture_storage.h"
+
+// produces an image as horizontal stripes, top row first, so it never has to
+// be held in memory as a whole
+class StripeSource {
+public:
+	int width;
+	int height;
+	int channels;
+
+	StripeSource() : width(0), height(0), channels(0) {}
+	virtual ~StripeSource() {}
+
+	// write rows [y, y + rows) tightly packed into dst, false on error
+	virtual bool read(unsigned char *dst, int y, int rows) = 0;
+};
+
+// binary PGM (P5) / PPM (P6) with 8-bit samples, read row by row from disk
+class PnmStripeSource : public StripeSource {
+public:
+	PnmStripeSource(const char *path) : file(NULL)
+	{
+		file = fopen(path, "rb");
+		if (!file)
+			return;
+		char magic[3] = { 0, 0, 0 };
+		int maxValue = 0;
+		if (fread(magic, 1, 2, file) != 2 || magic[0] != 'P' || (magic[1] != '5' && magic[1] != '6')
+			|| !readHeaderInt(width) || !readHeaderInt(height) || !readHeaderInt(maxValue) || maxValue > 255)
+		{
+			fclose(file);
+			file = NULL;
+			width = height = 0;
+			return;
+		}
+		channels = magic[1] == '5' ? 1 : 3;
+	}
+
+	~PnmStripeSource()
+	{
+		if (file)
+			fclose(file);
+	}
+
+	bool valid() const
+	{
+		return file != NULL;
+	}
+
+	bool read(unsigned char *dst, int y, int rows)
+	{
+		size_t bytes = (size_t)width * channels * rows;
+		return file && fread(dst, 1, bytes, file) == bytes;
+	}
+
+private:
+	FILE *file;
+
+	// header fields are separated by whitespace and may be interleaved with comments,
+	// a single whitespace character ends the header
+	bool readHeaderInt(int &value)
+	{
+		int c = fgetc(file);
+		while (c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '#')
+		{
+			if (c == '#')
+				while (c != '\n' && c != EOF)
+					c = fgetc(file);
+			c = fgetc(file);
+		}
+		if (c < '0' || c > '9')
+			return false;
+		value = 0;
+		while (c >= '0' && c <= '9')
+		{
+			value = value * 10 + (c - '0');
+			c = fgetc(file);
+		}
+		return true;
+	}
+};
+
+// statistics of one streamed upload
+struct StripeStats {
+	int stripes;
+	size_t peakHostBytes;	// bytes held in stripe buffers
+	size_t imageBytes;	// bytes the fully decoded image would take
+	double decodeWait;	// seconds the GL thread waited for stripes
+};
+
+// create an immutable texture and fill it stripe by stripe: a worker thread
+// decodes into a bounded ring of stripe buffers while the calling (GL) thread
+// uploads finished stripes with glTexSubImage2D, so peak host memory is
+// ringSize * stripeRows rows instead of the whole image.
+// three channel sources are widened to RGBA8 by the worker. returns 0 on failure
+inline unsigned int streamTexture2D(StripeSource &source, int stripeRows = 64, int ringSize = 3,
+	bool flipVertically = true, bool mipmaps = true, StripeStats *stats = NULL)
+{
+	if (source.width <= 0 || source.height <= 0 || stripeRows <= 0 || ringSize <= 0)
+		return 0;
+
+	int width = source.width, height = source.height;
+	int uploadChannels = source.channels == 3 ? 4 : source.channels;
+	size_t rowBytes = (size_t)width * uploadChannels;
+	int stripeCount = (height + stripeRows - 1) / stripeRows;
+
+	unsigned int texture = createImmutableTexture2D(NULL, width, height, source.channels, false, mipmaps);
+
+	struct Slot {
+		std::vector<unsigned char> pixels;
+		int y;
+		int rows;
+		bool full;
+	};
+	std::vector<Slot> ring(ringSize);
+	for (int i = 0; i < ringSize; i++)
+	{
+		ring[i].pixels.resize(rowBytes * stripeRows);
+		ring[i].full = false;
+	}
+	std::mutex mutex;
+	std::condition_variable changed;
+	bool failed = false;
+
+	// decoder: fills free slots in order
+	std::thread decoder([&]() {
+		std::vector<unsigned char> packed(source.channels == 3 ? (size_t)width * 3 * stripeRows : 0);
+		for (int s = 0; s < stripeCount; s++)
+		{
+			Slot &slot = ring[s % ringSize];
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				changed.wait(lock, [&]() { return !slot.full; });
+			}
+			int y = s * stripeRows;
+			int rows = height - y < stripeRows ? height - y : stripeRows;
+			unsigned char *dst = source.channels == 3 ? &packed[0] : &slot.pixels[0];
+			bool ok = source.read(dst, y, rows);
+			if (ok && source.channels == 3)
+			{
+				for (size_t i = 0, n = (size_t)width * rows; i < n; i++)
+				{
+					slot.pixels[i * 4 + 0] = packed[i * 3 + 0];
+					slot.pixels[i * 4 + 1] = packed[i * 3 + 1];
+					slot.pixels[i * 4 + 2] = packed[i * 3 + 2];
+					slot.pixels[i * 4 + 3] = 255;
+				}
+			}
+			// GL's first row is the bottom one, mirror the rows within the stripe
+			if (ok && flipVertically)
+			{
+				std::vector<unsigned char> tmp(rowBytes);
+				for (int r = 0; r < rows / 2; r++)
+				{
+					unsigned char *a = &slot.pixels[r * rowBytes], *b = &slot.pixels[(rows - 1 - r) * rowBytes];
+					memcpy(&tmp[0], a, rowBytes);
+					memcpy(a, b, rowBytes);
+					memcpy(b, &tmp[0], rowBytes);
+				}
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			slot.y = flipVertically ? height - y - rows : y;
+			slot.rows = rows;
+			slot.full = true;
+			if (!ok)
+				failed = true;
+			changed.notify_all();
+			if (!ok)
+				return;
+		}
+	});
+
+	// uploader: the GL thread consumes slots in the same order
+	int alignment;
+	glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	double waited = 0.0;
+	for (int s = 0; s < stripeCount; s++)
+	{
+		Slot &slot = ring[s % ringSize];
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			if (!slot.full)
+			{
+				std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+				changed.wait(lock, [&]() { return slot.full; });
+				waited += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			}
+			if (failed)
+				break;
+		}
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, slot.y, width, slot.rows, uploadFormat(source.channels),
+			GL_UNSIGNED_BYTE, &slot.pixels[0]);
+		// the data has been copied by the driver once glTexSubImage2D returns
+		std::lock_guard<std::mutex> lock(mutex);
+		slot.full = false;
+		changed.notify_all();
+	}
+	glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+
+	// let a decoder blocked on a full ring run to its failure exit
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (int i = 0; i < ringSize; i++)
+			ring[i].full = false;
+		changed.notify_all();
+	}
+	decoder.join();
+
+	if (failed)
+	{
+		glDeleteTextures(1, &texture);
+		return 0;
+	}
+	if (mipmaps)
+		glGenerateMipmap(GL_TEXTURE_2D);
+
+	if (stats)
+	{
+		stats->stripes = stripeCount;
+		stats->peakHostBytes = rowBytes * stripeRows * ringSize
+			+ (source.channels == 3 ? (size_t)width * 3 * stripeRows : 0);
+		stats->imageBytes = (size_t)width * height * source.channels;
+		stats->decodeWait = waited;
+	}
+	return texture;
+}
+
+#endif
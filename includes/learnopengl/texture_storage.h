@@ -0,0 +1,162 @@
+#ifndef TEXTURE_STORAGE_H
+#define TEXTURE_STORAGE_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <string>
+#include <iostream>
+
+// memory queries exposed by some drivers, glad is generated without extensions
+#define TEXTURE_STORAGE_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX 0x9049
+#define TEXTURE_STORAGE_TEXTURE_FREE_MEMORY_ATI 0x87FC
+
+// number of levels in a full mip chain down to 1x1
+inline int mipLevelCount(int width, int height)
+{
+	int size = width > height ? width : height;
+	int levels = 1;
+	while (size > 1)
+	{
+		size >>= 1;
+		levels++;
+	}
+	return levels;
+}
+
+// internal format the GPU stores natively for the given channel count,
+// three channel images are widened to four since RGB8 is usually emulated
+inline GLenum nativeInternalFormat(int channels, bool srgb)
+{
+	switch (channels)
+	{
+	case 1:  return GL_R8;
+	case 2:  return GL_RG8;
+	default: return srgb ? GL_SRGB8_ALPHA8 : GL_RGBA8;
+	}
+}
+
+inline GLenum uploadFormat(int channels)
+{
+	switch (channels)
+	{
+	case 1:  return GL_RED;
+	case 2:  return GL_RG;
+	default: return GL_RGBA;
+	}
+}
+
+// allocate the complete level chain up front and upload level 0 into it.
+// uses immutable storage (glTexStorage2D) when the context has it, otherwise
+// every level is allocated explicitly and GL_TEXTURE_MAX_LEVEL is pinned so
+// the driver never has to guess the final chain or reallocate.
+// the texture is left bound to GL_TEXTURE_2D on the active unit
+inline unsigned int createImmutableTexture2D(const unsigned char *data, int width, int height, int channels,
+	bool srgb = false, bool mipmaps = true)
+{
+	int levels = mipmaps ? mipLevelCount(width, height) : 1;
+	GLenum internalFormat = nativeInternalFormat(channels, srgb);
+	GLenum format = uploadFormat(channels);
+
+	// widen RGB to RGBA on the CPU so the upload needs no driver conversion
+	std::vector<unsigned char> widened;
+	if (channels == 3 && data)
+	{
+		widened.resize((size_t)width * height * 4);
+		for (size_t i = 0, n = (size_t)width * height; i < n; i++)
+		{
+			widened[i * 4 + 0] = data[i * 3 + 0];
+			widened[i * 4 + 1] = data[i * 3 + 1];
+			widened[i * 4 + 2] = data[i * 3 + 2];
+			widened[i * 4 + 3] = 255;
+		}
+		data = &widened[0];
+	}
+
+	unsigned int texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	if (GLAD_GL_VERSION_4_2)
+	{
+		glTexStorage2D(GL_TEXTURE_2D, levels, internalFormat, width, height);
+	}
+	else
+	{
+		int w = width, h = height;
+		for (int level = 0; level < levels; level++)
+		{
+			glTexImage2D(GL_TEXTURE_2D, level, internalFormat, w, h, 0, format, GL_UNSIGNED_BYTE, NULL);
+			w = w > 1 ? w / 2 : 1;
+			h = h > 1 ? h / 2 : 1;
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+	}
+
+	if (data)
+	{
+		int alignment;
+		glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, alignment);
+		if (levels > 1)
+			glGenerateMipmap(GL_TEXTURE_2D);
+	}
+
+	// without mipmaps the default min filter would leave the texture incomplete
+	if (levels == 1)
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+
+	return texture;
+}
+
+// size of the texture as laid out by the driver, summed over all levels
+// from the component sizes it reports for each of them
+inline size_t textureMemoryBytes(unsigned int texture)
+{
+	glBindTexture(GL_TEXTURE_2D, texture);
+	size_t bytes = 0;
+	for (int level = 0; ; level++)
+	{
+		int w = 0, h = 0;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &w);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &h);
+		if (w == 0 || h == 0)
+			break;
+		int r, g, b, a;
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_RED_SIZE, &r);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_GREEN_SIZE, &g);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_BLUE_SIZE, &b);
+		glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_ALPHA_SIZE, &a);
+		bytes += (size_t)w * h * (r + g + b + a) / 8;
+	}
+	return bytes;
+}
+
+inline bool hasExtension(const char *name)
+{
+	int count = 0;
+	glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+	for (int i = 0; i < count; i++)
+	{
+		const char *ext = (const char*)glGetStringi(GL_EXTENSIONS, i);
+		if (ext && std::string(ext) == name)
+			return true;
+	}
+	return false;
+}
+
+// free video memory in KB as reported by the driver, -1 when it has no such query
+inline int driverFreeTextureMemoryKB()
+{
+	int value[4] = { -1, -1, -1, -1 };
+	if (hasExtension("GL_NVX_gpu_memory_info"))
+		glGetIntegerv(TEXTURE_STORAGE_GPU_MEMORY_INFO_CURRENT_AVAILABLE_VIDMEM_NVX, value);
+	else if (hasExtension("GL_ATI_meminfo"))
+		glGetIntegerv(TEXTURE_STORAGE_TEXTURE_FREE_MEMORY_ATI, value);
+	return value[0];
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+// fixed set of worker threads for data parallel CPU work. GL calls must stay
+// on the thread that owns the context, so tasks run here never touch GL
+class ThreadPool {
+public:
+	// 0 uses one thread per hardware core, the calling thread counts as one of them
+	ThreadPool(int threads = 0) : stopping(false)
+	{
+		if (threads <= 0)
+			threads = (int)std::thread::hardware_concurrency();
+		if (threads <= 0)
+			threads = 1;
+		for (int i = 0; i < threads - 1; i++)
+			workers.push_back(std::thread(&ThreadPool::work, this));
+	}
+
+	~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+			wake.notify_all();
+		}
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i].join();
+	}
+
+	// threads taking part in parallelFor, including the caller
+	int size() const
+	{
+		return (int)workers.size() + 1;
+	}
+
+	// call body(begin, end) on disjoint ranges covering [0, count) and return when
+	// all of them finished. ranges are multiples of 'grain' so SIMD loops can
+	// assume aligned chunk starts
+	void parallelFor(int count, const std::function<void(int, int)> &body, int grain = 1)
+	{
+		if (count <= 0)
+			return;
+		int chunks = size() * 4;
+		int chunk = (count + chunks - 1) / chunks;
+		chunk = (chunk + grain - 1) / grain * grain;
+		if (workers.empty() || chunk >= count)
+		{
+			body(0, count);
+			return;
+		}
+
+		int pending = 0;
+		std::mutex doneMutex;
+		std::condition_variable done;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			for (int begin = 0; begin < count; begin += chunk)
+			{
+				int end = begin + chunk < count ? begin + chunk : count;
+				pending++;
+				tasks.push_back([&, begin, end]() {
+					body(begin, end);
+					std::lock_guard<std::mutex> lock(doneMutex);
+					if (--pending == 0)
+						done.notify_all();
+				});
+			}
+			wake.notify_all();
+		}
+
+		// help with the queue instead of idling
+		while (runOne())
+			;
+		std::unique_lock<std::mutex> lock(doneMutex);
+		done.wait(lock, [&]() { return pending == 0; });
+	}
+
+	// process wide pool shared by the helpers that need one
+	static ThreadPool &shared()
+	{
+		static ThreadPool pool;
+		return pool;
+	}
+
+private:
+	std::vector<std::thread> workers;
+	std::deque<std::function<void()> > tasks;
+	std::mutex mutex;
+	std::condition_variable wake;
+	bool stopping;
+
+	bool runOne()
+	{
+		std::function<void()> task;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (tasks.empty())
+				return false;
+			task = tasks.front();
+			tasks.pop_front();
+		}
+		task();
+		return true;
+	}
+
+	void work()
+	{
+		while (true)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				wake.wait(lock, [this]() { return stopping || !tasks.empty(); });
+				if (stopping && tasks.empty())
+					return;
+				task = tasks.front();
+				tasks.pop_front();
+			}
+			task();
+		}
+	}
+
+	ThreadPool(const ThreadPool &);
+	ThreadPool &operator=(const ThreadPool &);
+};
+
+#endif
@@ -0,0 +1,336 @@
+#ifndef VERTEX_LAYOUT_H
+#define VERTEX_LAYOUT_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <iostream>
+#include <type_traits>
+
+// vertex layouts described once next to the vertex struct:
+//
+//   struct Vertex { glm::vec3 position; UNorm8x4 color; };
+//   typedef VertexLayout<Vertex,
+//       VERTEX_ATTRIB(Vertex, position, 0),
+//       VERTEX_ATTRIB(Vertex, color, 1)> Layout;
+//   Layout::apply();	// glVertexAttribPointer for every attribute, VAO and VBO bound
+//
+// stride, offsets, component count and GL type come from the struct. overlapping
+// or misaligned attributes and duplicate locations fail to compile; the inputs a
+// shader expects can be checked at compile time with ShaderInput lists and at
+// runtime against the linked program with Layout::validate(program)
+
+// packed attribute types
+struct Half2 { unsigned short x, y; };
+struct Half4 { unsigned short x, y, z, w; };
+struct SNorm16x2 { short x, y; };
+struct SNorm16x4 { short x, y, z, w; };
+struct UNorm16x4 { unsigned short x, y, z, w; };
+struct UNorm8x4 { unsigned char x, y, z, w; };
+struct SNorm1010102 { unsigned int bits; };	// xyz signed 10 bit, w signed 2 bit, normalized
+struct UNorm1010102 { unsigned int bits; };	// xyz unsigned 10 bit, w unsigned 2 bit, normalized
+
+// IEEE half precision, round to nearest even, overflow to infinity
+inline unsigned short packHalf(float value)
+{
+	unsigned int f;
+	memcpy(&f, &value, 4);
+	unsigned int sign = (f >> 16) & 0x8000;
+	int exponent = (int)((f >> 23) & 0xff) - 127 + 15;
+	unsigned int mantissa = f & 0x7fffff;
+	if (((f >> 23) & 0xff) == 0xff)
+		return (unsigned short)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+	if (exponent >= 31)
+		return (unsigned short)(sign | 0x7c00);
+	if (exponent <= 0)
+	{
+		// denormal or zero
+		if (exponent < -10)
+			return (unsigned short)sign;
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		unsigned int half = mantissa >> shift;
+		unsigned int rest = mantissa & ((1u << shift) - 1), midpoint = 1u << (shift - 1);
+		if (rest > midpoint || (rest == midpoint && (half & 1)))
+			half++;
+		return (unsigned short)(sign | half);
+	}
+	unsigned int half = sign | ((unsigned int)exponent << 10) | (mantissa >> 13);
+	unsigned int rest = mantissa & 0x1fff;
+	if (rest > 0x1000 || (rest == 0x1000 && (half & 1)))
+		half++;	// may carry into the exponent, which rounds up to the next power of two correctly
+	return (unsigned short)half;
+}
+
+inline float clampUnit(float v, float low)
+{
+	return v < low ? low : (v > 1.0f ? 1.0f : v);
+}
+
+inline short packSNorm16(float v)
+{
+	return (short)floorf(clampUnit(v, -1.0f) * 32767.0f + 0.5f);
+}
+
+inline unsigned short packUNorm16(float v)
+{
+	return (unsigned short)(clampUnit(v, 0.0f) * 65535.0f + 0.5f);
+}
+
+inline unsigned char packUNorm8(float v)
+{
+	return (unsigned char)(clampUnit(v, 0.0f) * 255.0f + 0.5f);
+}
+
+inline Half2 makeHalf2(float x, float y)
+{
+	Half2 h = { packHalf(x), packHalf(y) };
+	return h;
+}
+
+inline Half4 makeHalf4(float x, float y, float z, float w = 1.0f)
+{
+	Half4 h = { packHalf(x), packHalf(y), packHalf(z), packHalf(w) };
+	return h;
+}
+
+inline SNorm16x2 makeSNorm16x2(float x, float y)
+{
+	SNorm16x2 s = { packSNorm16(x), packSNorm16(y) };
+	return s;
+}
+
+inline SNorm16x4 makeSNorm16x4(float x, float y, float z, float w = 1.0f)
+{
+	SNorm16x4 s = { packSNorm16(x), packSNorm16(y), packSNorm16(z), packSNorm16(w) };
+	return s;
+}
+
+inline UNorm16x4 makeUNorm16x4(float x, float y, float z, float w = 1.0f)
+{
+	UNorm16x4 u = { packUNorm16(x), packUNorm16(y), packUNorm16(z), packUNorm16(w) };
+	return u;
+}
+
+inline UNorm8x4 makeUNorm8x4(float x, float y, float z, float w = 1.0f)
+{
+	UNorm8x4 u = { packUNorm8(x), packUNorm8(y), packUNorm8(z), packUNorm8(w) };
+	return u;
+}
+
+// w of the signed format can only be -1, 0 or 1
+inline SNorm1010102 makeSNorm1010102(float x, float y, float z, float w = 0.0f)
+{
+	int c[3] = { (int)floorf(clampUnit(x, -1.0f) * 511.0f + 0.5f), (int)floorf(clampUnit(y, -1.0f) * 511.0f + 0.5f),
+		(int)floorf(clampUnit(z, -1.0f) * 511.0f + 0.5f) };
+	int a = (int)floorf(clampUnit(w, -1.0f) + 0.5f);
+	SNorm1010102 s = { ((unsigned int)c[0] & 0x3ff) | (((unsigned int)c[1] & 0x3ff) << 10) |
+		(((unsigned int)c[2] & 0x3ff) << 20) | (((unsigned int)a & 0x3) << 30) };
+	return s;
+}
+
+inline UNorm1010102 makeUNorm1010102(float x, float y, float z, float w = 1.0f)
+{
+	UNorm1010102 u = { (unsigned int)(clampUnit(x, 0.0f) * 1023.0f + 0.5f) |
+		((unsigned int)(clampUnit(y, 0.0f) * 1023.0f + 0.5f) << 10) |
+		((unsigned int)(clampUnit(z, 0.0f) * 1023.0f + 0.5f) << 20) |
+		((unsigned int)(clampUnit(w, 0.0f) * 3.0f + 0.5f) << 30) };
+	return u;
+}
+
+// how each C++ member type is fed to the vertex shader
+template <typename T> struct VertexAttribFormat;
+
+#define VERTEX_ATTRIB_FORMAT(T, count, glType, norm, isInteger) \
+	template <> struct VertexAttribFormat<T> { \
+		static const int components = count; \
+		static const GLenum type = glType; \
+		static const bool normalized = norm; \
+		static const bool integer = isInteger; \
+	}
+
+VERTEX_ATTRIB_FORMAT(float, 1, GL_FLOAT, false, false);
+VERTEX_ATTRIB_FORMAT(glm::vec2, 2, GL_FLOAT, false, false);
+VERTEX_ATTRIB_FORMAT(glm::vec3, 3, GL_FLOAT, false, false);
+VERTEX_ATTRIB_FORMAT(glm::vec4, 4, GL_FLOAT, false, false);
+VERTEX_ATTRIB_FORMAT(int, 1, GL_INT, false, true);
+VERTEX_ATTRIB_FORMAT(unsigned int, 1, GL_UNSIGNED_INT, false, true);
+VERTEX_ATTRIB_FORMAT(glm::ivec4, 4, GL_INT, false, true);
+VERTEX_ATTRIB_FORMAT(glm::uvec4, 4, GL_UNSIGNED_INT, false, true);
+VERTEX_ATTRIB_FORMAT(Half2, 2, GL_HALF_FLOAT, false, false);
+VERTEX_ATTRIB_FORMAT(Half4, 4, GL_HALF_FLOAT, false, false);
+VERTEX_ATTRIB_FORMAT(SNorm16x2, 2, GL_SHORT, true, false);
+VERTEX_ATTRIB_FORMAT(SNorm16x4, 4, GL_SHORT, true, false);
+VERTEX_ATTRIB_FORMAT(UNorm16x4, 4, GL_UNSIGNED_SHORT, true, false);
+VERTEX_ATTRIB_FORMAT(UNorm8x4, 4, GL_UNSIGNED_BYTE, true, false);
+VERTEX_ATTRIB_FORMAT(SNorm1010102, 4, GL_INT_2_10_10_10_REV, true, false);
+VERTEX_ATTRIB_FORMAT(UNorm1010102, 4, GL_UNSIGNED_INT_2_10_10_10_REV, true, false);
+
+#undef VERTEX_ATTRIB_FORMAT
+
+// one attribute: member type, byte offset in the vertex and shader location
+template <typename T, size_t Offset, GLuint Location>
+struct VertexAttrib {
+	typedef VertexAttribFormat<T> Format;
+	static const size_t offset = Offset;
+	static const size_t size = sizeof(T);
+	static const GLuint location = Location;
+	static const int components = Format::components;
+	static const bool integer = Format::integer;
+
+	static_assert(Offset % 4 == 0, "vertex attribute offsets must be multiples of 4 bytes");
+	static_assert(Location < 16, "vertex attribute location beyond the minimum GL_MAX_VERTEX_ATTRIBS");
+
+	static void apply(GLsizei stride)
+	{
+		if (integer)
+			glVertexAttribIPointer(Location, components, Format::type, stride, (void*)Offset);
+		else
+			glVertexAttribPointer(Location, components, Format::type, Format::normalized ? GL_TRUE : GL_FALSE,
+				stride, (void*)Offset);
+		glEnableVertexAttribArray(Location);
+	}
+};
+
+#define VERTEX_ATTRIB(Vertex, member, location) \
+	VertexAttrib<decltype(Vertex::member), offsetof(Vertex, member), location>
+
+// what a vertex shader declares as input, e.g. ShaderInput<0, 3> for
+// "layout(location = 0) in vec3 aPos"
+template <GLuint Location, int Components, bool Integer = false>
+struct ShaderInput {
+	static const GLuint location = Location;
+	static const int components = Components;
+	static const bool integer = Integer;
+};
+
+// compile time queries over a list of attributes
+template <GLuint Location, typename... Attribs>
+struct VertexAttribFind {
+	static const bool found = false;
+	static const bool integer = false;
+};
+
+template <GLuint Location, typename Head, typename... Tail>
+struct VertexAttribFind<Location, Head, Tail...> {
+	static const bool match = Head::location == Location;
+	static const bool found = match || VertexAttribFind<Location, Tail...>::found;
+	static const bool integer = match ? Head::integer : VertexAttribFind<Location, Tail...>::integer;
+};
+
+// no two attributes share a location or overlap in memory
+template <typename A, typename... Others>
+struct VertexAttribDisjoint {
+	static const bool value = true;
+};
+
+template <typename A, typename B, typename... Others>
+struct VertexAttribDisjoint<A, B, Others...> {
+	static const bool value = A::location != B::location &&
+		(A::offset + A::size <= B::offset || B::offset + B::size <= A::offset) &&
+		VertexAttribDisjoint<A, Others...>::value;
+};
+
+template <typename... Attribs>
+struct VertexAttribsValid {
+	static const bool disjoint = true;
+	static const size_t end = 0;
+};
+
+template <typename Head, typename... Tail>
+struct VertexAttribsValid<Head, Tail...> {
+	static const bool disjoint = VertexAttribDisjoint<Head, Tail...>::value && VertexAttribsValid<Tail...>::disjoint;
+	static const size_t end = Head::offset + Head::size > VertexAttribsValid<Tail...>::end ?
+		Head::offset + Head::size : VertexAttribsValid<Tail...>::end;
+};
+
+template <typename Vertex, typename... Attribs>
+struct VertexLayout {
+	static const GLsizei stride = sizeof(Vertex);
+
+	static_assert(std::is_standard_layout<Vertex>::value, "vertex structs must be standard layout for offsetof");
+	static_assert(sizeof...(Attribs) > 0, "a vertex layout needs at least one attribute");
+	static_assert(VertexAttribsValid<Attribs...>::disjoint, "vertex attributes overlap or share a location");
+	static_assert(VertexAttribsValid<Attribs...>::end <= sizeof(Vertex), "vertex attribute extends past the vertex");
+
+	// true when the layout feeds every listed shader input with the right kind of data.
+	// fewer components than the shader reads are fine, GL fills in (0, 0, 0, 1)
+	template <typename... Inputs>
+	struct Feeds {
+		static const bool value = true;
+	};
+
+	template <typename Input, typename... Inputs>
+	struct Feeds<Input, Inputs...> {
+		static const bool value = VertexAttribFind<Input::location, Attribs...>::found &&
+			VertexAttribFind<Input::location, Attribs...>::integer == Input::integer && Feeds<Inputs...>::value;
+	};
+
+	// set up all attributes for the bound VAO from the bound GL_ARRAY_BUFFER
+	static void apply()
+	{
+		int expand[] = { 0, (Attribs::apply(stride), 0)... };
+		(void)expand;
+	}
+
+	// compare against the active attributes of a linked program
+	static bool validate(unsigned int program)
+	{
+		int count = 0;
+		glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &count);
+		bool valid = true;
+		for (int i = 0; i < count; i++)
+		{
+			char name[256];
+			GLint size;
+			GLenum type;
+			glGetActiveAttrib(program, (GLuint)i, sizeof(name), NULL, &size, &type, name);
+			int location = glGetAttribLocation(program, name);
+			if (location < 0)
+				continue;	// built-ins like gl_VertexID
+			bool integer = isIntegerType(type);
+			bool found = false;
+			int expand[] = { 0, (check<Attribs>(location, integer, found, valid), 0)... };
+			(void)expand;
+			if (!found)
+			{
+				std::cout << "ERROR::VERTEX_LAYOUT::MISSING_ATTRIBUTE " << name << " (location " << location << ")" << std::endl;
+				valid = false;
+			}
+		}
+		return valid;
+	}
+
+private:
+	template <typename A>
+	static void check(int location, bool integer, bool &found, bool &valid)
+	{
+		if ((int)A::location != location)
+			return;
+		found = true;
+		if (A::integer != integer)
+		{
+			std::cout << "ERROR::VERTEX_LAYOUT::TYPE_MISMATCH location " << location
+				<< (integer ? ": shader expects integers" : ": shader expects floats") << std::endl;
+			valid = false;
+		}
+	}
+
+	static bool isIntegerType(GLenum type)
+	{
+		switch (type)
+		{
+		case GL_INT: case GL_INT_VEC2: case GL_INT_VEC3: case GL_INT_VEC4:
+		case GL_UNSIGNED_INT: case GL_UNSIGNED_INT_VEC2: case GL_UNSIGNED_INT_VEC3: case GL_UNSIGNED_INT_VEC4:
+			return true;
+		default:
+			return false;
+		}
+	}
+};
+
+#endif
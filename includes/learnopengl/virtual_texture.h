@@ -0,0 +1,515 @@
+#ifndef VIRTUAL_TEXTURE_H
+#define VIRTUAL_TEXTURE_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+
+// supplies the texels of a virtual texture that is too large to ever be loaded
+// as a whole, e.g. a tiled image on disk or a procedural image
+class VirtualTextureSource {
+public:
+	virtual ~VirtualTextureSource() {}
+	// width and height of mip level 0 in texels, a power of two multiple of the page size
+	virtual int size() const = 0;
+	// write extent x extent RGBA8 texels of mip level 'level' starting at texel (x0, y0).
+	// the region includes page borders and may reach past the image edges,
+	// called from streaming threads so it must not touch GL
+	virtual void read(int level, int x0, int y0, int extent, unsigned char *rgba) = 0;
+};
+
+// software virtual texturing for plain GL 3.3:
+// - a fixed physical page cache texture sized from a memory budget
+// - a mipmapped RGBA8UI page table (slot x, slot y, mapped level) per virtual page,
+//   non-resident pages point at their closest resident ancestor
+// - a low resolution feedback pass recording which pages the frame wants,
+//   read back one frame late through pixel buffer objects
+// - streaming threads producing page texels, uploaded by the GL thread
+//   within a per-frame upload limit and an LRU replacement policy
+class VirtualTexture {
+public:
+	static const int PAGE = 128;
+	static const int BORDER = 4;
+	static const int SLOT = PAGE + 2 * BORDER;
+
+	unsigned int physicalTexture;
+	unsigned int pageTableTexture;
+	int levels;
+	int pages;		// pages per side at level 0
+	int slotsPerSide;
+	int feedbackWidth, feedbackHeight;
+
+	// statistics, frame values are reset by update()
+	unsigned int framePagesRequested;
+	unsigned int frameUploads;
+	unsigned int frameEvictions;
+	unsigned int totalUploads;
+	unsigned int totalEvictions;
+
+	VirtualTexture(VirtualTextureSource &src, size_t budgetBytes, int fbWidth = 128, int fbHeight = 96,
+		int uploadsPerFrame = 8, int workerCount = 2)
+		: physicalTexture(0), pageTableTexture(0), feedbackWidth(fbWidth), feedbackHeight(fbHeight),
+		framePagesRequested(0), frameUploads(0), frameEvictions(0), totalUploads(0), totalEvictions(0),
+		source(src), maxUploads(uploadsPerFrame < 1 ? 1 : uploadsPerFrame), frame(0), feedbackFrames(0), inFlight(0), stopping(false)
+	{
+		pages = source.size() / PAGE;
+		levels = 1;
+		while ((pages >> (levels - 1)) > 1)
+			levels++;
+
+		// physical cache: as many slots as fit in the budget, capped by the texture size limit
+		int maxSize;
+		glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+		slotsPerSide = 1;
+		while ((size_t)(slotsPerSide + 1) * SLOT * (slotsPerSide + 1) * SLOT * 4 <= budgetBytes
+			&& (slotsPerSide + 1) * SLOT <= maxSize && (slotsPerSide + 1) <= 255)
+			slotsPerSide++;
+		int physicalSize = slotsPerSide * SLOT;
+
+		glGenTextures(1, &physicalTexture);
+		glBindTexture(GL_TEXTURE_2D, physicalTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, physicalSize, physicalSize, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+		// page table: one RGBA8UI texel per page and level
+		glGenTextures(1, &pageTableTexture);
+		glBindTexture(GL_TEXTURE_2D, pageTableTexture);
+		table.resize(levels);
+		slotOf.resize(levels);
+		dirty.resize(levels);
+		for (int level = 0; level < levels; level++)
+		{
+			int n = pagesAt(level);
+			table[level].assign((size_t)n * n * 4, 0);
+			slotOf[level].assign((size_t)n * n, -1);
+			dirty[level] = Rect();
+			glTexImage2D(GL_TEXTURE_2D, level, GL_RGBA8UI, n, n, 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, NULL);
+		}
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levels - 1);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		slots.resize((size_t)slotsPerSide * slotsPerSide);
+		for (int i = (int)slots.size() - 1; i >= 0; i--)
+			freeSlots.push_back(i);
+
+		// feedback target and the two pixel buffers it is read back through
+		glGenFramebuffers(1, &feedbackFBO);
+		glGenTextures(1, &feedbackTexture);
+		glBindTexture(GL_TEXTURE_2D, feedbackTexture);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA16UI, feedbackWidth, feedbackHeight, 0, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, NULL);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glGenRenderbuffers(1, &feedbackDepth);
+		glBindRenderbuffer(GL_RENDERBUFFER, feedbackDepth);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, feedbackWidth, feedbackHeight);
+		glBindFramebuffer(GL_FRAMEBUFFER, feedbackFBO);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, feedbackTexture, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, feedbackDepth);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			std::cout << "ERROR::VIRTUAL_TEXTURE::FEEDBACK_FRAMEBUFFER_INCOMPLETE" << std::endl;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glGenBuffers(2, feedbackPBO);
+		for (int i = 0; i < 2; i++)
+		{
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, feedbackPBO[i]);
+			glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)feedbackWidth * feedbackHeight * 8, NULL, GL_STREAM_READ);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		// the single top level page is always resident so every lookup resolves
+		std::vector<unsigned char> texels((size_t)SLOT * SLOT * 4);
+		source.read(levels - 1, -BORDER, -BORDER, SLOT, &texels[0]);
+		int slot = allocateSlot();
+		slots[slot].locked = true;
+		uploadPage(levels - 1, 0, 0, slot, &texels[0]);
+		uploadPageTable();
+
+		for (int i = 0; i < (workerCount < 1 ? 1 : workerCount); i++)
+			workers.push_back(std::thread(&VirtualTexture::streamPages, this));
+	}
+
+	~VirtualTexture()
+	{
+		stop();
+	}
+
+	// bytes of GPU memory the virtual texture holds, independent of the virtual size
+	size_t residentBytes() const
+	{
+		size_t bytes = (size_t)slotsPerSide * SLOT * slotsPerSide * SLOT * 4;
+		for (int level = 0; level < levels; level++)
+			bytes += (size_t)pagesAt(level) * pagesAt(level) * 4;
+		return bytes;
+	}
+
+	unsigned int residentPages() const
+	{
+		return (unsigned int)(slots.size() - freeSlots.size());
+	}
+
+	unsigned int pendingPages()
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		return (unsigned int)(requests.size() + inFlight);
+	}
+
+	// lod bias the feedback shader adds because it renders at a lower resolution
+	float feedbackBias(int viewportWidth) const
+	{
+		float ratio = (float)viewportWidth / (float)feedbackWidth;
+		float bias = 0.0f;
+		while (ratio > 1.5f)
+		{
+			ratio *= 0.5f;
+			bias += 1.0f;
+		}
+		return bias;
+	}
+
+	// render the feedback pass between these two calls
+	void beginFeedback()
+	{
+		glGetIntegerv(GL_VIEWPORT, savedViewport);
+		glBindFramebuffer(GL_FRAMEBUFFER, feedbackFBO);
+		glViewport(0, 0, feedbackWidth, feedbackHeight);
+		const unsigned int none[4] = { 0, 0, 0, 0 };
+		glClearBufferuiv(GL_COLOR, 0, none);
+		glClear(GL_DEPTH_BUFFER_BIT);
+	}
+
+	void endFeedback()
+	{
+		// asynchronous read back, consumed by the next update()
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, feedbackPBO[feedbackFrames & 1]);
+		glReadPixels(0, 0, feedbackWidth, feedbackHeight, GL_RGBA_INTEGER, GL_UNSIGNED_SHORT, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		feedbackFrames++;
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(savedViewport[0], savedViewport[1], savedViewport[2], savedViewport[3]);
+	}
+
+	// process last frame's feedback, queue missing pages and upload finished ones
+	void update()
+	{
+		frame++;
+		framePagesRequested = 0;
+		frameUploads = 0;
+		frameEvictions = 0;
+
+		if (feedbackFrames >= 2)
+			processFeedback(feedbackPBO[feedbackFrames & 1]);
+
+		std::vector<Page> finished;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			while (!completed.empty() && (int)finished.size() < maxUploads)
+			{
+				finished.push_back(completed.front());
+				completed.pop_front();
+			}
+			if (!finished.empty())
+				wake.notify_all();
+		}
+		for (size_t i = 0; i < finished.size(); i++)
+		{
+			Page &page = finished[i];
+			if (slotOf[page.level][index(page.level, page.x, page.y)] < 0)
+			{
+				int slot = allocateSlot();
+				if (slot >= 0)
+				{
+					uploadPage(page.level, page.x, page.y, slot, &page.texels[0]);
+					frameUploads++;
+					totalUploads++;
+				}
+			}
+			std::lock_guard<std::mutex> lock(mutex);
+			scheduled.erase(key(page.level, page.x, page.y));
+		}
+		uploadPageTable();
+	}
+
+	// bind the page cache and the page table to two texture units
+	void bind(unsigned int physicalUnit, unsigned int tableUnit) const
+	{
+		glActiveTexture(GL_TEXTURE0 + physicalUnit);
+		glBindTexture(GL_TEXTURE_2D, physicalTexture);
+		glActiveTexture(GL_TEXTURE0 + tableUnit);
+		glBindTexture(GL_TEXTURE_2D, pageTableTexture);
+	}
+
+	// stop the streaming threads and free the GL objects, needs a current context
+	void stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+			wake.notify_all();
+		}
+		for (size_t i = 0; i < workers.size(); i++)
+			workers[i].join();
+		workers.clear();
+		if (physicalTexture)
+		{
+			glDeleteTextures(1, &physicalTexture);
+			glDeleteTextures(1, &pageTableTexture);
+			glDeleteTextures(1, &feedbackTexture);
+			glDeleteRenderbuffers(1, &feedbackDepth);
+			glDeleteFramebuffers(1, &feedbackFBO);
+			glDeleteBuffers(2, feedbackPBO);
+			physicalTexture = 0;
+		}
+	}
+
+private:
+	struct Rect {
+		int x0, y0, x1, y1;
+		Rect() : x0(1 << 30), y0(1 << 30), x1(-1), y1(-1) {}
+		bool empty() const { return x1 < x0; }
+		void add(int x, int y)
+		{
+			x0 = std::min(x0, x); y0 = std::min(y0, y);
+			x1 = std::max(x1, x); y1 = std::max(y1, y);
+		}
+	};
+	struct Slot {
+		int level, x, y;
+		unsigned int lastUsed;
+		bool locked;
+		Slot() : level(-1), x(0), y(0), lastUsed(0), locked(false) {}
+	};
+	struct Page {
+		int level, x, y;
+		std::vector<unsigned char> texels;
+	};
+
+	VirtualTextureSource &source;
+	int maxUploads;
+	unsigned int frame;
+	unsigned int feedbackFrames;
+
+	std::vector<std::vector<unsigned char> > table;
+	std::vector<std::vector<int> > slotOf;
+	std::vector<Rect> dirty;
+	std::vector<Slot> slots;
+	std::vector<int> freeSlots;
+
+	unsigned int feedbackFBO, feedbackTexture, feedbackDepth;
+	unsigned int feedbackPBO[2];
+	int savedViewport[4];
+
+	// shared with the streaming threads
+	std::mutex mutex;
+	std::condition_variable wake;
+	std::deque<Page> requests;
+	std::deque<Page> completed;
+	std::unordered_set<unsigned long long> scheduled;
+	int inFlight;
+	bool stopping;
+	std::vector<std::thread> workers;
+
+	int pagesAt(int level) const
+	{
+		int n = pages >> level;
+		return n < 1 ? 1 : n;
+	}
+
+	size_t index(int level, int x, int y) const
+	{
+		return (size_t)y * pagesAt(level) + x;
+	}
+
+	static unsigned long long key(int level, int x, int y)
+	{
+		return ((unsigned long long)level << 48) | ((unsigned long long)y << 24) | (unsigned long long)x;
+	}
+
+	// write a page table entry and hand it down to every non-resident descendant
+	void fill(int level, int x, int y, const unsigned char *entry)
+	{
+		unsigned char *dst = &table[level][index(level, x, y) * 4];
+		dst[0] = entry[0]; dst[1] = entry[1]; dst[2] = entry[2]; dst[3] = entry[3];
+		dirty[level].add(x, y);
+		if (level == 0)
+			return;
+		int child = level - 1;
+		for (int cy = y * 2; cy < y * 2 + 2 && cy < pagesAt(child); cy++)
+			for (int cx = x * 2; cx < x * 2 + 2 && cx < pagesAt(child); cx++)
+				if (slotOf[child][index(child, cx, cy)] < 0)
+					fill(child, cx, cy, entry);
+	}
+
+	void uploadPage(int level, int x, int y, int slot, const unsigned char *texels)
+	{
+		int sx = slot % slotsPerSide, sy = slot / slotsPerSide;
+		glBindTexture(GL_TEXTURE_2D, physicalTexture);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, sx * SLOT, sy * SLOT, SLOT, SLOT, GL_RGBA, GL_UNSIGNED_BYTE, texels);
+
+		slots[slot].level = level;
+		slots[slot].x = x;
+		slots[slot].y = y;
+		slots[slot].lastUsed = frame;
+		slotOf[level][index(level, x, y)] = slot;
+		unsigned char entry[4] = { (unsigned char)sx, (unsigned char)sy, (unsigned char)level, 255 };
+		fill(level, x, y, entry);
+	}
+
+	// free slot, or the least recently used one that the current frame does not need
+	int allocateSlot()
+	{
+		if (!freeSlots.empty())
+		{
+			int slot = freeSlots.back();
+			freeSlots.pop_back();
+			return slot;
+		}
+		int victim = -1;
+		for (size_t i = 0; i < slots.size(); i++)
+			if (!slots[i].locked && slots[i].lastUsed + 1 < frame
+				&& (victim < 0 || slots[i].lastUsed < slots[victim].lastUsed))
+				victim = (int)i;
+		if (victim < 0)
+			return -1;
+
+		// the evicted page falls back to its parent's mapping
+		Slot &old = slots[victim];
+		slotOf[old.level][index(old.level, old.x, old.y)] = -1;
+		fill(old.level, old.x, old.y, &table[old.level + 1][index(old.level + 1, old.x / 2, old.y / 2) * 4]);
+		old.level = -1;
+		frameEvictions++;
+		totalEvictions++;
+		return victim;
+	}
+
+	void uploadPageTable()
+	{
+		glBindTexture(GL_TEXTURE_2D, pageTableTexture);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		for (int level = 0; level < levels; level++)
+		{
+			Rect &r = dirty[level];
+			if (r.empty())
+				continue;
+			glPixelStorei(GL_UNPACK_ROW_LENGTH, pagesAt(level));
+			glPixelStorei(GL_UNPACK_SKIP_PIXELS, r.x0);
+			glPixelStorei(GL_UNPACK_SKIP_ROWS, r.y0);
+			glTexSubImage2D(GL_TEXTURE_2D, level, r.x0, r.y0, r.x1 - r.x0 + 1, r.y1 - r.y0 + 1,
+				GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, &table[level][0]);
+			r = Rect();
+		}
+		glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+		glPixelStorei(GL_UNPACK_SKIP_PIXELS, 0);
+		glPixelStorei(GL_UNPACK_SKIP_ROWS, 0);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+
+	void processFeedback(unsigned int pbo)
+	{
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, pbo);
+		const unsigned short *texels = (const unsigned short*)glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+		std::unordered_set<unsigned long long> seen;
+		std::vector<Page> missing;
+		if (texels)
+		{
+			for (int i = 0, n = feedbackWidth * feedbackHeight; i < n; i++)
+			{
+				const unsigned short *t = texels + i * 4;
+				if (t[3] == 0 || t[2] >= levels)
+					continue;
+				int level = t[2], x = t[0], y = t[1];
+				if (x >= pagesAt(level) || y >= pagesAt(level))
+					continue;
+				// the page and its ancestors are needed, the latter as fallback
+				for (; level < levels; level++, x /= 2, y /= 2)
+				{
+					if (!seen.insert(key(level, x, y)).second)
+						break;
+					int slot = slotOf[level][index(level, x, y)];
+					if (slot >= 0)
+					{
+						slots[slot].lastUsed = frame;
+					}
+					else
+					{
+						Page page;
+						page.level = level;
+						page.x = x;
+						page.y = y;
+						missing.push_back(page);
+					}
+				}
+			}
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		// coarse pages first, they cover the most screen and unblock finer ones
+		std::sort(missing.begin(), missing.end(), [](const Page &a, const Page &b) { return a.level > b.level; });
+		framePagesRequested = (unsigned int)missing.size();
+		std::lock_guard<std::mutex> lock(mutex);
+		for (size_t i = 0; i < missing.size(); i++)
+		{
+			if (!scheduled.insert(key(missing[i].level, missing[i].x, missing[i].y)).second)
+				continue;
+			requests.push_back(missing[i]);
+		}
+		// drop stale requests the view has moved away from, keeping the newest ones
+		size_t limit = slots.size();
+		while (requests.size() > limit)
+		{
+			Page &stale = requests.front();
+			scheduled.erase(key(stale.level, stale.x, stale.y));
+			requests.pop_front();
+		}
+		wake.notify_all();
+	}
+
+	// streaming thread: produce page texels (with borders) for queued requests.
+	// pages being read plus pages waiting for upload never exceed one frame's
+	// upload limit, so finished texels can't pile up faster than update() drains them
+	void streamPages()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while (true)
+		{
+			wake.wait(lock, [this]() {
+				return stopping || (!requests.empty() && inFlight + (int)completed.size() < maxUploads);
+			});
+			if (stopping)
+				return;
+			// serve the coarsest queued page first
+			std::deque<Page>::iterator best = requests.begin();
+			for (std::deque<Page>::iterator it = requests.begin(); it != requests.end(); ++it)
+				if (it->level > best->level)
+					best = it;
+			Page page = *best;
+			requests.erase(best);
+			inFlight++;
+			lock.unlock();
+
+			page.texels.resize((size_t)SLOT * SLOT * 4);
+			source.read(page.level, page.x * PAGE - BORDER, page.y * PAGE - BORDER, SLOT, &page.texels[0]);
+
+			lock.lock();
+			inFlight--;
+			completed.push_back(page);
+		}
+	}
+
+	VirtualTexture(const VirtualTexture &);
+	VirtualTexture &operator=(const VirtualTexture &);
+};
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef YCOCG_TEXTURE_H
+#define YCOCG_TEXTURE_H
+
+#include <glad/glad.h>
+
+#include <vector>
+#include <cmath>
+
+#include "texture_storage.h"
+
+// photographic texture stored as full resolution luma (R8) and half resolution
+// chroma (RG8) planes in the YCoCg color space, 1.5 instead of 4 bytes per texel.
+// the fragment shader reconstructs RGB:
+//   y = luma.r; co = chroma.r - 0.5; cg = chroma.g - 0.5;
+//   rgb = vec3(y - cg + co, y + cg, y - cg - co);
+struct YCoCgTexture {
+	unsigned int luma;
+	unsigned int chroma;
+	int width;
+	int height;
+};
+
+// split an RGB(A) image into the two planes, chroma is averaged over 2x2 blocks.
+// co and cg are stored halved and biased by 0.5 so they fit an unsigned byte
+inline void splitYCoCg(const unsigned char *data, int width, int height, int channels,
+	std::vector<unsigned char> &luma, std::vector<unsigned char> &chroma)
+{
+	int cw = (width + 1) / 2, ch = (height + 1) / 2;
+	luma.resize((size_t)width * height);
+	chroma.resize((size_t)cw * ch * 2);
+	std::vector<float> co((size_t)cw * ch, 0.0f), cg((size_t)cw * ch, 0.0f), count((size_t)cw * ch, 0.0f);
+	for (int y = 0; y < height; y++)
+	{
+		for (int x = 0; x < width; x++)
+		{
+			const unsigned char *p = data + ((size_t)y * width + x) * channels;
+			float r = p[0], g = p[1], b = p[2];
+			luma[(size_t)y * width + x] = (unsigned char)(0.25f * r + 0.5f * g + 0.25f * b + 0.5f);
+			size_t c = (size_t)(y / 2) * cw + x / 2;
+			co[c] += 0.5f * (r - b);
+			cg[c] += 0.25f * (2.0f * g - r - b);
+			count[c] += 1.0f;
+		}
+	}
+	for (size_t c = 0; c < co.size(); c++)
+	{
+		float vco = co[c] / count[c] + 127.5f, vcg = cg[c] / count[c] + 127.5f;
+		chroma[c * 2 + 0] = (unsigned char)(vco < 0.0f ? 0.0f : (vco > 255.0f ? 255.0f : vco + 0.5f));
+		chroma[c * 2 + 1] = (unsigned char)(vcg < 0.0f ? 0.0f : (vcg > 255.0f ? 255.0f : vcg + 0.5f));
+	}
+}
+
+// create the luma and chroma textures (immutable, mipmapped) from an RGB(A) image
+inline YCoCgTexture createYCoCgTexture(const unsigned char *data, int width, int height, int channels)
+{
+	std::vector<unsigned char> luma, chroma;
+	splitYCoCg(data, width, height, channels, luma, chroma);
+
+	YCoCgTexture texture;
+	texture.width = width;
+	texture.height = height;
+	texture.luma = createImmutableTexture2D(&luma[0], width, height, 1);
+	texture.chroma = createImmutableTexture2D(&chroma[0], (width + 1) / 2, (height + 1) / 2, 2);
+	// wrapping would bleed the opposite edge's chroma into the border texels
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	return texture;
+}
+
+// reconstruct RGB on the CPU the way the shader does (bilinear chroma), for quality checks
+inline void reconstructYCoCg(const std::vector<unsigned char> &luma, const std::vector<unsigned char> &chroma,
+	int width, int height, std::vector<unsigned char> &rgb)
+{
+	int cw = (width + 1) / 2, ch = (height + 1) / 2;
+	rgb.resize((size_t)width * height * 3);
+	for (int y = 0; y < height; y++)
+	{
+		// texel centre of (x, y) in chroma texel space, clamped to the edge like GL_CLAMP_TO_EDGE
+		float fy = (y + 0.5f) * 0.5f - 0.5f;
+		fy = fy < 0.0f ? 0.0f : (fy > ch - 1 ? (float)(ch - 1) : fy);
+		int y0 = (int)fy, y1 = y0 + 1 < ch ? y0 + 1 : y0;
+		float ty = fy - y0;
+		for (int x = 0; x < width; x++)
+		{
+			float fx = (x + 0.5f) * 0.5f - 0.5f;
+			fx = fx < 0.0f ? 0.0f : (fx > cw - 1 ? (float)(cw - 1) : fx);
+			int x0 = (int)fx, x1 = x0 + 1 < cw ? x0 + 1 : x0;
+			float tx = fx - x0;
+			float c[2];
+			for (int k = 0; k < 2; k++)
+			{
+				float a = chroma[((size_t)y0 * cw + x0) * 2 + k] * (1 - tx) + chroma[((size_t)y0 * cw + x1) * 2 + k] * tx;
+				float b = chroma[((size_t)y1 * cw + x0) * 2 + k] * (1 - tx) + chroma[((size_t)y1 * cw + x1) * 2 + k] * tx;
+				c[k] = a * (1 - ty) + b * ty - 127.5f;
+			}
+			float l = luma[(size_t)y * width + x];
+			float out[3] = { l - c[1] + c[0], l + c[1], l - c[1] - c[0] };
+			for (int k = 0; k < 3; k++)
+				rgb[((size_t)y * width + x) * 3 + k] = (unsigned char)(out[k] < 0.0f ? 0.0f : (out[k] > 255.0f ? 255.0f : out[k] + 0.5f));
+		}
+	}
+}
+
+// peak signal to noise ratio in dB between two images over their first three channels
+inline double psnrRGB(const unsigned char *a, int channelsA, const unsigned char *b, int channelsB, int width, int height)
+{
+	double error = 0.0;
+	for (size_t i = 0, n = (size_t)width * height; i < n; i++)
+		for (int k = 0; k < 3; k++)
+		{
+			double d = (double)a[i * channelsA + k] - (double)b[i * channelsB + k];
+			error += d * d;
+		}
+	error /= (double)width * height * 3;
+	return error == 0.0 ? 99.0 : 10.0 * log10(255.0 * 255.0 / error);
+}
+
+#endif
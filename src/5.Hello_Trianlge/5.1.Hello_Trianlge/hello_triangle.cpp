@@ -1,6 +1,9 @@
 #include <iostream>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <cstring>
+
+#include "../../../includes/learnopengl/frame_pacer.h"
 
 using namespace std;
 
@@ -34,8 +37,12 @@ void processInput(GLFWwindow* window)
 		glfwSetWindowShouldClose(window, true);
 }
 
-int main()
+// usage: a.out [continuous]
+int main(int argc, char** argv)
 {
+	// nothing moves, so by default only render when an event asks for it
+	bool continuous = argc > 1 && strcmp(argv[1], "continuous") == 0;
+
 	glfwInit();
 	// Set OpenGL version to 3.3 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -146,29 +153,51 @@ int main()
 	// Unbind the VAO so it won't be accidentally modified by other VAO calls
 	glBindVertexArray(0); 
 
+	FramePacer* pacer = new FramePacer(window, !continuous);
+	double lastReport = glfwGetTime();
+
 	// render loop
 	while (!glfwWindowShouldClose(window))
 	{
 		// input
 		processInput(window);
 
-		// redering commands
-		
-		// clear the scene
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-		// activate the shader program
-		glUseProgram(shaderProgram);
-		// bind the vertex array object
-		glBindVertexArray(VAO);
-		// draw the triangle
-		glDrawArrays(GL_TRIANGLES, 0, 3);
-
-		// check and call events and swap the buffers
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+		if (pacer->beginFrame())
+		{
+			// redering commands
+
+			// clear the scene
+			glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			// activate the shader program
+			glUseProgram(shaderProgram);
+			// bind the vertex array object
+			glBindVertexArray(VAO);
+			// draw the triangle
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+
+			// swap the buffers
+			glfwSwapBuffers(window);
+		}
+
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			const FramePacer::Stats& stats = pacer->stats();
+			cout << stats.rendered << " frames rendered, ";
+			if (continuous)
+				cout << stats.unchanged << " of them unchanged" << endl;
+			else
+				cout << stats.skipped << " skipped" << endl;
+			pacer->resetStats();
+			lastReport = now;
+		}
+
+		// check and call events, sleeping while nothing happens
+		pacer->waitEvents();
 	}
 
+	delete pacer;
 	glfwTerminate();
 	return 0;
 }
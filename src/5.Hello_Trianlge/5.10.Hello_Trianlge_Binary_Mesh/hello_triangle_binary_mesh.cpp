@@ -0,0 +1,315 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "../../../includes/learnopengl/mesh_file.h"
+
+using namespace std;
+
+const char* vertexShaderSource =	"#version 330 core\n"
+									"layout(location = 0) in vec4 aPos;\n"
+									"layout(location = 1) in vec4 aNormal;\n"
+									"layout(location = 2) in vec2 aTexCoord;\n"
+									"uniform vec3 boundsMin;\n"
+									"uniform vec3 boundsExtent;\n"
+									"uniform mat4 viewProjection;\n"
+									"out vec3 normal;\n"
+									"out vec2 texCoord;\n"
+									"void main()\n"
+									"{\n"
+									"	gl_Position = viewProjection * vec4(boundsMin + aPos.xyz * boundsExtent, 1.0);\n"
+									"	normal = aNormal.xyz;\n"
+									"	texCoord = aTexCoord;\n"
+									"}\0";
+
+const char* fragmentShaderSource = 	"#version 330 core\n"
+									"out vec4 FragColor;\n"
+									"in vec3 normal;\n"
+									"in vec2 texCoord;\n"
+									"\n"
+									"void main()\n"
+									"{\n"
+									"	float light = max(dot(normalize(normal), normalize(vec3(0.4, 0.8, 0.5))), 0.0) * 0.8 + 0.2;\n"
+									"	float stripes = 0.85 + 0.15 * step(0.5, fract(texCoord.x * 64.0));\n"
+									"	FragColor = vec4(vec3(1.0f, 0.5f, 0.2f) * light * stripes, 1.0f);\n"
+									"}\0";
+
+static_assert(MeshFileLayout::Feeds<ShaderInput<0, 4>, ShaderInput<1, 4>, ShaderInput<2, 2> >::value,
+	"MeshFileLayout does not match the vertex shader");
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// the repository has no large models, so write a (2,3) torus knot tube as OBJ
+// input for the converter. 'segments' x 128 quads, 8192 segments give 2M triangles
+bool writeTorusKnotOBJ(const char* path, int segments)
+{
+	const int ring = 128;
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+	for (int s = 0; s < segments; s++)
+	{
+		// point on the knot, its tangent and a frame around it
+		float t = 6.2831853f * s / segments, dt = 6.2831853f / segments;
+		glm::vec3 points[2];
+		for (int k = 0; k < 2; k++)
+		{
+			float u = t + k * dt;
+			float r = 2.0f + cosf(3.0f * u);
+			points[k] = glm::vec3(r * cosf(2.0f * u), r * sinf(2.0f * u), sinf(3.0f * u));
+		}
+		glm::vec3 tangent = glm::normalize(points[1] - points[0]);
+		glm::vec3 side = glm::normalize(glm::cross(tangent, points[0]));
+		glm::vec3 up = glm::cross(side, tangent);
+		for (int i = 0; i < ring; i++)
+		{
+			float a = 6.2831853f * i / ring;
+			glm::vec3 n = cosf(a) * side + sinf(a) * up;
+			glm::vec3 p = points[0] + 0.45f * n;
+			fprintf(file, "v %f %f %f\nvn %f %f %f\nvt %f %f\n", p.x, p.y, p.z, n.x, n.y, n.z, (float)s / segments, (float)i / ring);
+		}
+	}
+	for (int s = 0; s < segments; s++)
+		for (int i = 0; i < ring; i++)
+		{
+			int a = s * ring + i + 1, b = s * ring + (i + 1) % ring + 1;
+			int c = ((s + 1) % segments) * ring + i + 1, d = ((s + 1) % segments) * ring + (i + 1) % ring + 1;
+			fprintf(file, "f %d/%d/%d %d/%d/%d %d/%d/%d %d/%d/%d\n", a, a, a, c, c, c, d, d, d, b, b, b);
+		}
+	bool ok = ferror(file) == 0;
+	fclose(file);
+	return ok;
+}
+
+// usage: a.out generate out.obj [segments]
+//        a.out convert in.obj out.mesh
+//        a.out [file.mesh]
+int main(int argc, char** argv)
+{
+	if (argc > 2 && strcmp(argv[1], "generate") == 0)
+	{
+		int segments = argc > 3 ? atoi(argv[3]) : 8192;
+		if (!writeTorusKnotOBJ(argv[2], segments))
+		{
+			cout << "ERROR::MESH::FILE_NOT_SUCCESSFULLY_WRITTEN " << argv[2] << endl;
+			return -1;
+		}
+		cout << "wrote " << 2 * segments * 128 << " triangles to " << argv[2] << endl;
+		return 0;
+	}
+	if (argc > 3 && strcmp(argv[1], "convert") == 0)
+	{
+		MeshConvertStats stats;
+		if (!convertOBJToMeshFile(argv[2], argv[3], &stats))
+			return -1;
+		cout << stats.triangles << " triangles, " << stats.objVertices << " OBJ positions -> " << stats.vertices << " vertices, "
+			<< stats.meshlets << " meshlets, " << stats.fileBytes / (1024 * 1024) << " MB" << endl;
+		cout << "ACMR " << stats.before.acmr << " -> " << stats.after.acmr << ", ATVR " << stats.before.atvr << " -> " << stats.after.atvr << endl;
+		cout << "parse " << stats.parseSeconds << " s, optimize " << stats.optimizeSeconds << " s, write " << stats.writeSeconds << " s" << endl;
+		return 0;
+	}
+	const char* path = argc > 1 ? argv[1] : "torus_knot.mesh";
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create vertex shader and compile it
+	unsigned int vertexShader;
+	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glCompileShader(vertexShader);
+
+	// check if compilation of vertex shader was successful
+	int success;
+	char infoLog[512];
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create fragment shader and compile it
+	unsigned int fragmentShader;
+	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glCompileShader(fragmentShader);
+
+	// check if compilation of fragment shader was successful
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create shader program
+	unsigned int shaderProgram;
+	shaderProgram = glCreateProgram();
+
+	// attach shaders to the shader program
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+
+	// check if linking the shader program was successful
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::PROGRAM::LINKING_FAILDED\n" << infoLog << endl;
+	}
+
+	// delete the shader objects after linking them into the program is done
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	// map the file and upload it, no parsing involved
+	MeshFile mesh = loadMeshFile(path);
+	if (!mesh.valid)
+	{
+		glfwTerminate();
+		return -1;
+	}
+	MeshFileLayout::validate(shaderProgram);
+	size_t fileBytes = mesh.header.meshletOffset + mesh.meshlets.size() * sizeof(MeshFileMeshlet);
+	cout << "loaded " << mesh.indexCount / 3 << " triangles, " << mesh.header.vertexCount << " vertices, " << mesh.meshlets.size()
+		<< " meshlets in " << mesh.loadSeconds * 1000.0 << " ms (" << fileBytes / mesh.loadSeconds / (1024.0 * 1024.0) << " MB/s)" << endl;
+
+	glUseProgram(shaderProgram);
+	glUniform3fv(glGetUniformLocation(shaderProgram, "boundsMin"), 1, mesh.header.boundsMin);
+	glUniform3f(glGetUniformLocation(shaderProgram, "boundsExtent"), mesh.header.boundsMax[0] - mesh.header.boundsMin[0],
+		mesh.header.boundsMax[1] - mesh.header.boundsMin[1], mesh.header.boundsMax[2] - mesh.header.boundsMin[2]);
+	int viewProjectionLocation = glGetUniformLocation(shaderProgram, "viewProjection");
+
+	glm::vec3 center(mesh.header.sphere[0], mesh.header.sphere[1], mesh.header.sphere[2]);
+	float radius = mesh.header.sphere[3];
+	size_t indexSize = indexTypeSize(mesh.indexType);
+	vector<GLsizei> counts;
+	vector<const void*> offsets;
+
+	glEnable(GL_DEPTH_TEST);
+	double lastReport = glfwGetTime();
+	int frames = 0;
+	size_t drawnTriangles = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// orbit around the mesh
+		float time = (float)glfwGetTime();
+		glm::vec3 eye = center + radius * 2.2f * glm::vec3(sinf(time * 0.3f), 0.4f, cosf(time * 0.3f));
+		int width, height;
+		glfwGetFramebufferSize(window, &width, &height);
+		glm::mat4 projection = glm::perspective(glm::radians(45.0f), (float)width / (height > 0 ? height : 1), radius * 0.05f, radius * 5.0f);
+		glm::mat4 viewProjection = projection * glm::lookAt(eye, center, glm::vec3(0.0f, 1.0f, 0.0f));
+
+		// skip meshlets whose normal cone faces away from the camera
+		counts.clear();
+		offsets.clear();
+		for (size_t i = 0; i < mesh.meshlets.size(); i++)
+		{
+			const MeshFileMeshlet& m = mesh.meshlets[i];
+			glm::vec3 toMeshlet = glm::vec3(m.center[0], m.center[1], m.center[2]) - eye;
+			float along = glm::dot(toMeshlet, glm::vec3(m.coneAxis[0], m.coneAxis[1], m.coneAxis[2]));
+			if (along >= m.coneCutoff * glm::length(toMeshlet) + m.radius)
+				continue;
+			// merge with the previous draw when the ranges touch
+			size_t start = (size_t)m.indexOffset * indexSize;
+			if (!counts.empty() && (size_t)offsets.back() + counts.back() * indexSize == start)
+				counts.back() += m.indexCount;
+			else
+			{
+				counts.push_back(m.indexCount);
+				offsets.push_back((const void*)start);
+			}
+			drawnTriangles += m.indexCount / 3;
+		}
+
+		// redering commands
+
+		// clear the scene
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// activate the shader program
+		glUseProgram(shaderProgram);
+		glUniformMatrix4fv(viewProjectionLocation, 1, GL_FALSE, glm::value_ptr(viewProjection));
+		// bind the vertex array object
+		glBindVertexArray(mesh.VAO);
+		// draw the visible meshlets in one call
+		if (!counts.empty())
+			glMultiDrawElements(GL_TRIANGLES, &counts[0], mesh.indexType, &offsets[0], (GLsizei)counts.size());
+
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			cout << frames / (now - lastReport) << " fps, " << 100.0 * drawnTriangles / ((double)frames * (mesh.indexCount / 3))
+				<< "% of triangles drawn after cone culling, " << counts.size() << " draw ranges" << endl;
+			frames = 0;
+			drawnTriangles = 0;
+			lastReport = now;
+		}
+
+		// check and call events and swap the buffers
+		glfwPollEvents();
+		glfwSwapBuffers(window);
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	deleteMeshFile(mesh);
+	glDeleteProgram(shaderProgram);
+
+	glfwTerminate();
+	return 0;
+}
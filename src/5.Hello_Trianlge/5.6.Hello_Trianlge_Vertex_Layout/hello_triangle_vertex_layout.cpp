@@ -0,0 +1,276 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "../../../includes/learnopengl/vertex_layout.h"
+
+using namespace std;
+
+const char* vertexShaderSource =	"#version 330 core\n"
+									"layout(location = 0) in vec3 aPos;\n"
+									"layout(location = 1) in vec3 aColor;\n"
+									"layout(location = 2) in vec2 aTexCoord;\n"
+									"uniform float xOffset;\n"
+									"out vec3 ourColor;\n"
+									"out vec2 TexCoord;\n"
+									"void main()\n"
+									"{\n"
+									"	gl_Position = vec4(aPos.x + xOffset, aPos.y, aPos.z, 1.0);\n"
+									"	ourColor = aColor;\n"
+									"	TexCoord = aTexCoord;\n"
+									"}\0";
+
+const char* fragmentShaderSource = 	"#version 330 core\n"
+									"out vec4 FragColor;\n"
+									"in vec3 ourColor;\n"
+									"in vec2 TexCoord;\n"
+									"\n"
+									"void main()\n"
+									"{\n"
+									"	float stripes = step(0.5, fract(TexCoord.x * 8.0 + TexCoord.y * 8.0));\n"
+									"	FragColor = vec4(ourColor * (0.6 + 0.4 * stripes), 1.0f);\n"
+									"}\0";
+
+// the inputs declared by the vertex shader above
+typedef ShaderInput<0, 3> PositionInput;
+typedef ShaderInput<1, 3> ColorInput;
+typedef ShaderInput<2, 2> TexCoordInput;
+
+// 32 bytes: everything as 32-bit floats
+struct FatVertex {
+	glm::vec3 position;
+	glm::vec3 color;
+	glm::vec2 texCoord;
+};
+
+typedef VertexLayout<FatVertex,
+	VERTEX_ATTRIB(FatVertex, position, 0),
+	VERTEX_ATTRIB(FatVertex, color, 1),
+	VERTEX_ATTRIB(FatVertex, texCoord, 2)> FatLayout;
+
+// 16 bytes: normalized shorts for the position, 10 bits per color channel, half float uvs
+struct PackedVertex {
+	SNorm16x4 position;
+	UNorm1010102 color;
+	Half2 texCoord;
+};
+
+typedef VertexLayout<PackedVertex,
+	VERTEX_ATTRIB(PackedVertex, position, 0),
+	VERTEX_ATTRIB(PackedVertex, color, 1),
+	VERTEX_ATTRIB(PackedVertex, texCoord, 2)> PackedLayout;
+
+static_assert(sizeof(FatVertex) == 32, "unexpected padding in FatVertex");
+static_assert(sizeof(PackedVertex) == 16, "unexpected padding in PackedVertex");
+static_assert(FatLayout::Feeds<PositionInput, ColorInput, TexCoordInput>::value, "FatLayout does not match the vertex shader");
+static_assert(PackedLayout::Feeds<PositionInput, ColorInput, TexCoordInput>::value, "PackedLayout does not match the vertex shader");
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// upload vertices of one layout into a new VAO, the attribute setup comes from the layout
+template <typename Layout, typename Vertex>
+unsigned int createVertexArray(const vector<Vertex>& vertices, unsigned int EBO, unsigned int& VBO)
+{
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), &vertices[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	Layout::apply();
+	glBindVertexArray(0);
+	return VAO;
+}
+
+int main()
+{
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create vertex shader and compile it
+	unsigned int vertexShader;
+	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glCompileShader(vertexShader);
+
+	// check if compilation of vertex shader was successful
+	int success;
+	char infoLog[512];
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create fragment shader and compile it
+	unsigned int fragmentShader;
+	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glCompileShader(fragmentShader);
+
+	// check if compilation of fragment shader was successful
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create shader program
+	unsigned int shaderProgram;
+	shaderProgram = glCreateProgram();
+
+	// attach shaders to the shader program
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+
+	// check if linking the shader program was successful
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::PROGRAM::LINKING_FAILDED\n" << infoLog << endl;
+	}
+
+	// delete the shader objects after linking them into the program is done
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	// the compile time checks trust the ShaderInput declarations, make sure the linked program agrees
+	if (!FatLayout::validate(shaderProgram) || !PackedLayout::validate(shaderProgram))
+	{
+		glfwTerminate();
+		return -1;
+	}
+
+	// a disc made of a triangle fan, once in each vertex format
+	const int segments = 64;
+	vector<FatVertex> fatVertices;
+	vector<PackedVertex> packedVertices;
+	vector<unsigned int> indices;
+	for (int i = 0; i <= segments; i++)
+	{
+		float angle = i == 0 ? 0.0f : 2.0f * 3.14159265f * (i - 1) / segments;
+		float radius = i == 0 ? 0.0f : 0.4f;
+		FatVertex fat;
+		fat.position = glm::vec3(radius * cosf(angle), radius * sinf(angle) * 4.0f / 3.0f, 0.0f);
+		fat.color = glm::vec3(0.5f + 0.5f * cosf(angle), 0.5f + 0.5f * sinf(angle), i == 0 ? 1.0f : 0.3f);
+		fat.texCoord = glm::vec2(fat.position.x + 0.5f, fat.position.y + 0.5f);
+		fatVertices.push_back(fat);
+
+		PackedVertex packed;
+		packed.position = makeSNorm16x4(fat.position.x, fat.position.y, fat.position.z);
+		packed.color = makeUNorm1010102(fat.color.r, fat.color.g, fat.color.b);
+		packed.texCoord = makeHalf2(fat.texCoord.x, fat.texCoord.y);
+		packedVertices.push_back(packed);
+
+		if (i > 0)
+		{
+			indices.push_back(0);
+			indices.push_back(i);
+			indices.push_back(i % segments + 1);
+		}
+	}
+
+	// define element buffer object, shared by both vertex arrays
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+
+	// define the vertex array and vertex buffer objects
+	unsigned int fatVBO, packedVBO;
+	unsigned int fatVAO = createVertexArray<FatLayout>(fatVertices, EBO, fatVBO);
+	unsigned int packedVAO = createVertexArray<PackedLayout>(packedVertices, EBO, packedVBO);
+
+	cout << "vertex size: " << FatLayout::stride << " bytes -> " << PackedLayout::stride << " bytes, vertex buffers "
+		<< fatVertices.size() * sizeof(FatVertex) << " -> " << packedVertices.size() * sizeof(PackedVertex) << " bytes" << endl;
+
+	// Unbind the VBO and EBO buffers
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+	int offsetLocation = glGetUniformLocation(shaderProgram, "xOffset");
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// redering commands
+
+		// clear the scene
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		// activate the shader program
+		glUseProgram(shaderProgram);
+
+		// left: 32 byte vertices, right: 16 byte vertices, both should look the same
+		glUniform1f(offsetLocation, -0.5f);
+		glBindVertexArray(fatVAO);
+		glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+		glUniform1f(offsetLocation, 0.5f);
+		glBindVertexArray(packedVAO);
+		glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+
+		// check and call events and swap the buffers
+		glfwPollEvents();
+		glfwSwapBuffers(window);
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteVertexArrays(1, &fatVAO);
+	glDeleteVertexArrays(1, &packedVAO);
+	glDeleteBuffers(1, &fatVBO);
+	glDeleteBuffers(1, &packedVBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteProgram(shaderProgram);
+
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,328 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "../../../includes/learnopengl/mesh_optimizer.h"
+
+using namespace std;
+
+const char* vertexShaderSource =	"#version 330 core\n"
+									"layout(location = 0) in vec3 aPos;\n"
+									"uniform float angle;\n"
+									"uniform float xOffset;\n"
+									"out vec3 normal;\n"
+									"void main()\n"
+									"{\n"
+									"	float c = cos(angle), s = sin(angle);\n"
+									"	vec3 p = vec3(c * aPos.x + s * aPos.z, aPos.y, -s * aPos.x + c * aPos.z);\n"
+									"	normal = p;\n"
+									"	gl_Position = vec4(p.x * 0.3 * 0.75 + xOffset, p.y * 0.3, p.z * 0.1, 1.0);\n"
+									"}\0";
+
+const char* fragmentShaderSource = 	"#version 330 core\n"
+									"out vec4 FragColor;\n"
+									"in vec3 normal;\n"
+									"\n"
+									"void main()\n"
+									"{\n"
+									"	float light = max(dot(normalize(normal), normalize(vec3(0.3, 0.6, -1.0))), 0.0);\n"
+									"	FragColor = vec4(vec3(1.0f, 0.5f, 0.2f) * (0.2 + 0.8 * light), 1.0f);\n"
+									"}\0";
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// unindexed triangle soup of a unit sphere, the way many exporters write meshes
+vector<float> makeSphereSoup(int rings, int segments)
+{
+	vector<float> soup;
+	const float pi = 3.14159265f;
+	for (int r = 0; r < rings; r++)
+	{
+		for (int s = 0; s < segments; s++)
+		{
+			float corners[4][3];
+			for (int k = 0; k < 4; k++)
+			{
+				float theta = pi * (r + (k / 2)) / rings, phi = 2.0f * pi * ((s + (k % 2)) % segments) / segments;
+				corners[k][0] = sinf(theta) * cosf(phi);
+				corners[k][1] = cosf(theta);
+				corners[k][2] = sinf(theta) * sinf(phi);
+			}
+			int quad[6] = { 0, 2, 1, 1, 2, 3 };
+			for (int i = 0; i < 6; i++)
+				soup.insert(soup.end(), corners[quad[i]], corners[quad[i]] + 3);
+		}
+	}
+	return soup;
+}
+
+// flat grid with a bump, generated indexed but row by row
+void makeGrid(int n, vector<float>& positions, vector<unsigned int>& indices)
+{
+	for (int y = 0; y <= n; y++)
+		for (int x = 0; x <= n; x++)
+		{
+			float fx = 2.0f * x / n - 1.0f, fy = 2.0f * y / n - 1.0f;
+			positions.push_back(fx);
+			positions.push_back(fy);
+			positions.push_back(0.3f * expf(-4.0f * (fx * fx + fy * fy)));
+		}
+	for (int y = 0; y < n; y++)
+		for (int x = 0; x < n; x++)
+		{
+			unsigned int a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+			unsigned int quad[6] = { a, b, c, b, d, c };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+}
+
+void shuffleTriangles(vector<unsigned int>& indices)
+{
+	srand(42);
+	for (size_t t = indices.size() / 3 - 1; t > 0; t--)
+	{
+		size_t other = (size_t)rand() % (t + 1);
+		for (int k = 0; k < 3; k++)
+			swap(indices[t * 3 + k], indices[other * 3 + k]);
+	}
+}
+
+void printStats(const char* label, const vector<unsigned int>& indices, size_t vertexCount)
+{
+	VertexCacheStats stats = analyzeVertexCache(indices, vertexCount);
+	cout << "  " << label << ": ACMR " << stats.acmr << ", ATVR " << stats.atvr << endl;
+}
+
+// run the whole pipeline on an indexed mesh, positions are compacted along with the indices
+GLenum optimizeMesh(vector<float>& positions, vector<unsigned int>& indices, vector<unsigned char>& packed)
+{
+	size_t vertexCount = positions.size() / 3;
+	printStats("before", indices, vertexCount);
+
+	optimizeOverdraw(indices, &positions[0], 3 * sizeof(float), vertexCount);
+	printStats("after ", indices, vertexCount);
+
+	vector<unsigned char> bytes((unsigned char*)&positions[0], (unsigned char*)&positions[0] + positions.size() * sizeof(float));
+	vertexCount = optimizeVertexFetch(indices, bytes, 3 * sizeof(float));
+	positions.assign((float*)&bytes[0], (float*)&bytes[0] + vertexCount * 3);
+
+	GLenum type = packIndices(indices, vertexCount, packed, false);
+	cout << "  index buffer: " << indices.size() * sizeof(unsigned int) << " -> " << packed.size() << " bytes ("
+		<< (type == GL_UNSIGNED_SHORT ? "GL_UNSIGNED_SHORT" : "GL_UNSIGNED_INT") << ")" << endl;
+	return type;
+}
+
+// VAO with the positions and an index buffer of the given type
+unsigned int createMesh(const vector<float>& positions, const void* indices, size_t indexBytes, unsigned int buffers[2])
+{
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(2, buffers);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+	glBufferData(GL_ARRAY_BUFFER, positions.size() * sizeof(float), &positions[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	glBindVertexArray(0);
+	return VAO;
+}
+
+// GPU time of 'repeat' draws of a mesh in milliseconds
+double timeDraws(unsigned int VAO, GLsizei count, GLenum type, int repeat)
+{
+	unsigned int query;
+	glGenQueries(1, &query);
+	glBindVertexArray(VAO);
+	glBeginQuery(GL_TIME_ELAPSED, query);
+	for (int i = 0; i < repeat; i++)
+		glDrawElements(GL_TRIANGLES, count, type, 0);
+	glEndQuery(GL_TIME_ELAPSED);
+	GLuint64 nanoseconds = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+	glDeleteQueries(1, &query);
+	return nanoseconds / 1.0e6;
+}
+
+int main()
+{
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create vertex shader and compile it
+	unsigned int vertexShader;
+	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glCompileShader(vertexShader);
+
+	// check if compilation of vertex shader was successful
+	int success;
+	char infoLog[512];
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create fragment shader and compile it
+	unsigned int fragmentShader;
+	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glCompileShader(fragmentShader);
+
+	// check if compilation of fragment shader was successful
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create shader program
+	unsigned int shaderProgram;
+	shaderProgram = glCreateProgram();
+
+	// attach shaders to the shader program
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+
+	// check if linking the shader program was successful
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::PROGRAM::LINKING_FAILDED\n" << infoLog << endl;
+	}
+
+	// delete the shader objects after linking them into the program is done
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	// sphere: weld the soup into an indexed mesh, then scramble the triangle order
+	vector<float> soup = makeSphereSoup(128, 256);
+	vector<unsigned int> remap;
+	size_t soupCount = soup.size() / 3;
+	size_t sphereCount = weldVertices(&soup[0], soupCount, 3 * sizeof(float), remap);
+	vector<unsigned char> welded;
+	remapVertexBuffer(&soup[0], soupCount, 3 * sizeof(float), remap, sphereCount, welded);
+	vector<float> sphere((float*)&welded[0], (float*)&welded[0] + sphereCount * 3);
+	vector<unsigned int> sphereIndices(remap);
+	shuffleTriangles(sphereIndices);
+	cout << "sphere: " << sphereIndices.size() / 3 << " triangles, welded " << soupCount << " -> " << sphereCount << " vertices" << endl;
+
+	// the scrambled version is kept to draw and time against
+	vector<float> shuffledSphere(sphere);
+	vector<unsigned int> shuffledIndices(sphereIndices);
+	vector<unsigned char> sphereIndexBytes;
+	GLenum sphereType = optimizeMesh(sphere, sphereIndices, sphereIndexBytes);
+
+	// grid: row by row order is already decent, Tipsify still improves it
+	vector<float> grid;
+	vector<unsigned int> gridIndices;
+	makeGrid(100, grid, gridIndices);
+	cout << "grid: " << gridIndices.size() / 3 << " triangles, " << grid.size() / 3 << " vertices" << endl;
+	vector<unsigned char> gridIndexBytes;
+	optimizeMesh(grid, gridIndices, gridIndexBytes);
+
+	// define the vertex array objects for both sphere orders
+	unsigned int shuffledBuffers[2], optimizedBuffers[2];
+	unsigned int shuffledVAO = createMesh(shuffledSphere, &shuffledIndices[0], shuffledIndices.size() * sizeof(unsigned int), shuffledBuffers);
+	unsigned int optimizedVAO = createMesh(sphere, &sphereIndexBytes[0], sphereIndexBytes.size(), optimizedBuffers);
+	GLsizei indexCount = (GLsizei)sphereIndices.size();
+
+	glEnable(GL_DEPTH_TEST);
+	glUseProgram(shaderProgram);
+	int angleLocation = glGetUniformLocation(shaderProgram, "angle");
+	int offsetLocation = glGetUniformLocation(shaderProgram, "xOffset");
+
+	// draw each version a number of times and compare the GPU time
+	glUniform1f(angleLocation, 0.0f);
+	glUniform1f(offsetLocation, 0.0f);
+	timeDraws(shuffledVAO, indexCount, GL_UNSIGNED_INT, 1);
+	double shuffledTime = timeDraws(shuffledVAO, indexCount, GL_UNSIGNED_INT, 50);
+	double optimizedTime = timeDraws(optimizedVAO, indexCount, sphereType, 50);
+	cout << "50 sphere draws: shuffled " << shuffledTime << " ms, optimized " << optimizedTime << " ms" << endl;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// redering commands
+
+		// clear the scene
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// activate the shader program
+		glUseProgram(shaderProgram);
+		glUniform1f(angleLocation, (float)glfwGetTime() * 0.5f);
+
+		// left: scrambled order, right: optimized order; the image is the same
+		glUniform1f(offsetLocation, -0.5f);
+		glBindVertexArray(shuffledVAO);
+		glDrawElements(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, 0);
+		glUniform1f(offsetLocation, 0.5f);
+		glBindVertexArray(optimizedVAO);
+		glDrawElements(GL_TRIANGLES, indexCount, sphereType, 0);
+
+		// check and call events and swap the buffers
+		glfwPollEvents();
+		glfwSwapBuffers(window);
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteVertexArrays(1, &shuffledVAO);
+	glDeleteVertexArrays(1, &optimizedVAO);
+	glDeleteBuffers(2, shuffledBuffers);
+	glDeleteBuffers(2, optimizedBuffers);
+	glDeleteProgram(shaderProgram);
+
+	glfwTerminate();
+	return 0;
+}
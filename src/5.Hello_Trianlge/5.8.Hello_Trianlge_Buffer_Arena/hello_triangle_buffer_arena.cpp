@@ -0,0 +1,354 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "../../../includes/learnopengl/vertex_layout.h"
+#include "../../../includes/learnopengl/buffer_arena.h"
+
+using namespace std;
+
+const char* vertexShaderSource =	"#version 330 core\n"
+									"layout(location = 0) in vec2 aPos;\n"
+									"layout(location = 1) in vec4 aColor;\n"
+									"uniform vec2 offset;\n"
+									"out vec4 ourColor;\n"
+									"void main()\n"
+									"{\n"
+									"	gl_Position = vec4(aPos * 0.045 + offset, 0.0, 1.0);\n"
+									"	ourColor = aColor;\n"
+									"}\0";
+
+const char* fragmentShaderSource = 	"#version 330 core\n"
+									"out vec4 FragColor;\n"
+									"in vec4 ourColor;\n"
+									"\n"
+									"void main()\n"
+									"{\n"
+									"	FragColor = ourColor;\n"
+									"}\0";
+
+struct Vertex {
+	glm::vec2 position;
+	UNorm8x4 color;
+};
+
+typedef VertexLayout<Vertex,
+	VERTEX_ATTRIB(Vertex, position, 0),
+	VERTEX_ATTRIB(Vertex, color, 1)> Layout;
+
+static_assert(Layout::Feeds<ShaderInput<0, 2>, ShaderInput<1, 4> >::value, "Layout does not match the vertex shader");
+
+const int GRID = 20;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+struct ShapeData {
+	vector<Vertex> vertices;
+	vector<unsigned int> indices;
+};
+
+// a star or polygon with a random number of points, so meshes differ in size
+ShapeData makeRandomShape()
+{
+	int points = 3 + rand() % 30;
+	bool star = rand() % 2 == 0;
+	float hue = (rand() % 1000) / 1000.0f;
+	ShapeData shape;
+	vector<Vertex>& vertices = shape.vertices;
+	vector<unsigned int>& indices = shape.indices;
+
+	Vertex center;
+	center.position = glm::vec2(0.0f, 0.0f);
+	center.color = makeUNorm8x4(1.0f, 1.0f, 1.0f);
+	vertices.push_back(center);
+	int rim = star ? points * 2 : points;
+	for (int i = 0; i < rim; i++)
+	{
+		float angle = 2.0f * 3.14159265f * i / rim;
+		float radius = star && (i % 2) ? 0.45f : 1.0f;
+		Vertex v;
+		v.position = glm::vec2(radius * cosf(angle), radius * sinf(angle));
+		v.color = makeUNorm8x4(0.5f + 0.5f * cosf(6.2831853f * hue), 0.5f + 0.5f * cosf(6.2831853f * (hue + 0.33f)),
+			0.5f + 0.5f * cosf(6.2831853f * (hue + 0.67f)));
+		vertices.push_back(v);
+		indices.push_back(0);
+		indices.push_back(1 + i);
+		indices.push_back(1 + (i + 1) % rim);
+	}
+	return shape;
+}
+
+unsigned int addShape(BufferArena& arena, const ShapeData& shape)
+{
+	return arena.add(&shape.vertices[0], (unsigned int)shape.vertices.size(), &shape.indices[0],
+		(unsigned int)shape.indices.size());
+}
+
+// every mesh lies inside the buffers, no two overlap and, with 'contents', the
+// buffers still hold what was added for each of them
+bool checkArena(BufferArena& arena, const vector<unsigned int>& shapes, const vector<ShapeData>& data, bool contents)
+{
+	BufferArena::Stats stats = arena.stats();
+	vector<pair<unsigned int, unsigned int> > vertexRanges, indexRanges;
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		BufferArena::Range r = arena.range(shapes[i]);
+		unsigned int vertexCount = (unsigned int)data[i].vertices.size();
+		if (r.count != data[i].indices.size() || r.firstIndex + r.count > stats.indexCapacity ||
+			(unsigned int)r.baseVertex + vertexCount > stats.vertexCapacity)
+			return false;
+		vertexRanges.push_back(make_pair((unsigned int)r.baseVertex, (unsigned int)r.baseVertex + vertexCount));
+		indexRanges.push_back(make_pair(r.firstIndex, r.firstIndex + r.count));
+	}
+	sort(vertexRanges.begin(), vertexRanges.end());
+	sort(indexRanges.begin(), indexRanges.end());
+	for (size_t i = 1; i < shapes.size(); i++)
+		if (vertexRanges[i].first < vertexRanges[i - 1].second || indexRanges[i].first < indexRanges[i - 1].second)
+			return false;
+	if (!contents)
+		return true;
+
+	// read both buffers back through the VAO's bindings
+	arena.bind();
+	int VBO, EBO;
+	glGetVertexAttribiv(0, GL_VERTEX_ATTRIB_ARRAY_BUFFER_BINDING, &VBO);
+	glGetIntegerv(GL_ELEMENT_ARRAY_BUFFER_BINDING, &EBO);
+	size_t indexSize = indexTypeSize(arena.indexType());
+	vector<unsigned char> vertexBytes((size_t)stats.vertexCapacity * Layout::stride), indexBytes(stats.indexCapacity * indexSize);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glGetBufferSubData(GL_ARRAY_BUFFER, 0, vertexBytes.size(), &vertexBytes[0]);
+	glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indexBytes.size(), &indexBytes[0]);
+	glBindVertexArray(0);
+	for (size_t i = 0; i < shapes.size(); i++)
+	{
+		BufferArena::Range r = arena.range(shapes[i]);
+		for (size_t v = 0; v < data[i].vertices.size(); v++)
+			if (memcmp(&vertexBytes[(r.baseVertex + v) * Layout::stride], &data[i].vertices[v], sizeof(Vertex)) != 0)
+				return false;
+		for (size_t k = 0; k < r.count; k++)
+		{
+			const unsigned char* at = &indexBytes[(r.firstIndex + k) * indexSize];
+			unsigned int index = indexSize == 1 ? at[0] : indexSize == 2 ? *(const unsigned short*)at : *(const unsigned int*)at;
+			if (index != data[i].indices[k])
+				return false;
+		}
+	}
+	return true;
+}
+
+// the churn of the render loop as fast as possible, checking the arena after
+// every tick and its contents every 50 ticks
+bool stressTest(BufferArena& arena, int ticks)
+{
+	vector<ShapeData> data;
+	vector<unsigned int> shapes;
+	for (int i = 0; i < GRID * GRID; i++)
+	{
+		data.push_back(makeRandomShape());
+		shapes.push_back(addShape(arena, data.back()));
+	}
+	for (int tick = 0; tick < ticks; tick++)
+	{
+		for (int i = 0; i < 20; i++)
+		{
+			int slot = rand() % (int)shapes.size();
+			arena.remove(shapes[slot]);
+			data[slot] = makeRandomShape();
+			shapes[slot] = addShape(arena, data[slot]);
+		}
+		if (arena.fragmentation() > 0.5f)
+			arena.defragment();
+		if (!checkArena(arena, shapes, data, tick % 50 == 0 || tick == ticks - 1))
+		{
+			cout << "ERROR::BUFFER_ARENA::STRESS_CHECK_FAILED at tick " << tick << endl;
+			return false;
+		}
+	}
+	BufferArena::Stats stats = arena.stats();
+	cout << ticks << " churn ticks ok, vertices " << stats.verticesUsed << "/" << stats.vertexCapacity << ", indices "
+		<< stats.indicesUsed << "/" << stats.indexCapacity << ", defragmentations " << stats.defragmentations << endl;
+	return true;
+}
+
+// usage: a.out [stress [ticks]]
+int main(int argc, char** argv)
+{
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create vertex shader and compile it
+	unsigned int vertexShader;
+	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glCompileShader(vertexShader);
+
+	// check if compilation of vertex shader was successful
+	int success;
+	char infoLog[512];
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create fragment shader and compile it
+	unsigned int fragmentShader;
+	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glCompileShader(fragmentShader);
+
+	// check if compilation of fragment shader was successful
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create shader program
+	unsigned int shaderProgram;
+	shaderProgram = glCreateProgram();
+
+	// attach shaders to the shader program
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+
+	// check if linking the shader program was successful
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::PROGRAM::LINKING_FAILDED\n" << infoLog << endl;
+	}
+
+	// delete the shader objects after linking them into the program is done
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	// one vertex buffer, one index buffer and one VAO shared by all shapes. the arena
+	// starts small on purpose and grows while the first shapes are added
+	BufferArena* arena = new BufferArena(Layout::stride, 4096, 8192);
+	Layout::apply();
+	glBindVertexArray(0);
+
+	if (argc > 1 && strcmp(argv[1], "stress") == 0)
+	{
+		bool ok = stressTest(*arena, argc > 2 ? max(1, atoi(argv[2])) : 2000);
+		delete arena;
+		glDeleteProgram(shaderProgram);
+		glfwTerminate();
+		return ok ? 0 : -1;
+	}
+
+	vector<unsigned int> shapes;
+	for (int i = 0; i < GRID * GRID; i++)
+		shapes.push_back(addShape(*arena, makeRandomShape()));
+	BufferArena::Stats stats = arena->stats();
+	cout << stats.meshes << " meshes in 2 buffers and 1 VAO instead of " << 2 * stats.meshes << " buffers and "
+		<< stats.meshes << " VAOs" << endl;
+
+	int offsetLocation = glGetUniformLocation(shaderProgram, "offset");
+	double lastChurn = glfwGetTime(), lastReport = lastChurn;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// replace some shapes with new ones of other sizes, which fragments the arena
+		double now = glfwGetTime();
+		if (now - lastChurn > 0.1)
+		{
+			for (int i = 0; i < 20; i++)
+			{
+				int slot = rand() % (int)shapes.size();
+				arena->remove(shapes[slot]);
+				shapes[slot] = addShape(*arena, makeRandomShape());
+			}
+			if (arena->fragmentation() > 0.5f)
+				arena->defragment();
+			lastChurn = now;
+		}
+		if (now - lastReport > 2.0)
+		{
+			stats = arena->stats();
+			cout << "vertices " << stats.verticesUsed << "/" << stats.vertexCapacity << " (largest free " << stats.largestVertexRange
+				<< "), indices " << stats.indicesUsed << "/" << stats.indexCapacity << " (largest free " << stats.largestIndexRange
+				<< "), defragmentations " << stats.defragmentations << endl;
+			lastReport = now;
+		}
+
+		// redering commands
+
+		// clear the scene
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+		// activate the shader program
+		glUseProgram(shaderProgram);
+		// bind the arena's vertex array object once for all shapes
+		arena->bind();
+		for (int i = 0; i < (int)shapes.size(); i++)
+		{
+			glUniform2f(offsetLocation, -0.95f + 1.9f * ((i % GRID) + 0.5f) / GRID, -0.95f + 1.9f * ((i / GRID) + 0.5f) / GRID);
+			arena->draw(shapes[i]);
+		}
+
+		// check and call events and swap the buffers
+		glfwPollEvents();
+		glfwSwapBuffers(window);
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	delete arena;
+	glDeleteProgram(shaderProgram);
+
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,249 @@
+#include <iostream>
+#include <vector>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include "../../../includes/learnopengl/stream_buffer.h"
+
+using namespace std;
+
+const char* vertexShaderSource =	"#version 330 core\n"
+									"layout(location = 0) in vec3 aPos;\n"
+									"out float height;\n"
+									"void main()\n"
+									"{\n"
+									"	gl_Position = vec4(aPos.x, aPos.y * 0.8 + aPos.z * 0.3, aPos.z * 0.5, 1.0);\n"
+									"	height = aPos.z;\n"
+									"}\0";
+
+const char* fragmentShaderSource = 	"#version 330 core\n"
+									"out vec4 FragColor;\n"
+									"in float height;\n"
+									"\n"
+									"void main()\n"
+									"{\n"
+									"	FragColor = vec4(mix(vec3(0.1, 0.3, 0.6), vec3(1.0f, 0.5f, 0.2f), height * 0.5 + 0.5), 1.0f);\n"
+									"}\0";
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// CPU animated height field, written straight into the mapped stream buffer
+void animateGrid(float* vertices, int n, float time)
+{
+	for (int y = 0; y <= n; y++)
+	{
+		float fy = 2.0f * y / n - 1.0f;
+		for (int x = 0; x <= n; x++)
+		{
+			float fx = 2.0f * x / n - 1.0f;
+			float r = sqrtf(fx * fx + fy * fy);
+			float* v = vertices + ((size_t)y * (n + 1) + x) * 3;
+			v[0] = fx * 0.9f;
+			v[1] = fy * 0.9f;
+			v[2] = 0.5f * sinf(12.0f * r - 3.0f * time) * expf(-1.5f * r);
+		}
+	}
+}
+
+// usage: a.out [grid size] [frames in flight] [orphan]
+int main(int argc, char** argv)
+{
+	int n = argc > 1 ? atoi(argv[1]) : 256;
+	int frames = argc > 2 ? atoi(argv[2]) : 3;
+	bool allowPersistent = !(argc > 3 && strcmp(argv[3], "orphan") == 0);
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	// no vsync, we want to see how fast geometry can be streamed
+	glfwSwapInterval(0);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create vertex shader and compile it
+	unsigned int vertexShader;
+	vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
+	glCompileShader(vertexShader);
+
+	// check if compilation of vertex shader was successful
+	int success;
+	char infoLog[512];
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(vertexShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create fragment shader and compile it
+	unsigned int fragmentShader;
+	fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
+	glCompileShader(fragmentShader);
+
+	// check if compilation of fragment shader was successful
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		glGetShaderInfoLog(fragmentShader, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << endl;
+		return -1;
+	}
+
+	// create shader program
+	unsigned int shaderProgram;
+	shaderProgram = glCreateProgram();
+
+	// attach shaders to the shader program
+	glAttachShader(shaderProgram, vertexShader);
+	glAttachShader(shaderProgram, fragmentShader);
+	glLinkProgram(shaderProgram);
+
+	// check if linking the shader program was successful
+	glGetProgramiv(shaderProgram, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		glGetProgramInfoLog(shaderProgram, 512, NULL, infoLog);
+		cout << "ERROR::SHADER::PROGRAM::LINKING_FAILDED\n" << infoLog << endl;
+	}
+
+	// delete the shader objects after linking them into the program is done
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	// the grid topology never changes, only the vertices are streamed
+	vector<unsigned int> indices;
+	for (int y = 0; y < n; y++)
+		for (int x = 0; x < n; x++)
+		{
+			unsigned int a = y * (n + 1) + x, b = a + 1, c = a + n + 1, d = c + 1;
+			unsigned int quad[6] = { a, b, c, b, d, c };
+			indices.insert(indices.end(), quad, quad + 6);
+		}
+	const GLsizeiptr frameBytes = (GLsizeiptr)(n + 1) * (n + 1) * 3 * sizeof(float);
+
+	// define the streaming vertex buffer
+	StreamBuffer* stream = new StreamBuffer(frameBytes, frames, allowPersistent);
+	cout << "streaming " << frameBytes / 1024 << " KB of vertices per frame, "
+		<< (stream->isPersistent() ? "persistent mapping" : "orphaning") << ", " << stream->frameCount() << " partitions" << endl;
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data, the per frame offset goes in as base vertex
+	glBindBuffer(GL_ARRAY_BUFFER, stream->buffer());
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	glEnable(GL_DEPTH_TEST);
+	double lastReport = glfwGetTime();
+	double cpuSeconds = 0.0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// write this frame's vertices
+		double start = glfwGetTime();
+		float* vertices = (float*)stream->begin();
+		animateGrid(vertices, n, (float)start);
+		GLintptr offset = stream->end();
+		cpuSeconds += glfwGetTime() - start;
+
+		// redering commands
+
+		// clear the scene
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+		// activate the shader program
+		glUseProgram(shaderProgram);
+		// bind the vertex array object
+		glBindVertexArray(VAO);
+		// draw the triangles from this frame's partition
+		glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0, (GLint)(offset / (3 * sizeof(float))));
+		stream->fence();
+
+		// how often the CPU had to wait for the GPU to release a partition
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			const StreamBuffer::Stats& stats = stream->statistics();
+			cout << stats.frames / (now - lastReport) << " fps, " << stats.frames * frameBytes / (now - lastReport) / (1024.0 * 1024.0)
+				<< " MB/s streamed, waited in " << stats.waits << "/" << stats.frames << " frames (total "
+				<< stats.waitSeconds * 1000.0 << " ms, max " << stats.maxWaitSeconds * 1000.0 << " ms), CPU write "
+				<< cpuSeconds * 1000.0 / stats.frames << " ms/frame" << endl;
+			stream->resetStats();
+			cpuSeconds = 0.0;
+			lastReport = now;
+		}
+
+		// check and call events and swap the buffers
+		glfwPollEvents();
+		glfwSwapBuffers(window);
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	delete stream;
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteProgram(shaderProgram);
+
+	glfwTerminate();
+	return 0;
+}
@@ -3,6 +3,9 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstring>
+
+#include "../../../includes/learnopengl/frame_pacer.h"
 
 using namespace std;
 
@@ -22,6 +25,8 @@ const char* fragmentShaderSource = 	"#version 330 core\n"
 	"}\0";
 
 
+bool paused = false;
+
 // callback method for change in window size
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
@@ -33,10 +38,20 @@ void processInput(GLFWwindow* window)
 {
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, true);
+
+	// SPACE pauses the color animation, then frames only render on events
+	static bool spaceDown = false;
+	bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+	if (space && !spaceDown)
+		paused = !paused;
+	spaceDown = space;
 }
 
-int main()
+// usage: a.out [continuous]
+int main(int argc, char** argv)
 {
+	bool continuous = argc > 1 && strcmp(argv[1], "continuous") == 0;
+
 	glfwInit();
 	// Set OpenGL version to 3.3 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -147,37 +162,65 @@ int main()
 	// Unbind the VAO so it won't be accidentally modified by other VAO calls
 	glBindVertexArray(0); 
 
+	FramePacer* pacer = new FramePacer(window, !continuous);
+	double lastReport = glfwGetTime(), lastFrame = glfwGetTime();
+	float timeValue = 0.0f;
+
 	// render loop
 	while (!glfwWindowShouldClose(window))
 	{
 		// input
 		processInput(window);
 
-		// redering commands
-		
-		// clear the color buffer
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
-
-		// activate the shader program
-		glUseProgram(shaderProgram);
-
-		// update the uniform color
-		float timeValue = glfwGetTime();
-		float greenValue = sin(timeValue)/2.0f + 0.5f;
-		int vertexColorLocation = glGetUniformLocation(shaderProgram, "vertexColor");
-		glUniform4f(vertexColorLocation, 0.0f, greenValue, 0.0f, 1.0f);
-
-		// bind the vertex array object
-		glBindVertexArray(VAO);
-		// draw the triangle
-		glDrawArrays(GL_TRIANGLES, 0, 3);
-
-		// check and call events and swap the buffers
-		glfwPollEvents();
-		glfwSwapBuffers(window);
+		// the color only changes while the animation runs
+		double now = glfwGetTime();
+		if (!paused)
+			timeValue += (float)(now - lastFrame);
+		lastFrame = now;
+		pacer->setAnimating(!paused);
+
+		if (pacer->beginFrame())
+		{
+			// redering commands
+
+			// clear the color buffer
+			glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+
+			// activate the shader program
+			glUseProgram(shaderProgram);
+
+			// update the uniform color
+			float greenValue = sin(timeValue)/2.0f + 0.5f;
+			int vertexColorLocation = glGetUniformLocation(shaderProgram, "vertexColor");
+			glUniform4f(vertexColorLocation, 0.0f, greenValue, 0.0f, 1.0f);
+
+			// bind the vertex array object
+			glBindVertexArray(VAO);
+			// draw the triangle
+			glDrawArrays(GL_TRIANGLES, 0, 3);
+
+			// swap the buffers
+			glfwSwapBuffers(window);
+		}
+
+		if (now - lastReport > 2.0)
+		{
+			const FramePacer::Stats& stats = pacer->stats();
+			cout << (paused ? "paused: " : "animating: ") << stats.rendered << " frames rendered, ";
+			if (continuous)
+				cout << stats.unchanged << " of them unchanged" << endl;
+			else
+				cout << stats.skipped << " skipped" << endl;
+			pacer->resetStats();
+			lastReport = now;
+		}
+
+		// check and call events, sleeping while paused and nothing happens
+		pacer->waitEvents();
 	}
 
+	delete pacer;
 	glfwTerminate();
 	return 0;
 }
@@ -0,0 +1,32 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+
+uniform sampler2D physicalPages;
+uniform usampler2D pageTable;
+
+uniform float virtualSize;	// texels per side at level 0
+uniform int pages;		// pages per side at level 0
+uniform int levels;
+uniform float pageSize;
+uniform float border;
+uniform float slotSize;
+uniform float physicalSize;
+
+void main()
+{
+	// mip level the virtual texture would be sampled at
+	vec2 texel = TexCoord * virtualSize;
+	float lod = log2(max(length(dFdx(texel)), length(dFdy(texel))));
+	int level = clamp(int(floor(lod)), 0, levels - 1);
+
+	// the page table points at the page itself or its closest resident ancestor
+	vec2 uv = clamp(TexCoord, 0.0, 0.99999);
+	int pagesAtLevel = max(pages >> level, 1);
+	uvec4 entry = texelFetch(pageTable, ivec2(uv * float(pagesAtLevel)), level);
+	float mappedPages = float(max(pages >> int(entry.z), 1));
+	vec2 inPage = fract(uv * mappedPages);
+
+	vec2 physicalUV = (vec2(entry.xy) * slotSize + border + inPage * pageSize) / physicalSize;
+	FragColor = textureLod(physicalPages, physicalUV, 0.0);
+}
\ No newline at end of file
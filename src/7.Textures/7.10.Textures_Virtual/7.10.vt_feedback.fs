@@ -0,0 +1,20 @@
+#version 330 core
+layout(location = 0) out uvec4 Feedback;
+in vec2 TexCoord;
+
+uniform float virtualSize;
+uniform int pages;
+uniform int levels;
+uniform float lodBias;	// the feedback buffer is smaller than the screen
+
+void main()
+{
+	// request the page the main pass would like to sample
+	vec2 texel = TexCoord * virtualSize;
+	float lod = log2(max(length(dFdx(texel)), length(dFdy(texel)))) - lodBias;
+	int level = clamp(int(floor(lod)), 0, levels - 1);
+
+	vec2 uv = clamp(TexCoord, 0.0, 0.99999);
+	int pagesAtLevel = max(pages >> level, 1);
+	Feedback = uvec4(uvec2(uv * float(pagesAtLevel)), uint(level), 1u);
+}
\ No newline at end of file
@@ -0,0 +1,284 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/virtual_texture.h"
+
+using namespace std;
+
+// view onto the virtual texture
+float zoom = 1.0f;
+glm::vec2 center(0.0f, 0.0f);
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window, float dt)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	// Z/X zoom in and out, arrows pan
+	if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS)
+		zoom *= 1.0f + 1.5f * dt;
+	if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS)
+		zoom = max(1.0f, zoom / (1.0f + 1.5f * dt));
+	float pan = dt / zoom;
+	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+		center.x -= pan;
+	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+		center.x += pan;
+	if (glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+		center.y -= pan;
+	if (glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+		center.y += pan;
+}
+
+// procedural Mandelbrot image of any size, pages are computed on demand
+class MandelbrotSource : public VirtualTextureSource {
+public:
+	MandelbrotSource(int size) : texels(size) {}
+
+	int size() const
+	{
+		return texels;
+	}
+
+	void read(int level, int x0, int y0, int extent, unsigned char* rgba)
+	{
+		double step = (double)(1 << level) / texels;
+		for (int y = 0; y < extent; y++)
+		{
+			for (int x = 0; x < extent; x++)
+			{
+				// texel centre in [0, 1]^2 mapped onto the complex plane
+				double u = (x0 + x + 0.5) * step, v = (y0 + y + 0.5) * step;
+				double cr = -2.2 + u * 3.2, ci = -1.6 + v * 3.2;
+				double zr = 0.0, zi = 0.0;
+				int i = 0;
+				const int iterations = 512;
+				while (i < iterations && zr * zr + zi * zi < 16.0)
+				{
+					double t = zr * zr - zi * zi + cr;
+					zi = 2.0 * zr * zi + ci;
+					zr = t;
+					i++;
+				}
+				unsigned char* p = rgba + ((size_t)y * extent + x) * 4;
+				if (i == iterations)
+				{
+					p[0] = p[1] = p[2] = 10;
+				}
+				else
+				{
+					double smooth = i + 1 - log(log(sqrt(zr * zr + zi * zi))) / log(2.0);
+					double t = smooth * 0.05;
+					p[0] = (unsigned char)(127.5 + 127.5 * cos(6.2832 * t));
+					p[1] = (unsigned char)(127.5 + 127.5 * cos(6.2832 * (t + 0.33)));
+					p[2] = (unsigned char)(127.5 + 127.5 * cos(6.2832 * (t + 0.67)));
+				}
+				p[3] = 255;
+			}
+		}
+	}
+
+private:
+	int texels;
+};
+
+void setVirtualTextureUniforms(Shader& shader, const VirtualTexture& vt, float virtualSize)
+{
+	shader.use();
+	shader.setFloat("virtualSize", virtualSize);
+	shader.setInt("pages", vt.pages);
+	shader.setInt("levels", vt.levels);
+	shader.setFloat("pageSize", (float)VirtualTexture::PAGE);
+	shader.setFloat("border", (float)VirtualTexture::BORDER);
+	shader.setFloat("slotSize", (float)VirtualTexture::SLOT);
+	shader.setFloat("physicalSize", (float)(vt.slotsPerSide * VirtualTexture::SLOT));
+	shader.setInt("physicalPages", 0);
+	shader.setInt("pageTable", 1);
+}
+
+int main(int argc, char* argv[])
+{
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shaders, the feedback pass shares the vertex shader
+	Shader shader("7.10.vt.vs", "7.10.vt.fs");
+	Shader feedbackShader("7.10.vt.vs", "7.10.vt_feedback.fs");
+
+	// set up vertex data
+
+	float vertices[] = {
+		// positions          // texture coords
+		 1.0f,  1.0f, 0.0f,  1.0f, 1.0f,	// top right
+		 1.0f, -1.0f, 0.0f,  1.0f, 0.0f,	// bottom right
+		-1.0f, -1.0f, 0.0f,  0.0f, 0.0f,	// bottom left
+		-1.0f,  1.0f, 0.0f,  0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// texture attribute
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	// create the virtual texture
+	// --------------------------
+	// virtual size (default 128k x 128k texels) and cache budget in MB from the command line
+	int maxSize;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+	int virtualSize = argc > 1 ? atoi(argv[1]) : (1 << 17);
+	size_t budget = (size_t)(argc > 2 ? atoi(argv[2]) : 16) * 1024 * 1024;
+	MandelbrotSource source(virtualSize);
+	VirtualTexture vt(source, budget);
+	cout << "virtual texture " << virtualSize << "x" << virtualSize << " (GL_MAX_TEXTURE_SIZE " << maxSize << "), "
+		<< vt.levels << " levels, " << vt.slotsPerSide * vt.slotsPerSide << " cache pages, "
+		<< vt.residentBytes() / 1024 << " KB resident" << endl;
+
+	setVirtualTextureUniforms(shader, vt, (float)virtualSize);
+	setVirtualTextureUniforms(feedbackShader, vt, (float)virtualSize);
+
+	double lastTime = glfwGetTime();
+	double lastReport = lastTime;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		double now = glfwGetTime();
+		float dt = (float)(now - lastTime);
+		lastTime = now;
+
+		// input
+		processInput(window, dt);
+
+		glm::mat4 trans = glm::mat4(1.0f);
+		trans = glm::scale(trans, glm::vec3(zoom, zoom, 1.0f));
+		trans = glm::translate(trans, glm::vec3(-center, 0.0f));
+
+		int viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		// feedback pass: which pages does this view need
+		vt.beginFeedback();
+		feedbackShader.use();
+		feedbackShader.setFloat("lodBias", vt.feedbackBias(viewport[2]));
+		glUniformMatrix4fv(glGetUniformLocation(feedbackShader.ID, "transform"), 1, GL_FALSE, glm::value_ptr(trans));
+		glBindVertexArray(VAO);
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		vt.endFeedback();
+
+		// stream pages in and out of the cache
+		vt.update();
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// activate the shader program
+		shader.use();
+		glUniformMatrix4fv(glGetUniformLocation(shader.ID, "transform"), 1, GL_FALSE, glm::value_ptr(trans));
+
+		// bind the page cache and page table
+		vt.bind(0, 1);
+
+		// draw the triangles
+		glBindVertexArray(VAO);
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+		if (now - lastReport > 2.0)
+		{
+			cout << "zoom " << zoom << ": " << vt.residentPages() << " pages resident, " << vt.pendingPages()
+				<< " pending, " << vt.totalUploads << " uploads, " << vt.totalEvictions << " evictions" << endl;
+			lastReport = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	vt.stop();
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,10 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+
+uniform sampler2D rgbaTexture;
+
+void main()
+{
+	FragColor = texture(rgbaTexture, TexCoord);
+}
\ No newline at end of file
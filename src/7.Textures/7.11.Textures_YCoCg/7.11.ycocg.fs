@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+
+uniform sampler2D lumaTexture;	// full resolution Y
+uniform sampler2D chromaTexture;	// half resolution Co, Cg biased by 0.5
+
+void main()
+{
+	float y = texture(lumaTexture, TexCoord).r;
+	vec2 cocg = texture(chromaTexture, TexCoord).rg - 0.5;
+	float tmp = y - cocg.y;
+	FragColor = vec4(tmp + cocg.x, y + cocg.y, tmp - cocg.x, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,230 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../../includes/stb_image.h"
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/ycocg_texture.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// GPU time in ms of drawing the full screen quad 'passes' times with the bound program and textures
+double timeFullscreenDraws(int passes)
+{
+	unsigned int query;
+	glGenQueries(1, &query);
+	glBeginQuery(GL_TIME_ELAPSED, query);
+	for (int i = 0; i < passes; i++)
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+	glEndQuery(GL_TIME_ELAPSED);
+	GLuint64 elapsed = 0;
+	glGetQueryObjectui64v(query, GL_QUERY_RESULT, &elapsed);
+	glDeleteQueries(1, &query);
+	return elapsed / 1.0e6;
+}
+
+int main()
+{
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shaders, one per storage mode
+	Shader rgbaShader("7.11.texture.vs", "7.11.rgba.fs");
+	Shader ycocgShader("7.11.texture.vs", "7.11.ycocg.fs");
+
+	// set up vertex data
+
+	float vertices[] = {
+		// positions          // texture coords
+		 1.0f,  1.0f, 0.0f,  1.0f, 1.0f,	// top right
+		 1.0f, -1.0f, 0.0f,  1.0f, 0.0f,	// bottom right
+		-1.0f, -1.0f, 0.0f,  0.0f, 0.0f,	// bottom left
+		-1.0f,  1.0f, 0.0f,  0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// texture attribute
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	// load the photo and create both textures
+	// ---------------------------------------
+	int width, heigth, nrChannel;
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* data = stbi_load("../../../resources/textures/container.jpg", &width, &heigth, &nrChannel, 0);
+	if (!data)
+	{
+		cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	unsigned int rgbaTexture = createImmutableTexture2D(data, width, heigth, nrChannel);
+	YCoCgTexture ycocg = createYCoCgTexture(data, width, heigth, nrChannel);
+
+	// quality: reconstruct on the CPU exactly like the shader and compare with the source
+	vector<unsigned char> luma, chroma, rebuilt;
+	splitYCoCg(data, width, heigth, nrChannel, luma, chroma);
+	reconstructYCoCg(luma, chroma, width, heigth, rebuilt);
+	double psnr = psnrRGB(data, nrChannel, &rebuilt[0], 3, width, heigth);
+	stbi_image_free(data);
+
+	size_t rgbaBytes = textureMemoryBytes(rgbaTexture);
+	size_t ycocgBytes = textureMemoryBytes(ycocg.luma) + textureMemoryBytes(ycocg.chroma);
+
+	// throughput: fill the screen repeatedly with each mode
+	const int passes = 200;
+	glBindVertexArray(VAO);
+	rgbaShader.use();
+	rgbaShader.setInt("rgbaTexture", 0);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, rgbaTexture);
+	timeFullscreenDraws(5);
+	double rgbaTime = timeFullscreenDraws(passes);
+
+	ycocgShader.use();
+	ycocgShader.setInt("lumaTexture", 0);
+	ycocgShader.setInt("chromaTexture", 1);
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, ycocg.luma);
+	glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_2D, ycocg.chroma);
+	timeFullscreenDraws(5);
+	double ycocgTime = timeFullscreenDraws(passes);
+
+	cout << "container.jpg " << width << "x" << heigth << endl;
+	cout << "RGBA8:        " << rgbaBytes / 1024 << " KB, " << rgbaTime / passes << " ms per full screen pass" << endl;
+	cout << "YCoCg 4:2:0:  " << ycocgBytes / 1024 << " KB, " << ycocgTime / passes << " ms per full screen pass, PSNR "
+		<< psnr << " dB vs source" << endl;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// bind the vertex array object
+		glBindVertexArray(VAO);
+
+		int viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		glEnable(GL_SCISSOR_TEST);
+
+		// left half: RGBA8
+		glScissor(0, 0, viewport[2] / 2, viewport[3]);
+		rgbaShader.use();
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, rgbaTexture);
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+		// right half: luma + subsampled chroma
+		glScissor(viewport[2] / 2, 0, viewport[2] - viewport[2] / 2, viewport[3]);
+		ycocgShader.use();
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, ycocg.luma);
+		glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_2D, ycocg.chroma);
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+		glDisable(GL_SCISSOR_TEST);
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteTextures(1, &rgbaTexture);
+	glDeleteTextures(1, &ycocg.luma);
+	glDeleteTextures(1, &ycocg.chroma);
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,16 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+
+uniform sampler2D sdfTexture;	// 0.5 on the edge, larger inside
+uniform vec3 tint;
+
+void main()
+{
+	// anti-alias over one screen pixel whatever the scale, tiny copies fade
+	// out smoothly instead of flickering between texels
+	float d = texture(sdfTexture, TexCoord).r - 0.5;
+	float w = max(fwidth(d), 1e-4);
+	float alpha = smoothstep(-w, w, d);
+	FragColor = vec4(tint, alpha);
+}
\ No newline at end of file
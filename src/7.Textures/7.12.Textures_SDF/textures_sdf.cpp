@@ -0,0 +1,218 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../../includes/stb_image.h"
+
+#include <iostream>
+#include <cmath>
+#include <vector>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/sdf_bake.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// draw a row of sprites, each half the size of the previous one
+void drawSpriteRow(Shader& shader, float y, float time)
+{
+	float x = -0.95f;
+	float size = 0.5f;
+	for (int i = 0; i < 8; i++)
+	{
+		glm::mat4 trans = glm::mat4(1.0f);
+		trans = glm::translate(trans, glm::vec3(x + size * 0.5f, y, 0.0f));
+		trans = glm::rotate(trans, time * 0.2f, glm::vec3(0.0f, 0.0f, 1.0f));
+		trans = glm::scale(trans, glm::vec3(size * 0.5f));
+		glUniformMatrix4fv(glGetUniformLocation(shader.ID, "transform"), 1, GL_FALSE, glm::value_ptr(trans));
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		x += size + 0.02f;
+		size *= 0.5f;
+	}
+}
+
+int main()
+{
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shaders for the full color sprite and the distance field
+	Shader rgbaShader("7.12.sprite.vs", "7.12.rgba.fs");
+	Shader sdfShader("7.12.sprite.vs", "7.12.sdf.fs");
+
+	// set up vertex data
+
+	float vertices[] = {
+		// positions          // texture coords
+		 1.0f,  1.0f, 0.0f,  1.0f, 1.0f,	// top right
+		 1.0f, -1.0f, 0.0f,  1.0f, 0.0f,	// bottom right
+		-1.0f, -1.0f, 0.0f,  0.0f, 0.0f,	// bottom left
+		-1.0f,  1.0f, 0.0f,  0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// texture attribute
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	// load the sprite, keep the full color version for comparison
+	// -----------------------------------------------------------
+	int width, heigth, nrChannel;
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* data = stbi_load("../../../resources/textures/awesomeface.png", &width, &heigth, &nrChannel, 0);
+	if (!data)
+	{
+		cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	unsigned int rgbaTexture = createImmutableTexture2D(data, width, heigth, nrChannel);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+
+	// bake the alpha mask into a 64x64 distance field, once per thread count
+	const int sdfSize = 64;
+	vector<unsigned char> sdf;
+	int cores = (int)std::thread::hardware_concurrency();
+	for (int threads = 1; threads <= (cores > 0 ? cores : 1); threads *= 2)
+	{
+		ThreadPool pool(threads);
+		SdfBakeStats stats;
+		sdf = bakeSDF(data, width, heigth, nrChannel, sdfSize, sdfSize, 4.0f, pool, &stats);
+		cout << "SDF bake " << width << "x" << heigth << " -> " << sdfSize << "x" << sdfSize << " (" << stats.isa
+			<< ", " << stats.threads << " threads): " << stats.seconds * 1000.0 << " ms" << endl;
+	}
+	stbi_image_free(data);
+	unsigned int sdfTexture = createSDFTexture(sdf, sdfSize, sdfSize);
+
+	cout << "texture memory: RGBA8 with mips " << textureMemoryBytes(rgbaTexture) / 1024 << " KB, SDF "
+		<< textureMemoryBytes(sdfTexture) / 1024.0 << " KB" << endl;
+
+	rgbaShader.use();
+	rgbaShader.setInt("spriteTexture", 0);
+	sdfShader.use();
+	sdfShader.setInt("sdfTexture", 0);
+	glUniform3f(glGetUniformLocation(sdfShader.ID, "tint"), 0.95f, 0.8f, 0.2f);
+
+	// to use background color where texture is transparent
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// bind the vertex array object
+		glBindVertexArray(VAO);
+		float time = (float)glfwGetTime();
+
+		// top row: full resolution RGBA with mipmaps
+		rgbaShader.use();
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, rgbaTexture);
+		drawSpriteRow(rgbaShader, 0.45f, time);
+
+		// bottom row: 64x64 single channel distance field
+		sdfShader.use();
+		glBindTexture(GL_TEXTURE_2D, sdfTexture);
+		drawSpriteRow(sdfShader, -0.45f, time);
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteTextures(1, &rgbaTexture);
+	glDeleteTextures(1, &sdfTexture);
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
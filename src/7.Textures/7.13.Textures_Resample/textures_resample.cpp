@@ -0,0 +1,226 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../../includes/stb_image.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/texture_storage.h"
+#include "../../../includes/learnopengl/image_resample.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// load an image and upload it within the global resolution budget
+unsigned int loadTexture(const char* path)
+{
+	int width, heigth, nrChannel;
+	unsigned char* data = stbi_load(path, &width, &heigth, &nrChannel, 0);
+	if (!data)
+	{
+		cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+		return 0;
+	}
+
+	vector<unsigned char> resampled;
+	int outWidth, outHeight;
+	ResampleStats stats;
+	unsigned int texture;
+	if (resampleToBudget(data, width, heigth, nrChannel, resampled, outWidth, outHeight, ResampleBudget::global(), &stats))
+	{
+		cout << path << ": " << width << "x" << heigth << " -> " << outWidth << "x" << outHeight << " (" << stats.isa
+			<< ", " << stats.threads << " threads): " << stats.seconds * 1000.0 << " ms" << endl;
+		texture = createImmutableTexture2D(&resampled[0], outWidth, outHeight, nrChannel);
+	}
+	else
+	{
+		cout << path << ": " << width << "x" << heigth << " fits the budget" << endl;
+		texture = createImmutableTexture2D(data, width, heigth, nrChannel);
+	}
+	stbi_image_free(data);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	cout << "  texture memory: " << textureMemoryBytes(texture) / 1024 << " KB" << endl;
+	return texture;
+}
+
+// usage: a.out [max texture size] [pot]
+// without arguments the budget comes from LOGL_MAX_TEXTURE_SIZE / LOGL_TEXTURE_POT
+int main(int argc, char** argv)
+{
+	ResampleBudget& budget = ResampleBudget::global();
+	if (argc > 1)
+		budget.maxSize = atoi(argv[1]);
+	if (argc > 2)
+		budget.powerOfTwo = strcmp(argv[2], "pot") == 0;
+	if (argc > 3)
+		budget.filter = strcmp(argv[3], "mitchell") == 0 ? RESAMPLE_MITCHELL : RESAMPLE_LANCZOS3;
+	cout << "texture budget: " << budget.maxSize << " texels (0 = unlimited)" << (budget.powerOfTwo ? ", power of two" : "")
+		<< (budget.filter == RESAMPLE_MITCHELL ? ", Mitchell" : ", Lanczos3") << endl;
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shader program
+	Shader ourShader("7.13.texture.vs", "7.13.texture.fs");
+
+	// set up vertex data
+
+	float vertices[] = {
+		// positions          // texture coords
+		 1.0f,  1.0f, 0.0f,  1.0f, 1.0f,	// top right
+		 1.0f, -1.0f, 0.0f,  1.0f, 0.0f,	// bottom right
+		-1.0f, -1.0f, 0.0f,  0.0f, 0.0f,	// bottom left
+		-1.0f,  1.0f, 0.0f,  0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// texture attribute
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 5 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	// load and create the textures within the budget
+	// -----------------------------------------------
+	stbi_set_flip_vertically_on_load(true);
+	unsigned int textures[2];
+	textures[0] = loadTexture("../../../resources/textures/container.jpg");
+	textures[1] = loadTexture("../../../resources/textures/awesomeface.png");
+	if (!textures[0] || !textures[1])
+	{
+		glfwTerminate();
+		return -1;
+	}
+
+	ourShader.use();
+	ourShader.setInt("texture1", 0);
+
+	// to use background color where texture is transparent
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// bind the vertex array object
+		glBindVertexArray(VAO);
+		ourShader.use();
+		glActiveTexture(GL_TEXTURE0);
+
+		// both textures side by side at their on screen size
+		for (int i = 0; i < 2; i++)
+		{
+			glm::mat4 trans = glm::mat4(1.0f);
+			trans = glm::translate(trans, glm::vec3(i == 0 ? -0.5f : 0.5f, 0.0f, 0.0f));
+			trans = glm::scale(trans, glm::vec3(0.45f, 0.6f, 1.0f));
+			glUniformMatrix4fv(glGetUniformLocation(ourShader.ID, "transform"), 1, GL_FALSE, glm::value_ptr(trans));
+			glBindTexture(GL_TEXTURE_2D, textures[i]);
+			glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteTextures(2, textures);
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,223 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/stripe_stream.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// procedural RGB image generated row by row, stands in for a decoder of a huge file
+class CheckerStripeSource : public StripeSource {
+public:
+	CheckerStripeSource(int w, int h)
+	{
+		width = w;
+		height = h;
+		channels = 3;
+	}
+
+	bool read(unsigned char* dst, int y, int rows)
+	{
+		for (int r = 0; r < rows; r++)
+		{
+			for (int x = 0; x < width; x++)
+			{
+				bool cell = ((x >> 8) + ((y + r) >> 8)) & 1;
+				unsigned char* p = dst + ((size_t)r * width + x) * 3;
+				p[0] = cell ? 230 : (unsigned char)(x * 255 / width);
+				p[1] = cell ? 200 : (unsigned char)((y + r) * 255 / height);
+				p[2] = cell ? 150 : 90;
+			}
+		}
+		return true;
+	}
+};
+
+int main(int argc, char* argv[])
+{
+	glfwInit();
+	// Set OpenGL version to 3.3 
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shader
+	Shader shader("7.9.texture.vs", "7.9.texture.fs");
+	
+	// set up vertex data
+
+	float vertices[] = {
+		// positions         // colors		   // texture coords
+		 0.5f,  0.5f, 0.0f,  1.0f, 0.0f, 0.0f, 1.0f, 1.0f,	// top right
+		 0.5f, -0.5f, 0.0f,  0.0f, 1.0f, 0.0f, 1.0f, 0.0f,	// bottom right
+		-0.5f, -0.5f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f, 0.0f,	// bottom left
+		-0.5f,  0.5f, 0.0f,  1.0f, 1.0f, 0.0f, 0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+	
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// color attribute
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+	// texture attribute
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+	glEnableVertexAttribArray(2);
+	
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	// stream the texture in stripes
+	// -----------------------------
+	// a PGM/PPM path on the command line is streamed from disk, otherwise a
+	// procedural image of the requested size (16384 by default) is generated
+	int maxSize;
+	glGetIntegerv(GL_MAX_TEXTURE_SIZE, &maxSize);
+	PnmStripeSource* file = NULL;
+	CheckerStripeSource* checker = NULL;
+	StripeSource* source;
+	if (argc > 1 && atoi(argv[1]) == 0)
+	{
+		file = new PnmStripeSource(argv[1]);
+		if (!file->valid())
+			cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+		source = file;
+	}
+	else
+	{
+		int size = argc > 1 ? atoi(argv[1]) : 16384;
+		if (size > maxSize)
+			size = maxSize;
+		checker = new CheckerStripeSource(size, size);
+		source = checker;
+	}
+
+	StripeStats stats;
+	double start = glfwGetTime();
+	unsigned int texture = streamTexture2D(*source, 64, 3, true, true, &stats);
+	glFinish();
+	double elapsed = glfwGetTime() - start;
+	if (texture)
+	{
+		cout << source->width << "x" << source->height << " streamed in " << stats.stripes << " stripes, "
+			<< elapsed * 1000.0 << " ms (" << stats.decodeWait * 1000.0 << " ms waiting on the decoder)" << endl;
+		cout << "peak host memory " << stats.peakHostBytes / 1024 << " KB, whole decoded image "
+			<< stats.imageBytes / 1024 << " KB" << endl;
+	}
+	else
+	{
+		cout << "ERROR::TEXTURE::STRIPE_STREAMING_FAILED" << endl;
+	}
+	delete file;
+	delete checker;
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// redering commands
+		
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// activate the shader program
+		shader.use();
+
+		// bind the vertex array object
+		glBindVertexArray(VAO);
+		// bind the texture
+		glBindTexture(GL_TEXTURE_2D, texture);
+		// draw the triangle
+		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteTextures(1, &texture);
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
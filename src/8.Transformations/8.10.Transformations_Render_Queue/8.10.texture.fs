@@ -0,0 +1,11 @@
+#version 330 core
+out vec4 FragColor;
+in vec3 ourColor;
+in vec2 TexCoord;
+
+uniform sampler2D tex;
+
+void main()
+{
+	FragColor = texture(tex, TexCoord);
+}
\ No newline at end of file
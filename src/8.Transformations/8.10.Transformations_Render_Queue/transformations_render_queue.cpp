@@ -0,0 +1,294 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../../includes/stb_image.h"
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/render_queue.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+bool sorted = true;
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	// toggle between sorted and submission order
+	static bool spacePressed = false;
+	bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+	if (space && !spacePressed)
+		sorted = !sorted;
+	spacePressed = space;
+}
+
+// load an image into a new texture with mipmaps, 0 when it can't be read
+unsigned int loadTexture(const char* path)
+{
+	int width, heigth, nrChannel;
+	unsigned char* data = stbi_load(path, &width, &heigth, &nrChannel, 0);
+	if (!data)
+	{
+		cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+		return 0;
+	}
+	unsigned int texture;
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// set the texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	GLenum format = nrChannel == 4 ? GL_RGBA : GL_RGB;
+	glTexImage2D(GL_TEXTURE_2D, 0, format, width, heigth, 0, format, GL_UNSIGNED_BYTE, data);
+	glGenerateMipmap(GL_TEXTURE_2D);
+	stbi_image_free(data);
+	return texture;
+}
+
+// one vertex array with its buffers, vertices as in 8.3: position, color, texture coords
+unsigned int createVertexArray(const float* vertices, size_t vertexBytes, const unsigned int* indices, size_t indexBytes,
+	unsigned int buffers[2])
+{
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(2, buffers);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, buffers[0]);
+	glBufferData(GL_ARRAY_BUFFER, vertexBytes, vertices, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffers[1]);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexBytes, indices, GL_STATIC_DRAW);
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// color attribute
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+	// texture attribute
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+	glEnableVertexAttribArray(2);
+	glBindVertexArray(0);
+	return VAO;
+}
+
+// an opaque container or triangle somewhere on screen
+struct SceneObject {
+	RenderCommand command;
+	glm::vec3 position;
+	float size, speed;
+};
+
+// the blended fractal of 8.4, parents submitted before their children
+void submit_fractal(RenderQueue& queue, const RenderCommand& command, glm::mat4 trans, int depth, float scale)
+{
+	if (depth == 0)
+		return;
+
+	queue.submit(command, 0.0f, glm::value_ptr(trans));
+
+	glm::mat4 children[3] = {
+		glm::scale(glm::translate(trans, glm::vec3(0, scale, 0.0f)), glm::vec3(scale)),
+		glm::scale(glm::translate(trans, glm::vec3(scale, -scale, 0.0f)), glm::vec3(scale)),
+		glm::scale(glm::translate(trans, glm::vec3(-scale, -scale, 0.0f)), glm::vec3(scale))
+	};
+	for (int k = 0; k < 3; k++)
+		submit_fractal(queue, command, children[k], depth - 1, scale);
+}
+
+// usage: a.out [object count] [fractal depth]
+// space toggles between sorted and submission order
+int main(int argc, char** argv)
+{
+	int count = argc > 1 ? max(0, atoi(argv[1])) : 2000;
+	int fractalDepth = argc > 2 ? max(0, min(atoi(argv[2]), 9)) : 6;
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	// no vsync, the frame rate is the benchmark
+	glfwSwapInterval(0);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shaders, one texture or two mixed
+	Shader textureShader("8.10.transform.vs", "8.10.texture.fs");
+	Shader mixShader("8.10.transform.vs", "8.10.mix.fs");
+
+	// set up vertex data, the container quad of 8.3 and the fractal triangle of 8.4
+	float quadVertices[] = {
+		// positions         // colors		   // texture coords
+		 0.5f,  0.5f, 0.0f,  1.0f, 0.0f, 0.0f, 1.0f, 1.0f,	// top right
+		 0.5f, -0.5f, 0.0f,  0.0f, 1.0f, 0.0f, 1.0f, 0.0f,	// bottom right
+		-0.5f, -0.5f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f, 0.0f,	// bottom left
+		-0.5f,  0.5f, 0.0f,  1.0f, 1.0f, 0.0f, 0.0f, 1.0f	// top left
+	};
+	unsigned int quadIndices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+	float triangleVertices[] = {
+		// positions         // colors		   // texture coords
+		-0.5f, 0.0f, 0.0f,  1.0f, 1.0f, 0.0f, -0.5f,  1.0f,	// top left
+		 0.5f, 0.0f, 0.0f,  1.0f, 0.0f, 0.0f,  1.5f,  1.0f,	// top right
+		 0.0f,-1.0f, 0.0f,  0.0f, 1.0f, 0.0f,  0.5f, -0.5f	// bottom
+	};
+	unsigned int triangleIndices[] = {
+		0, 1, 2
+	};
+	unsigned int quadBuffers[2], triangleBuffers[2];
+	unsigned int quadVAO = createVertexArray(quadVertices, sizeof(quadVertices), quadIndices, sizeof(quadIndices), quadBuffers);
+	unsigned int triangleVAO = createVertexArray(triangleVertices, sizeof(triangleVertices), triangleIndices,
+		sizeof(triangleIndices), triangleBuffers);
+
+	// load and create the textures
+	stbi_set_flip_vertically_on_load(true);
+	unsigned int container = loadTexture("../../../resources/textures/container.jpg");
+	unsigned int face = loadTexture("../../../resources/textures/awesomeface.png");
+
+	// tell OpenGL for each sampler to which texture unit it belongs
+	textureShader.use();
+	textureShader.setInt("tex", 0);
+	mixShader.use();
+	mixShader.setInt("texture1", 0);
+	mixShader.setInt("texture2", 1);
+	int textureTransform = glGetUniformLocation(textureShader.ID, "transform");
+	int mixTransform = glGetUniformLocation(mixShader.ID, "transform");
+
+	RenderQueue queue;
+	unsigned int both[2] = { container, face };
+	unsigned int containerSet = queue.addTextureSet(container);
+	unsigned int faceSet = queue.addTextureSet(face);
+	unsigned int mixSet = queue.addTextureSet(both, 2);
+
+	// objects with every combination of program, textures and shape, mixed in code order
+	vector<SceneObject> objects(count);
+	for (int i = 0; i < count; i++)
+	{
+		SceneObject& object = objects[i];
+		bool quad = rand() % 2 == 0;
+		int look = rand() % 3;
+		unsigned int program = look == 2 ? mixShader.ID : textureShader.ID;
+		unsigned int set = look == 0 ? containerSet : (look == 1 ? faceSet : mixSet);
+		object.command = renderElements(program, quad ? quadVAO : triangleVAO, set, quad ? 6 : 3, BLEND_NONE,
+			look == 2 ? mixTransform : textureTransform);
+		object.position = glm::vec3(rand() / (float)RAND_MAX * 2.0f - 1.0f, rand() / (float)RAND_MAX * 2.0f - 1.0f,
+			rand() / (float)RAND_MAX * 1.8f - 0.9f);
+		object.size = 0.05f + 0.1f * rand() / (float)RAND_MAX;
+		object.speed = rand() / (float)RAND_MAX * 4.0f - 2.0f;
+	}
+	RenderCommand fractal = renderElements(textureShader.ID, triangleVAO, faceSet, 3, BLEND_ALPHA, textureTransform);
+
+	// opaque objects overlap through the depth buffer, so their order is free
+	glEnable(GL_DEPTH_TEST);
+
+	double lastReport = glfwGetTime();
+	int frames = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// build this frame's draws in code order
+		float time = (float)glfwGetTime();
+		queue.clear();
+		for (int i = 0; i < count; i++)
+		{
+			const SceneObject& object = objects[i];
+			glm::mat4 trans = glm::translate(glm::mat4(1.0f), object.position);
+			trans = glm::rotate(trans, time * object.speed, glm::vec3(0.0f, 0.0f, 1.0f));
+			trans = glm::scale(trans, glm::vec3(object.size));
+			// NDC z of -1 to 1 as 0 to 1
+			queue.submit(object.command, object.position.z * 0.5f + 0.5f, glm::value_ptr(trans));
+		}
+		// the fractal in front of everything
+		submit_fractal(queue, fractal, glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -0.95f)), fractalDepth, 0.5f);
+		if (sorted)
+			queue.sort();
+
+		// redering commands
+
+		// clear the color and depth buffer
+		glClearColor(0.8f, 0.75f, 0.7f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+		// every draw in one pass
+		queue.execute();
+
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			const RenderQueue::Stats& stats = queue.statistics();
+			cout << (sorted ? "sorted" : "submission order") << ": " << stats.draws << " draws, " << stats.stateChanges
+				<< " state changes (" << stats.programBinds << " programs, " << stats.vertexArrayBinds << " VAOs, "
+				<< stats.textureBinds << " textures, " << stats.blendChanges << " blend)";
+			if (sorted)
+				cout << " instead of " << stats.submissionStateChanges << ", sort " << stats.sortSeconds * 1000.0 << " ms in "
+					<< stats.sortPasses << " passes";
+			cout << ", " << frames / (now - lastReport) << " fps" << endl;
+			frames = 0;
+			lastReport = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteVertexArrays(1, &quadVAO);
+	glDeleteVertexArrays(1, &triangleVAO);
+	glDeleteBuffers(2, quadBuffers);
+	glDeleteBuffers(2, triangleBuffers);
+	glDeleteTextures(1, &container);
+	glDeleteTextures(1, &face);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,344 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../../includes/stb_image.h"
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/gl_state.h"
+#include "../../../includes/learnopengl/command_buffer.h"
+
+using namespace std;
+
+GLState* state = NULL;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	state->viewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// a container circling a moving center, the way 8.3 moves its two
+struct SceneObject {
+	glm::vec2 center;
+	float orbit, orbitSpeed, spin, size;
+};
+
+// GL names and uniform locations the recorded commands refer to
+struct DrawSetup {
+	unsigned int program, VAO, texture1, texture2;
+	int transformLoc;
+};
+
+vector<SceneObject> makeScene(int count)
+{
+	vector<SceneObject> objects(count);
+	for (int i = 0; i < count; i++)
+	{
+		objects[i].center = glm::vec2(rand() / (float)RAND_MAX * 2.4f - 1.2f, rand() / (float)RAND_MAX * 2.4f - 1.2f);
+		objects[i].orbit = 0.05f + 0.2f * rand() / (float)RAND_MAX;
+		objects[i].orbitSpeed = rand() / (float)RAND_MAX * 2.0f - 1.0f;
+		objects[i].spin = rand() / (float)RAND_MAX * 6.0f - 3.0f;
+		objects[i].size = 0.02f + 0.05f * rand() / (float)RAND_MAX;
+	}
+	return objects;
+}
+
+// scene preparation for objects [begin, end): animate, skip what is off screen
+// and record the draws, binding everything each time like a naive draw loop
+void record_objects(CommandBuffer& commands, const vector<SceneObject>& objects, const DrawSetup& setup, float time,
+	int begin, int end)
+{
+	for (int i = begin; i < end; i++)
+	{
+		const SceneObject& object = objects[i];
+		float angle = time * object.orbitSpeed;
+		glm::vec2 position = object.center + object.orbit * glm::vec2(cos(angle), sin(angle));
+		// the quad reaches half its size diagonally past the position
+		float radius = object.size * 0.75f;
+		if (position.x + radius < -1.0f || position.x - radius > 1.0f || position.y + radius < -1.0f || position.y - radius > 1.0f)
+			continue;
+
+		glm::mat4 trans = glm::mat4(1.0f);
+		trans = glm::translate(trans, glm::vec3(position, 0.0f));
+		trans = glm::rotate(trans, time * object.spin, glm::vec3(0.0f, 0.0f, 1.0f));
+		float pulse = (sin(time + i) + 2.0f) / 3.0f;
+		trans = glm::scale(trans, glm::vec3(object.size * pulse));
+
+		commands.useProgram(setup.program);
+		commands.bindVertexArray(setup.VAO);
+		commands.bindTexture(0, GL_TEXTURE_2D, setup.texture1);
+		commands.bindTexture(1, GL_TEXTURE_2D, setup.texture2);
+		commands.uniformMatrix4(setup.transformLoc, glm::value_ptr(trans));
+		commands.drawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT);
+	}
+}
+
+// recording time on 1 to all cores, no GL needed
+void benchmark(int count)
+{
+	vector<SceneObject> objects = makeScene(count);
+	DrawSetup setup = { 1, 1, 1, 2, 0 };
+	cout << count << " objects" << endl;
+
+	int cores = max(1, (int)thread::hardware_concurrency());
+	double single = 0.0;
+	for (int threads = 1; ; threads = min(threads * 2, cores))
+	{
+		ThreadPool pool(threads);
+		ParallelRecorder recorder(pool);
+		double best = 1e30;
+		for (int run = 0; run < 5; run++)
+		{
+			float time = run * 0.1f;
+			recorder.record(count, [&](CommandBuffer& commands, int begin, int end) {
+				record_objects(commands, objects, setup, time, begin, end);
+			});
+			best = min(best, recorder.statistics().recordSeconds);
+		}
+		if (threads == 1)
+			single = best;
+		const ParallelRecorder::Stats& stats = recorder.statistics();
+		cout << "  " << threads << " threads: " << best * 1000.0 << " ms for " << stats.commands << " commands ("
+			<< stats.bytes / 1024 << " KB), " << single / best << "x" << endl;
+		if (threads == cores)
+			break;
+	}
+}
+
+// usage: a.out [object count]
+//        a.out bench [object count]
+int main(int argc, char** argv)
+{
+	bool bench = argc > 1 && strcmp(argv[1], "bench") == 0;
+	int first = bench ? 2 : 1;
+	int count = argc > first ? max(1, atoi(argv[first])) : 20000;
+	if (bench)
+	{
+		benchmark(count);
+		return 0;
+	}
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	// no vsync, the frame rate is the benchmark
+	glfwSwapInterval(0);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	state = new GLState();
+
+	// inform OpenGL about window size and set callback when it's changed
+	state->viewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shader
+	Shader shader("8.11.transform.vs", "8.11.transform.fs");
+
+	// set up vertex data
+
+	float vertices[] = {
+		// positions         // colors		   // texture coords
+		 0.5f,  0.5f, 0.0f,  1.0f, 0.0f, 0.0f, 1.0f, 1.0f,	// top right
+		 0.5f, -0.5f, 0.0f,  0.0f, 1.0f, 0.0f, 1.0f, 0.0f,	// bottom right
+		-0.5f, -0.5f, 0.0f,  0.0f, 0.0f, 1.0f, 0.0f, 0.0f,	// bottom left
+		-0.5f,  0.5f, 0.0f,  1.0f, 1.0f, 0.0f, 0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// color attribute
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+	// texture attribute
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
+	glEnableVertexAttribArray(2);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	// load and create a texture
+	// -------------------------
+	unsigned int texture1, texture2;
+	// texture 1
+	// ---------
+	glGenTextures(1, &texture1);
+	glBindTexture(GL_TEXTURE_2D, texture1);
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set the texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// load image, create texture and generate mipmaps
+	int width, heigth, nrChannel;
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* data = stbi_load("../../../resources/textures/container.jpg", &width, &heigth, &nrChannel, 0);
+	if (data)
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, heigth, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	else
+	{
+		cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+	}
+	stbi_image_free(data);
+	// texture 2
+	// ---------
+	glGenTextures(1, &texture2);
+	glBindTexture(GL_TEXTURE_2D, texture2);
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	// set the texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	// load image, create texture and generate mipmaps
+	data = stbi_load("../../../resources/textures/awesomeface.png", &width, &heigth, &nrChannel, 0);
+	if (data)
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, heigth, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	else
+	{
+		cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+	}
+	stbi_image_free(data);
+
+	// tell OpenGL for each sampler to which texture unit it belongs
+	shader.use();
+	shader.setInt("texture1", 0);
+	shader.setInt("texture2", 1);
+
+	vector<SceneObject> objects = makeScene(count);
+	DrawSetup setup = { shader.ID, VAO, texture1, texture2, glGetUniformLocation(shader.ID, "transform") };
+	ParallelRecorder recorder;
+	double lastReport = glfwGetTime();
+	double recordSeconds = 0.0, executeSeconds = 0.0;
+	int frames = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// scene preparation on all cores, nothing here touches GL
+		float time = (float)glfwGetTime();
+		recorder.record(count, [&](CommandBuffer& commands, int begin, int end) {
+			record_objects(commands, objects, setup, time, begin, end);
+		});
+
+		// redering commands
+
+		// clear the color buffer
+		state->clearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// replay in object order on this thread, repeated binds stop at the state tracker
+		recorder.execute(state);
+		state->endFrame();
+
+		const ParallelRecorder::Stats& stats = recorder.statistics();
+		recordSeconds += stats.recordSeconds;
+		executeSeconds += stats.executeSeconds;
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			cout << "record " << recordSeconds * 1000.0 / frames << " ms on " << stats.threads << " threads (" << stats.ranges
+				<< " ranges), replay " << executeSeconds * 1000.0 / frames << " ms, " << stats.commands << " commands in "
+				<< stats.bytes / 1024 << " KB, " << state->lastFrame().totalElided() << " binds elided, "
+				<< frames / (now - lastReport) << " fps" << endl;
+			recordSeconds = executeSeconds = 0.0;
+			frames = 0;
+			lastReport = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteTextures(1, &texture1);
+	glDeleteTextures(1, &texture2);
+	delete state;
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,21 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;
+// instanced 0, 1, 2, ..., follows the base instance of indirect draws
+layout(location = 1) in uint drawIndex;
+
+// per draw: position, scale and rotation, then color
+uniform samplerBuffer drawData;
+// first draw of an instanced group when there is no base instance
+uniform int drawBase;
+
+out vec4 ourColor;
+
+void main()
+{
+	int index = int(drawIndex) + drawBase;
+	vec4 place = texelFetch(drawData, index * 2);
+	ourColor = texelFetch(drawData, index * 2 + 1);
+	float c = cos(place.w), s = sin(place.w);
+	vec2 rotated = mat2(c, s, -s, c) * aPos;
+	gl_Position = vec4(place.xy + rotated * place.z, 0.0, 1.0);
+}
\ No newline at end of file
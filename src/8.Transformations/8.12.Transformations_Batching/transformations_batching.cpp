@@ -0,0 +1,244 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/buffer_arena.h"
+#include "../../../includes/learnopengl/draw_batcher.h"
+
+using namespace std;
+
+// how the objects reach the GPU, SPACE cycles
+enum DrawMode { DIRECT, INDIRECT, INSTANCED, MODE_COUNT };
+const char* modeNames[MODE_COUNT] = { "direct", "multi draw indirect", "instanced groups" };
+int mode = INDIRECT;
+bool indirectAvailable = false;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	static bool spaceDown = false;
+	bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+	if (space && !spaceDown)
+	{
+		mode = (mode + 1) % MODE_COUNT;
+		if (mode == INDIRECT && !indirectAvailable)
+			mode = INSTANCED;
+		cout << "drawing with " << modeNames[mode] << endl;
+	}
+	spaceDown = space;
+}
+
+// a spinning shape circling a moving center, like the containers of 8.3
+struct SceneObject {
+	unsigned int mesh;
+	glm::vec2 center;
+	float orbit, orbitSpeed, spin, size;
+	float color[4];
+};
+
+// regular polygon, or a star when 'star' is set, fanned around its center
+unsigned int addShape(BufferArena& arena, int points, bool star)
+{
+	vector<float> vertices;
+	vector<unsigned int> indices;
+	vertices.push_back(0.0f);
+	vertices.push_back(0.0f);
+	int rim = star ? points * 2 : points;
+	for (int i = 0; i < rim; i++)
+	{
+		float angle = 2.0f * 3.14159265f * i / rim;
+		float radius = star && (i % 2) ? 0.45f : 1.0f;
+		vertices.push_back(radius * cos(angle));
+		vertices.push_back(radius * sin(angle));
+		indices.push_back(0);
+		indices.push_back(1 + i);
+		indices.push_back(1 + (i + 1) % rim);
+	}
+	return arena.add(&vertices[0], (unsigned int)vertices.size() / 2, &indices[0], (unsigned int)indices.size());
+}
+
+vector<SceneObject> makeScene(int count, const vector<unsigned int>& meshes)
+{
+	vector<SceneObject> objects(count);
+	for (int i = 0; i < count; i++)
+	{
+		SceneObject& object = objects[i];
+		object.mesh = meshes[rand() % meshes.size()];
+		object.center = glm::vec2(rand() / (float)RAND_MAX * 2.0f - 1.0f, rand() / (float)RAND_MAX * 2.0f - 1.0f);
+		object.orbit = 0.02f + 0.1f * rand() / (float)RAND_MAX;
+		object.orbitSpeed = rand() / (float)RAND_MAX * 2.0f - 1.0f;
+		object.spin = rand() / (float)RAND_MAX * 6.0f - 3.0f;
+		object.size = 0.01f + 0.02f * rand() / (float)RAND_MAX;
+		float hue = rand() / (float)RAND_MAX;
+		object.color[0] = 0.5f + 0.5f * cos(6.2831853f * hue);
+		object.color[1] = 0.5f + 0.5f * cos(6.2831853f * (hue + 0.33f));
+		object.color[2] = 0.5f + 0.5f * cos(6.2831853f * (hue + 0.67f));
+		object.color[3] = 1.0f;
+	}
+	return objects;
+}
+
+// animate every object and hand its draw to the batcher in scene order
+void addObjects(DrawBatcher& batcher, const BufferArena& arena, const vector<SceneObject>& objects, float time)
+{
+	batcher.clear();
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const SceneObject& object = objects[i];
+		float angle = time * object.orbitSpeed;
+		float pulse = (sin(time + i) + 2.0f) / 3.0f;
+		float values[8] = {
+			object.center.x + object.orbit * cos(angle), object.center.y + object.orbit * sin(angle),
+			object.size * pulse, time * object.spin,
+			object.color[0], object.color[1], object.color[2], object.color[3]
+		};
+		batcher.add(arena.range(object.mesh), values);
+	}
+}
+
+// usage: a.out [object count]
+int main(int argc, char** argv)
+{
+	int count = argc > 1 ? max(1, atoi(argv[1])) : 10000;
+
+	glfwInit();
+	// glMultiDrawElementsIndirect and base instance need OpenGL 4.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		// batch with instancing instead
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	}
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	// no vsync, the frame rate is the benchmark
+	glfwSwapInterval(0);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+	indirectAvailable = GLAD_GL_VERSION_4_3 != 0;
+	if (!indirectAvailable)
+		mode = INSTANCED;
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shader
+	Shader shader("8.12.batch.vs", "8.12.batch.fs");
+
+	// every shape in one vertex and one index buffer, so one VAO draws them all
+	BufferArena* arena = new BufferArena(2 * sizeof(float), 1024, 4096);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	glBindVertexArray(0);
+
+	vector<unsigned int> meshes;
+	meshes.push_back(addShape(*arena, 3, false));
+	meshes.push_back(addShape(*arena, 4, false));
+	meshes.push_back(addShape(*arena, 6, false));
+	meshes.push_back(addShape(*arena, 5, true));
+	meshes.push_back(addShape(*arena, 8, true));
+
+	// one batcher per program and state combination, this scene has one
+	DrawBatcher* batcher = new DrawBatcher(arena->vertexArray(), 1, 8, arena->indexType());
+	vector<SceneObject> objects = makeScene(count, meshes);
+
+	shader.use();
+	shader.setInt("drawData", 0);
+	int drawBaseLoc = glGetUniformLocation(shader.ID, "drawBase");
+
+	cout << count << " objects, " << meshes.size() << " meshes, drawing with " << modeNames[mode]
+		<< (indirectAvailable ? "" : " (no OpenGL 4.3)") << endl;
+	double lastReport = glfwGetTime();
+	double submitSeconds = 0.0;
+	int frames = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		addObjects(*batcher, *arena, objects, (float)glfwGetTime());
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		double submitStart = glfwGetTime();
+		shader.use();
+		batcher->bind(0);
+		if (mode == DIRECT)
+			batcher->drawDirect(drawBaseLoc);
+		else
+		{
+			batcher->setIndirect(mode == INDIRECT);
+			batcher->draw(drawBaseLoc);
+		}
+		submitSeconds += glfwGetTime() - submitStart;
+
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			const DrawBatcher::Stats& stats = batcher->statistics();
+			cout << modeNames[mode] << ": " << stats.draws << " draws in " << stats.calls << " GL calls";
+			if (stats.commands)
+				cout << " (" << stats.commands << " indirect commands)";
+			cout << ", submit " << submitSeconds * 1000.0 / frames << " ms, " << frames / (now - lastReport) << " fps"
+				<< endl;
+			submitSeconds = 0.0;
+			frames = 0;
+			lastReport = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	delete batcher;
+	delete arena;
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,13 @@
+#version 330 core
+layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aColor;
+// per instance, the view already applied
+layout(location = 3) in mat4 aTransform;
+
+out vec3 ourColor;
+
+void main()
+{
+	gl_Position = aTransform * vec4(aPos, 1.0);
+	ourColor = aColor;
+}
\ No newline at end of file
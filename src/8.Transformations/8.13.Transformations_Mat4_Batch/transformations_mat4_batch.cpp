@@ -0,0 +1,405 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/mat4_batch.h"
+
+using namespace std;
+
+// SPACE switches between the batched kernels and glm one matrix at a time
+bool useKernels = true;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	static bool spaceDown = false;
+	bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+	if (space && !spaceDown)
+	{
+		useKernels = !useKernels;
+		cout << "composing with " << (useKernels ? mat4Kernels().isa : "glm") << endl;
+	}
+	spaceDown = space;
+}
+
+float randomFloat(float low, float high)
+{
+	return low + (high - low) * rand() / (float)RAND_MAX;
+}
+
+// translation, rotation and scale of every object as separate arrays
+struct TRSArrays {
+	vector<float> tx, ty, tz, qx, qy, qz, qw, sx, sy, sz;
+
+	void resize(size_t count)
+	{
+		vector<float>* all[10] = { &tx, &ty, &tz, &qx, &qy, &qz, &qw, &sx, &sy, &sz };
+		for (int i = 0; i < 10; i++)
+			all[i]->resize(count);
+	}
+
+	Mat4TRS view() const
+	{
+		Mat4TRS trs = { &tx[0], &ty[0], &tz[0], &qx[0], &qy[0], &qz[0], &qw[0], &sx[0], &sy[0], &sz[0] };
+		return trs;
+	}
+};
+
+// a container circling a moving center and spinning, like the ones of 8.3
+struct SceneObject {
+	glm::vec2 center;
+	float orbit, orbitSpeed, spin, size;
+};
+
+vector<SceneObject> makeScene(int count)
+{
+	vector<SceneObject> objects(count);
+	for (int i = 0; i < count; i++)
+	{
+		objects[i].center = glm::vec2(randomFloat(-1.2f, 1.2f), randomFloat(-1.2f, 1.2f));
+		objects[i].orbit = randomFloat(0.05f, 0.25f);
+		objects[i].orbitSpeed = randomFloat(-1.0f, 1.0f);
+		objects[i].spin = randomFloat(-3.0f, 3.0f);
+		objects[i].size = randomFloat(0.02f, 0.07f);
+	}
+	return objects;
+}
+
+// this frame's translation, rotation about z and scale of every object
+void animate(const vector<SceneObject>& objects, float time, TRSArrays& trs)
+{
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		const SceneObject& object = objects[i];
+		float angle = time * object.orbitSpeed, half = 0.5f * time * object.spin;
+		float pulse = object.size * (sin(time + i) + 2.0f) / 3.0f;
+		trs.tx[i] = object.center.x + object.orbit * cos(angle);
+		trs.ty[i] = object.center.y + object.orbit * sin(angle);
+		trs.tz[i] = 0.0f;
+		trs.qx[i] = trs.qy[i] = 0.0f;
+		trs.qz[i] = sin(half);
+		trs.qw[i] = cos(half);
+		trs.sx[i] = trs.sy[i] = trs.sz[i] = pulse;
+	}
+}
+
+// what the kernels replace: model and view matrix of every object, one at a time
+void composeGLM(const TRSArrays& trs, const glm::mat4& view, glm::mat4* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(trs.tx[i], trs.ty[i], trs.tz[i]));
+		model = model * glm::mat4_cast(glm::quat(trs.qw[i], trs.qx[i], trs.qy[i], trs.qz[i]));
+		model = glm::scale(model, glm::vec3(trs.sx[i], trs.sy[i], trs.sz[i]));
+		out[i] = view * model;
+	}
+}
+
+// fastest of a few runs in seconds
+template <typename Run>
+double bestTime(const Run& run)
+{
+	double best = 1e30;
+	for (int i = 0; i < 5; i++)
+	{
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		run();
+		best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+	}
+	return best;
+}
+
+// largest difference to glm, relative to the magnitude of glm's value
+double maxError(const float* result, const float* reference, size_t floats)
+{
+	double error = 0.0;
+	for (size_t i = 0; i < floats; i++)
+		error = max(error, fabs((double)result[i] - reference[i]) / max(1.0, fabs((double)reference[i])));
+	return error;
+}
+
+// throughput of every kernel on every supported instruction set against glm
+void benchmark(size_t count)
+{
+	vector<glm::mat4> a(count), b(count), out(count), reference(count);
+	vector<glm::vec4> points4(count);
+	vector<float> points(count * 3), transformed(count * 4);
+	glm::mat4 m;
+	for (int k = 0; k < 16; k++)
+		glm::value_ptr(m)[k] = randomFloat(-1.0f, 1.0f);
+	for (size_t i = 0; i < count; i++)
+	{
+		for (int k = 0; k < 16; k++)
+		{
+			glm::value_ptr(a[i])[k] = randomFloat(-1.0f, 1.0f);
+			glm::value_ptr(b[i])[k] = randomFloat(-1.0f, 1.0f);
+		}
+		for (int k = 0; k < 3; k++)
+			points[i * 3 + k] = randomFloat(-10.0f, 10.0f);
+	}
+	TRSArrays trs;
+	trs.resize(count);
+	for (size_t i = 0; i < count; i++)
+	{
+		glm::quat q = glm::normalize(glm::quat(randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f), randomFloat(-1.0f, 1.0f),
+			randomFloat(-1.0f, 1.0f)));
+		trs.qx[i] = q.x;
+		trs.qy[i] = q.y;
+		trs.qz[i] = q.z;
+		trs.qw[i] = q.w;
+		trs.tx[i] = randomFloat(-5.0f, 5.0f);
+		trs.ty[i] = randomFloat(-5.0f, 5.0f);
+		trs.tz[i] = randomFloat(-5.0f, 5.0f);
+		trs.sx[i] = randomFloat(0.1f, 3.0f);
+		trs.sy[i] = randomFloat(0.1f, 3.0f);
+		trs.sz[i] = randomFloat(0.1f, 3.0f);
+	}
+	Mat4TRS arrays = trs.view();
+	cout << count << " matrices, 1 thread, M per second (speedup over glm, largest relative difference to glm)" << endl;
+
+	const char* names[4] = { "multiply N by N", "multiply one by N", "transform N points", "compose N TRS" };
+	for (int op = 0; op < 4; op++)
+	{
+		// glm first, it is also the reference
+		double glmTime = 0.0;
+		const float* expected = glm::value_ptr(reference[0]);
+		const float* result = glm::value_ptr(out[0]);
+		size_t floats = count * 16;
+		if (op == 0)
+			glmTime = bestTime([&]() { for (size_t i = 0; i < count; i++) reference[i] = a[i] * b[i]; });
+		else if (op == 1)
+			glmTime = bestTime([&]() { for (size_t i = 0; i < count; i++) reference[i] = m * b[i]; });
+		else if (op == 2)
+		{
+			glmTime = bestTime([&]() {
+				for (size_t i = 0; i < count; i++)
+					points4[i] = m * glm::vec4(points[i * 3], points[i * 3 + 1], points[i * 3 + 2], 1.0f);
+			});
+			expected = glm::value_ptr(points4[0]);
+			result = &transformed[0];
+			floats = count * 4;
+		}
+		else
+			glmTime = bestTime([&]() { composeGLM(trs, glm::mat4(1.0f), &reference[0], count); });
+		cout << "  " << names[op] << ": glm " << count / glmTime / 1e6;
+
+		for (int isa = 0; isa < MAT4_ISA_COUNT; isa++)
+		{
+			if (!mat4Supported(isa))
+				continue;
+			Mat4Kernels kernels = mat4KernelsFor(isa);
+			double seconds;
+			if (op == 0)
+				seconds = bestTime([&]() { kernels.multiply(glm::value_ptr(a[0]), glm::value_ptr(b[0]), glm::value_ptr(out[0]), count); });
+			else if (op == 1)
+				seconds = bestTime([&]() { kernels.multiplyOne(glm::value_ptr(m), glm::value_ptr(b[0]), glm::value_ptr(out[0]), count); });
+			else if (op == 2)
+				seconds = bestTime([&]() { kernels.transformPoints(glm::value_ptr(m), &points[0], &transformed[0], count); });
+			else
+				seconds = bestTime([&]() { kernels.composeTRS(arrays, glm::value_ptr(out[0]), count); });
+			cout << ", " << kernels.isa << " " << count / seconds / 1e6 << " (" << glmTime / seconds << "x, "
+				<< maxError(result, expected, floats) << ")";
+		}
+		cout << endl;
+	}
+}
+
+// usage: a.out [object count]
+//        a.out bench [matrix count]
+int main(int argc, char** argv)
+{
+	bool bench = argc > 1 && strcmp(argv[1], "bench") == 0;
+	int first = bench ? 2 : 1;
+	if (bench)
+	{
+		benchmark(argc > first ? max(1, atoi(argv[first])) : 100000);
+		return 0;
+	}
+	int count = argc > first ? max(1, atoi(argv[first])) : 50000;
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	// no vsync, the frame rate is the benchmark
+	glfwSwapInterval(0);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shader
+	Shader shader("8.13.instanced.vs", "8.13.instanced.fs");
+
+	// set up vertex data
+
+	float vertices[] = {
+		// positions         // colors
+		 0.5f,  0.5f, 0.0f,  1.0f, 0.0f, 0.0f,	// top right
+		 0.5f, -0.5f, 0.0f,  0.0f, 1.0f, 0.0f,	// bottom right
+		-0.5f, -0.5f, 0.0f,  0.0f, 0.0f, 1.0f,	// bottom left
+		-0.5f,  0.5f, 0.0f,  1.0f, 1.0f, 0.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object, element buffer object and the per instance matrices
+	unsigned int VBO, EBO, instanceVBO;
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+	glGenBuffers(1, &instanceVBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	// position attribute
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	// color attribute
+	glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+	// transform attribute, a mat4 takes four locations, one column each
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::mat4), NULL, GL_STREAM_DRAW);
+	for (int column = 0; column < 4; column++)
+	{
+		glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(column * 4 * sizeof(float)));
+		glEnableVertexAttribArray(3 + column);
+		glVertexAttribDivisor(3 + column, 1);
+	}
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	vector<SceneObject> objects = makeScene(count);
+	TRSArrays trs;
+	trs.resize(count);
+	vector<glm::mat4> transforms(count);
+	cout << count << " objects, kernels: " << mat4Kernels().isa << endl;
+
+	double lastReport = glfwGetTime();
+	double composeSeconds = 0.0;
+	int frames = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		float time = (float)glfwGetTime();
+		animate(objects, time, trs);
+
+		// the view slowly turns and breathes around the scene
+		glm::mat4 view = glm::rotate(glm::mat4(1.0f), 0.1f * time, glm::vec3(0.0f, 0.0f, 1.0f));
+		view = glm::scale(view, glm::vec3(0.8f + 0.1f * sin(0.3f * time)));
+
+		// model and model-view matrix of every object
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		float* out = glm::value_ptr(transforms[0]);
+		if (useKernels)
+		{
+			mat4ComposeTRS(trs.view(), out, count);
+			mat4MultiplyOne(glm::value_ptr(view), out, out, count);
+		}
+		else
+			composeGLM(trs, view, &transforms[0], count);
+		composeSeconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(glm::mat4), out);
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// every container in one instanced draw
+		shader.use();
+		glBindVertexArray(VAO);
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, count);
+
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			cout << (useKernels ? mat4Kernels().isa : "glm") << ": " << composeSeconds * 1000.0 / frames << " ms for "
+				<< count << " transforms, " << frames / (now - lastReport) << " fps" << endl;
+			composeSeconds = 0.0;
+			frames = 0;
+			lastReport = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteBuffers(1, &instanceVBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -9,15 +9,27 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstring>
+#include <vector>
 
 #include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/damage_tracker.h"
 
 using namespace std;
 
+// only the damaged parts of the picture are redrawn, in the window's back buffer
+// when EGL reports its age and in an offscreen image otherwise. SPACE switches
+// to redrawing everything for comparison
+DamagePresenter* presenter = NULL;
+DamageTracker* tracker = NULL;
+bool damageTracking = true;
+
 // callback method for change in window size
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
 	glViewport(0, 0, width, height);
+	presenter->resize(width, height);
+	tracker->resize(width, height);
 }
 
 // process inputs in each iteration of render loop
@@ -25,10 +37,23 @@ void processInput(GLFWwindow* window)
 {
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, true);
+
+	static bool spaceDown = false;
+	bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+	if (space && !spaceDown)
+	{
+		damageTracking = !damageTracking;
+		cout << (damageTracking ? "redrawing damaged rectangles" : "redrawing everything") << endl;
+	}
+	spaceDown = space;
 }
 
-int main()
+// usage: a.out [full]
+int main(int argc, char** argv)
 {
+	if (argc > 1 && strcmp(argv[1], "full") == 0)
+		damageTracking = false;
+
 	glfwInit();
 	// Set OpenGL version to 3.3 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -36,10 +61,18 @@ int main()
 	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 	// for Mac OS X, uncomment the following line
 	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+	// an EGL surface can report the age of its back buffer
+	glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
 
 	// create GLFW window
 	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
 	if (window == NULL)
+	{
+		// the platform's own context API then, drawing offscreen
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_NATIVE_CONTEXT_API);
+		window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	}
+	if (window == NULL)
 	{
 		cout << "Failed to create GLFW window" << endl;
 		glfwTerminate();
@@ -56,7 +89,12 @@ int main()
 
 	// inform OpenGL about window size and set callback when it's changed
 	glViewport(0, 0, 800, 600);
+	presenter = new DamagePresenter(window, 800, 600);
+	tracker = new DamageTracker();
+	tracker->resize(800, 600);
 	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+	cout << (presenter->direct() ? "drawing into the window (EGL_EXT_buffer_age)" : "drawing into a retained image")
+		<< (presenter->damageHints() ? ", swapping with damage" : "") << endl;
 
 	// create shader
 	Shader shader("8.3.transform.vs", "8.3.transform.fs");
@@ -168,58 +206,91 @@ int main()
 	shader.setInt("texture1", 0);
 	shader.setInt("texture2", 1);
 
+	unsigned int transformLoc = glGetUniformLocation(shader.ID, "transform");
+	double lastReport = glfwGetTime();
+	double damagedFraction = 0.0;
+	int frames = 0;
+
 	// render loop
 	while (!glfwWindowShouldClose(window))
 	{
 		// input
 		processInput(window);
 
+		// first container rotates, second one scales
+		glm::mat4 trans[2];
+		trans[0] = glm::mat4(1.0f);
+		trans[0] = glm::translate(trans[0], glm::vec3(0.5, -0.5, 0.0f));
+		trans[0] = glm::rotate(trans[0], (float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));
+		trans[1] = glm::mat4(1.0f);
+		trans[1] = glm::translate(trans[1], glm::vec3(-0.5f, 0.5f, 0.0f));
+		float scale = (sin(glfwGetTime()) + 2) / 3;
+		trans[1] = glm::scale(trans[1], glm::vec3(scale, scale, scale));
+
+		// both change every frame: damage where they were and where they are now
+		DamageRect bounds[2];
+		for (int i = 0; i < 2; i++)
+		{
+			bounds[i] = damageBounds(glm::value_ptr(trans[i]), -0.5f, -0.5f, 0.5f, 0.5f, presenter->width(),
+				presenter->height());
+			tracker->update(i, bounds[i]);
+		}
+		if (!damageTracking)
+			tracker->invalidate();
+
 		// redering commands
-		
-		// clear the color buffer
-		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT);
+		// the back buffer may be a few frames old, the damage since then is redrawn
+		const vector<DamageRect>& damage = tracker->collect(presenter->beginFrame());
 
 		// activate the shader program
 		shader.use();
 
 		// bind the vertex array object
 		glBindVertexArray(VAO);
-		
+
 		// bind the textures
 		glActiveTexture(GL_TEXTURE0);
 		glBindTexture(GL_TEXTURE_2D, texture1);
 		glActiveTexture(GL_TEXTURE1);
 		glBindTexture(GL_TEXTURE_2D, texture2);
 
-		// first container
-		// ---------------
-		// set uniform for transform matrix
-		glm::mat4 trans = glm::mat4(1.0f);
-		trans = glm::translate(trans, glm::vec3(0.5, -0.5, 0.0f));
-		trans = glm::rotate(trans, (float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));
-
-		unsigned int transformLoc = glGetUniformLocation(shader.ID, "transform");
-		glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(trans));
-
-		// draw the triangles
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-		// second container
-		// ----------------
-		// set uniform for transform matrix
-		trans = glm::mat4(1.0f);
-		trans = glm::translate(trans, glm::vec3(-0.5f, 0.5f, 0.0f));
-		float scale = (sin(glfwGetTime()) + 2) / 3;
-		trans = glm::scale(trans, glm::vec3(scale, scale, scale));
-
-		glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(trans));
-
-		// draw the triangles
-		glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-		// swap the buffers and poll IO events
-		glfwSwapBuffers(window);
+		// clear and redraw only inside the damaged rectangles, the rest of the
+		// image is still valid from the frames before
+		glEnable(GL_SCISSOR_TEST);
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		for (size_t r = 0; r < damage.size(); r++)
+		{
+			glScissor(damage[r].x, damage[r].y, damage[r].width, damage[r].height);
+			glClear(GL_COLOR_BUFFER_BIT);
+			for (int i = 0; i < 2; i++)
+			{
+				if (!bounds[i].intersects(damage[r]))
+					continue;
+				// set uniform for transform matrix
+				glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(trans[i]));
+				// draw the triangles
+				glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+			}
+		}
+		glDisable(GL_SCISSOR_TEST);
+
+		damagedFraction += tracker->damagedFraction();
+
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			cout << (damageTracking ? "damage tracked: " : "full redraw: ") << damage.size() << " rectangles, "
+				<< damagedFraction * 100.0 / frames << "% of the pixels redrawn, " << frames / (now - lastReport) << " fps"
+				<< endl;
+			damagedFraction = 0.0;
+			frames = 0;
+			lastReport = now;
+		}
+
+		// swap the buffers, telling the compositor what changed, and poll IO events
+		presenter->swap(damage);
+		tracker->endFrame();
 		glfwPollEvents();
 	}
 
@@ -227,6 +298,8 @@ int main()
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
 	glDeleteBuffers(1, &EBO);
+	delete presenter;
+	delete tracker;
 
 	// glfw: terminate, clean all previously allocated GLFW resources
 	glfwTerminate();
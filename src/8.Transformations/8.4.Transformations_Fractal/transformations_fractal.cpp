@@ -9,57 +9,124 @@
 
 #include <iostream>
 #include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
 
 #include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/gl_state.h"
 
 using namespace std;
 
+// every per frame state change goes through the tracker, so repeated binds never reach GL
+GLState* state = NULL;
+
 // callback method for change in window size
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-	glViewport(0, 0, width, height);
+	state->viewport(0, 0, width, height);
 }
 
+// depth and scale of the fractal, changed with the arrow keys
+int depth = 7;
+float scale = 0.5f;
+bool instanced = true;
+
 // process inputs in each iteration of render loop
 void processInput(GLFWwindow* window)
 {
 	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
 		glfwSetWindowShouldClose(window, true);
+
+	// one step per key press for depth and mode, continuous for scale
+	static bool upPressed = false, downPressed = false, spacePressed = false;
+	bool up = glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS;
+	bool down = glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS;
+	bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+	if (up && !upPressed)
+		depth = min(depth + 1, 13);
+	if (down && !downPressed)
+		depth = max(depth - 1, 1);
+	if (space && !spacePressed)
+		instanced = !instanced;
+	upPressed = up;
+	downPressed = down;
+	spacePressed = space;
+
+	if (glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+		scale = min(scale + 0.0005f, 0.6f);
+	if (glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+		scale = max(scale - 0.0005f, 0.3f);
 }
 
-// draw fractal
-void recursive_draw(Shader shader, glm::mat4 trans, int depth)
+// draw fractal, one draw call per node
+void recursive_draw(int transformLoc, glm::mat4 trans, int depth, float scale)
 {
 	if (depth == 0)
-	return;
+		return;
 
-	unsigned int transformLoc = glGetUniformLocation(shader.ID, "transform");
 	glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(trans));
 
-	// draw the triangles
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-
-	// trans = glm::translate(trans, glm::vec3(0.5, -0.5, 0.0f));
-	// trans = glm::rotate(trans, (float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));
-
-	float scale = 0.5;
+	// draw the triangle
+	glDrawElements(GL_TRIANGLES, 3, GL_UNSIGNED_INT, 0);
 
 	glm::mat4 trans_top = glm::translate(trans, glm::vec3(0, scale, 0.0f));
 	trans_top = glm::scale(trans_top, glm::vec3(scale));
-	recursive_draw(shader, trans_top, depth - 1);
+	recursive_draw(transformLoc, trans_top, depth - 1, scale);
 
 	glm::mat4 trans_right = glm::translate(trans, glm::vec3(scale, -scale, 0.0f));
 	trans_right = glm::scale(trans_right, glm::vec3(scale));
-	recursive_draw(shader, trans_right, depth - 1);
+	recursive_draw(transformLoc, trans_right, depth - 1, scale);
 
 	glm::mat4 trans_left = glm::translate(trans, glm::vec3(-scale, -scale, 0.0f));
 	trans_left = glm::scale(trans_left, glm::vec3(scale));
-	recursive_draw(shader, trans_left, depth - 1);
+	recursive_draw(transformLoc, trans_left, depth - 1, scale);
 }
 
+// append a node and its subtree in the order recursive_draw visits them
+void flatten_node(vector<glm::mat4>& transforms, const glm::mat4 children[3], const glm::mat4& trans, int depth)
+{
+	if (depth == 0)
+		return;
+	transforms.push_back(trans);
+	for (int k = 0; k < 3; k++)
+		flatten_node(transforms, children, trans * children[k], depth - 1);
+}
+
+// the same nodes as recursive_draw, flattened into one array of transforms in
+// the same depth first order, so overlapping subtrees blend the same way
+void flatten_fractal(vector<glm::mat4>& transforms, int depth, float scale)
+{
+	glm::mat4 children[3];
+	children[0] = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(0, scale, 0.0f)), glm::vec3(scale));
+	children[1] = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(scale, -scale, 0.0f)), glm::vec3(scale));
+	children[2] = glm::scale(glm::translate(glm::mat4(1.0f), glm::vec3(-scale, -scale, 0.0f)), glm::vec3(scale));
+
+	// (3^depth - 1) / 2 nodes in total
+	size_t count = 0, level = 1;
+	for (int i = 0; i < depth; i++, level *= 3)
+		count += level;
+	transforms.clear();
+	transforms.reserve(count);
+	flatten_node(transforms, children, glm::mat4(1.0f), depth);
+}
 
-int main()
+// usage: a.out [depth] [recursive] [validate]
+// validate checks the state tracker against glGet* after every call
+int main(int argc, char** argv)
 {
+	if (argc > 1)
+		depth = max(1, min(atoi(argv[1]), 13));
+	bool validate = false;
+	for (int i = 2; i < argc; i++)
+	{
+		if (strcmp(argv[i], "recursive") == 0)
+			instanced = false;
+		if (strcmp(argv[i], "validate") == 0)
+			validate = true;
+	}
+
 	glfwInit();
 	// Set OpenGL version to 3.3 
 	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
@@ -85,12 +152,15 @@ int main()
 		return -1;
 	}
 
+	state = new GLState(validate);
+
 	// inform OpenGL about window size and set callback when it's changed
-	glViewport(0, 0, 800, 600);
+	state->viewport(0, 0, 800, 600);
 	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
 
-	// create shader
+	// create shaders, one with the transform as uniform and one as instance attribute
 	Shader shader("8.4.transform.vs", "8.4.transform.fs");
+	Shader instancedShader("8.4.transform_instanced.vs", "8.4.transform.fs");
 	
 	// set up vertex data
 
@@ -138,6 +208,18 @@ int main()
 	// texture attribute
 	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
 	glEnableVertexAttribArray(2);
+
+	// define the instance buffer object holding one transform per node, a mat4
+	// attribute takes the four locations 3 to 6, one column each
+	unsigned int instanceVBO;
+	glGenBuffers(1, &instanceVBO);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	for (int i = 0; i < 4; i++)
+	{
+		glVertexAttribPointer(3 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(i * sizeof(glm::vec4)));
+		glEnableVertexAttribArray(3 + i);
+		glVertexAttribDivisor(3 + i, 1);
+	}
 	
 	// Unbind the VAO so it won't be accidentally modified by other VAO calls
 	glBindVertexArray(0);
@@ -169,8 +251,15 @@ int main()
 	stbi_image_free(data);
 
 	// to use background color where texture is transparent 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	state->enable(GL_BLEND);
+	state->blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	int transformLoc = glGetUniformLocation(shader.ID, "transform");
+	vector<glm::mat4> transforms;
+	int builtDepth = 0;
+	float builtScale = 0.0f;
+	double lastReport = glfwGetTime();
+	int frames = 0;
 
 	// render loop
 	// -----------
@@ -182,22 +271,56 @@ int main()
 		// redering commands
 		
 		// clear the color buffer
-		glClearColor(0.8f, 0.75f, 0.7f, 1.0f);
+		state->clearColor(0.8f, 0.75f, 0.7f, 1.0f);
 		glClear(GL_COLOR_BUFFER_BIT);
 
-		// activate the shader program
-		shader.use();
-
 		// bind the vertex array object
-		glBindVertexArray(VAO);
+		state->bindVertexArray(VAO);
 		
 		// bind the textures
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, texture);
+		state->bindTexture(0, GL_TEXTURE_2D, texture);
 
 		// draw sierpinski triangle fractal
-		glm::mat4 trans = glm::mat4(1.0f);
-		recursive_draw(shader, trans, 7);
+		if (instanced)
+		{
+			// rebuild the instance buffer only when the fractal changed
+			if (depth != builtDepth || scale != builtScale)
+			{
+				double start = glfwGetTime();
+				flatten_fractal(transforms, depth, scale);
+				state->bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+				glBufferData(GL_ARRAY_BUFFER, transforms.size() * sizeof(glm::mat4), &transforms[0], GL_STATIC_DRAW);
+				builtDepth = depth;
+				builtScale = scale;
+				cout << "depth " << depth << ": " << transforms.size() << " instances rebuilt in "
+					<< (glfwGetTime() - start) * 1000.0 << " ms" << endl;
+			}
+			state->useProgram(instancedShader.ID);
+			glDrawElementsInstanced(GL_TRIANGLES, 3, GL_UNSIGNED_INT, 0, (GLsizei)transforms.size());
+		}
+		else
+		{
+			state->useProgram(shader.ID);
+			glm::mat4 trans = glm::mat4(1.0f);
+			recursive_draw(transformLoc, trans, depth, scale);
+		}
+
+		state->endFrame();
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			long long nodes = ((long long)pow(3.0, depth) - 1) / 2;
+			const GLState::Counts& counts = state->lastFrame();
+			cout << (instanced ? "instanced" : "recursive") << ", depth " << depth << ": " << frames / (now - lastReport)
+				<< " fps, " << (instanced ? 1 : nodes) << " draw calls for " << nodes << " triangles, " << counts.totalElided()
+				<< " of " << counts.totalElided() + counts.totalForwarded() << " state calls elided";
+			if (validate)
+				cout << ", " << counts.mismatches << " mismatches";
+			cout << endl;
+			frames = 0;
+			lastReport = now;
+		}
 
 		// swap the buffers and poll IO events
 		glfwSwapBuffers(window);
@@ -208,6 +331,8 @@ int main()
 	glDeleteVertexArrays(1, &VAO);
 	glDeleteBuffers(1, &VBO);
 	glDeleteBuffers(1, &EBO);
+	glDeleteBuffers(1, &instanceVBO);
+	delete state;
 
 	// glfw: terminate, clean all previously allocated GLFW resources
 	glfwTerminate();
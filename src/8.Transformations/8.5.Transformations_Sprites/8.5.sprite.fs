@@ -0,0 +1,14 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+in vec3 ourColor;
+
+uniform sampler2D texture1;
+
+void main()
+{
+	vec4 color = texture(texture1, TexCoord);
+	if (color.a < 0.1)
+		discard;
+	FragColor = vec4(color.rgb * ourColor, 1.0);
+}
\ No newline at end of file
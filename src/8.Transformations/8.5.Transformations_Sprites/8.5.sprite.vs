@@ -0,0 +1,19 @@
+#version 330 core
+uniform samplerBuffer sprites;
+uniform float time;
+
+out vec2 TexCoord;
+out vec3 ourColor;
+
+void main()
+{
+	// corner of a 4 vertex triangle strip, no vertex attributes involved
+	vec2 corner = vec2(gl_VertexID & 1, gl_VertexID >> 1);
+	// position, size and phase of this sprite
+	vec4 sprite = texelFetch(sprites, gl_InstanceID);
+	float angle = time + sprite.w;
+	mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+	gl_Position = vec4(sprite.xy + rotation * (corner - 0.5) * sprite.z, 0.0, 1.0);
+	TexCoord = corner;
+	ourColor = 0.5 + 0.5 * cos(sprite.w + vec3(0.0, 2.0, 4.0));
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#version 330 core
+layout(location = 0) in vec2 aCorner;
+layout(location = 1) in vec4 aSprite;
+
+uniform float time;
+
+out vec2 TexCoord;
+out vec3 ourColor;
+
+void main()
+{
+	// same sprite as 8.5.sprite.vs, but corner and sprite come from vertex buffers
+	float angle = time + aSprite.w;
+	mat2 rotation = mat2(cos(angle), sin(angle), -sin(angle), cos(angle));
+	gl_Position = vec4(aSprite.xy + rotation * (aCorner - 0.5) * aSprite.z, 0.0, 1.0);
+	TexCoord = aCorner;
+	ourColor = 0.5 + 0.5 * cos(aSprite.w + vec3(0.0, 2.0, 4.0));
+}
\ No newline at end of file
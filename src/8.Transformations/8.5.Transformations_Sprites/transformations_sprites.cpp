@@ -0,0 +1,267 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "../../../includes/stb_image.h"
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/texture_storage.h"
+#include "../../../includes/learnopengl/procedural_draw.h"
+
+using namespace std;
+
+// the three ways of drawing the same sprites, cycled during the benchmark
+enum SpritePath { PATH_PROCEDURAL, PATH_INSTANCED, PATH_VBO, PATH_COUNT };
+const char* pathNames[PATH_COUNT] = { "procedural (gl_VertexID + buffer texture)", "instanced (quad VBO + instance VBO)",
+	"VBO (4 vertices per sprite)" };
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+}
+
+// usage: a.out [sprite count]
+int main(int argc, char** argv)
+{
+	int count = argc > 1 ? atoi(argv[1]) : 100000;
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	// no vsync, the frame rate is the benchmark
+	glfwSwapInterval(0);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shaders, one without any vertex inputs and one fed from vertex buffers
+	Shader proceduralShader("8.5.sprite.vs", "8.5.sprite.fs");
+	Shader vboShader("8.5.sprite_vbo.vs", "8.5.sprite.fs");
+
+	// per sprite data: position, size and animation phase
+	vector<glm::vec4> sprites(count);
+	for (int i = 0; i < count; i++)
+		sprites[i] = glm::vec4(rand() / (float)RAND_MAX * 2.0f - 1.0f, rand() / (float)RAND_MAX * 2.0f - 1.0f,
+			0.01f + 0.02f * rand() / (float)RAND_MAX, 6.2831853f * rand() / (float)RAND_MAX);
+
+	// procedural path: an empty VAO and the sprites in a buffer texture
+	ProceduralDraw* procedural = new ProceduralDraw();
+	InstanceTexture* spriteTexture = new InstanceTexture(GL_RGBA32F);
+	spriteTexture->upload(&sprites[0], count * sizeof(glm::vec4));
+
+	// instanced path: one quad in a VBO + EBO, the sprites as per instance attribute
+	float corners[] = {
+		0.0f, 0.0f,
+		1.0f, 0.0f,
+		0.0f, 1.0f,
+		1.0f, 1.0f
+	};
+	unsigned int quadIndices[] = {
+		0, 1, 2,	// first triangle
+		1, 3, 2		// second triangle
+	};
+	unsigned int instancedVAO, quadVBO, quadEBO, instanceVBO;
+	glGenVertexArrays(1, &instancedVAO);
+	glGenBuffers(1, &quadVBO);
+	glGenBuffers(1, &quadEBO);
+	glGenBuffers(1, &instanceVBO);
+	glBindVertexArray(instancedVAO);
+	glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(corners), corners, GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, quadEBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quadIndices), quadIndices, GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+	glBufferData(GL_ARRAY_BUFFER, count * sizeof(glm::vec4), &sprites[0], GL_STATIC_DRAW);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+	glEnableVertexAttribArray(1);
+	glVertexAttribDivisor(1, 1);
+
+	// VBO path: every sprite expanded into 4 vertices and 6 indices, the way
+	// the textured quad samples draw a single quad
+	vector<float> vertices;
+	vector<unsigned int> indices;
+	vertices.reserve((size_t)count * 4 * 6);
+	indices.reserve((size_t)count * 6);
+	for (int i = 0; i < count; i++)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			vertices.push_back(corners[c * 2]);
+			vertices.push_back(corners[c * 2 + 1]);
+			vertices.insert(vertices.end(), &sprites[i][0], &sprites[i][0] + 4);
+		}
+		for (int k = 0; k < 6; k++)
+			indices.push_back(i * 4 + quadIndices[k]);
+	}
+	unsigned int VAO, VBO, EBO;
+	glGenVertexArrays(1, &VAO);
+	glGenBuffers(1, &VBO);
+	glGenBuffers(1, &EBO);
+	glBindVertexArray(VAO);
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), &vertices[0], GL_STATIC_DRAW);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), &indices[0], GL_STATIC_DRAW);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(2 * sizeof(float)));
+	glEnableVertexAttribArray(1);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+	cout << count << " sprites, vertex data per path: procedural 0 KB + " << spriteTexture->size() / 1024 << " KB buffer texture, instanced "
+		<< (sizeof(corners) + sizeof(quadIndices) + count * sizeof(glm::vec4)) / 1024 << " KB, VBO "
+		<< (vertices.size() * sizeof(float) + indices.size() * sizeof(unsigned int)) / 1024 << " KB" << endl;
+
+	// load and create a texture
+	int width, heigth, nrChannel;
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* data = stbi_load("../../../resources/textures/awesomeface.png", &width, &heigth, &nrChannel, 0);
+	unsigned int texture = 0;
+	if (data)
+	{
+		texture = createImmutableTexture2D(data, width, heigth, nrChannel);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	else
+	{
+		cout << "ERROR::TEXTURE::FAILED_TO_LOAD_TEXTURE_IMAGE" << endl;
+	}
+	stbi_image_free(data);
+
+	// tell OpenGL for each sampler to which texture unit it belongs
+	proceduralShader.use();
+	proceduralShader.setInt("texture1", 0);
+	proceduralShader.setInt("sprites", 1);
+	vboShader.use();
+	vboShader.setInt("texture1", 0);
+
+	unsigned int query;
+	glGenQueries(1, &query);
+	int path = PATH_PROCEDURAL;
+	int frames = 0;
+	double gpuSeconds = 0.0;
+	double lastSwitch = glfwGetTime();
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// bind the textures
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		spriteTexture->bind(1);
+
+		float time = (float)glfwGetTime();
+		glBeginQuery(GL_TIME_ELAPSED, query);
+		if (path == PATH_PROCEDURAL)
+		{
+			proceduralShader.use();
+			proceduralShader.setFloat("time", time);
+			procedural->quads(count);
+		}
+		else if (path == PATH_INSTANCED)
+		{
+			vboShader.use();
+			vboShader.setFloat("time", time);
+			glBindVertexArray(instancedVAO);
+			glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, count);
+		}
+		else
+		{
+			vboShader.use();
+			vboShader.setFloat("time", time);
+			glBindVertexArray(VAO);
+			glDrawElements(GL_TRIANGLES, (GLsizei)indices.size(), GL_UNSIGNED_INT, 0);
+		}
+		glEndQuery(GL_TIME_ELAPSED);
+
+		// waiting for the result stalls the pipeline, fine for a benchmark
+		GLuint64 nanoseconds = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+		gpuSeconds += nanoseconds * 1e-9;
+		frames++;
+
+		// report and move on to the next path every 2 seconds
+		double now = glfwGetTime();
+		if (now - lastSwitch > 2.0)
+		{
+			cout << pathNames[path] << ": " << gpuSeconds * 1000.0 / frames << " ms GPU per frame, "
+				<< frames / (now - lastSwitch) << " fps" << endl;
+			path = (path + 1) % PATH_COUNT;
+			frames = 0;
+			gpuSeconds = 0.0;
+			lastSwitch = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	delete procedural;
+	delete spriteTexture;
+	glDeleteVertexArrays(1, &instancedVAO);
+	glDeleteBuffers(1, &quadVBO);
+	glDeleteBuffers(1, &quadEBO);
+	glDeleteBuffers(1, &instanceVBO);
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteTextures(1, &texture);
+	glDeleteQueries(1, &query);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,9 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 attractorPos;
+
+void main()
+{
+	vec3 low = vec3(0.1, 0.4, 0.2), high = vec3(1.0f, 0.5f, 0.2f);
+	FragColor = vec4(mix(low, high, clamp(attractorPos.y, 0.0, 1.0)) * (0.7 + 0.3 * attractorPos.x), 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;
+// one affine map per instance, x = a x + b y + e, y = c x + d y + f
+layout(location = 3) in float mapA;
+layout(location = 4) in float mapB;
+layout(location = 5) in float mapC;
+layout(location = 6) in float mapD;
+layout(location = 7) in float mapE;
+layout(location = 8) in float mapF;
+
+// attractor bounds: xy lower corner, zw 1 / size
+uniform vec4 view;
+
+out vec2 attractorPos;
+
+void main()
+{
+	vec2 p = vec2(mapA * aPos.x + mapB * aPos.y + mapE, mapC * aPos.x + mapD * aPos.y + mapF);
+	attractorPos = (p - view.xy) * view.zw;
+	gl_Position = vec4(attractorPos * 1.8 - 0.9, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/ifs.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+int depth = 0;
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	// one level per key press
+	static bool upPressed = false, downPressed = false;
+	bool up = glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS;
+	bool down = glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS;
+	if (up && !upPressed)
+		depth++;
+	if (down && !downPressed)
+		depth = max(depth - 1, 1);
+	upPressed = up;
+	downPressed = down;
+}
+
+// the way 8.4 builds its transforms: depth first on full 4x4 matrices
+void expandMat4(const vector<glm::mat4>& maps, const glm::mat4& trans, int depth, vector<glm::mat4>& out)
+{
+	if (depth == 0)
+		return;
+	out.push_back(trans);
+	for (size_t k = 0; k < maps.size(); k++)
+		expandMat4(maps, trans * maps[k], depth - 1, out);
+}
+
+// transforms per second for the 4x4 recursion and for expandIFS on 1 to all cores
+void benchmark(const vector<AffineMap>& maps, int depth)
+{
+	size_t count = ifsTransformCount(maps.size(), depth);
+	cout << maps.size() << " maps, depth " << depth << ": " << count << " transforms" << endl;
+
+	vector<glm::mat4> mat4Maps(maps.size(), glm::mat4(1.0f));
+	for (size_t k = 0; k < maps.size(); k++)
+	{
+		mat4Maps[k][0][0] = maps[k].a;
+		mat4Maps[k][1][0] = maps[k].b;
+		mat4Maps[k][0][1] = maps[k].c;
+		mat4Maps[k][1][1] = maps[k].d;
+		mat4Maps[k][3][0] = maps[k].e;
+		mat4Maps[k][3][1] = maps[k].f;
+	}
+	vector<glm::mat4> matrices;
+	matrices.reserve(count);
+	double best = 1e30;
+	for (int run = 0; run < 3; run++)
+	{
+		matrices.clear();
+		chrono::steady_clock::time_point start = chrono::steady_clock::now();
+		expandMat4(mat4Maps, glm::mat4(1.0f), depth, matrices);
+		best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+	}
+	cout << "  glm::mat4 recursion, 1 thread: " << count / best / 1e6 << " M transforms/s" << endl;
+	vector<glm::mat4>().swap(matrices);
+
+	int cores = max(1, (int)thread::hardware_concurrency());
+	double single = 0.0;
+	IFSTransforms transforms;
+	for (int threads = 1; ; threads = min(threads * 2, cores))
+	{
+		ThreadPool pool(threads);
+		IFSStats stats;
+		best = 1e30;
+		for (int run = 0; run < 3; run++)
+		{
+			expandIFS(maps, depth, transforms, pool, &stats);
+			best = min(best, stats.seconds);
+		}
+		if (threads == 1)
+			single = best;
+		cout << "  expandIFS " << stats.isa << ", " << threads << " threads: " << count / best / 1e6 << " M transforms/s ("
+			<< single / best << "x)" << endl;
+		if (threads == cores)
+			break;
+	}
+}
+
+// usage: a.out [sierpinski|fern|dragon|carpet] [depth]
+//        a.out bench [sierpinski|fern|dragon|carpet] [depth]
+int main(int argc, char** argv)
+{
+	bool bench = argc > 1 && strcmp(argv[1], "bench") == 0;
+	int first = bench ? 2 : 1;
+	int defaultDepth;
+	vector<AffineMap> maps = ifsPreset(argc > first ? argv[first] : "sierpinski", &defaultDepth);
+	depth = ifsClampDepth(maps.size(), argc > first + 1 ? max(1, atoi(argv[first + 1])) : defaultDepth);
+	if (bench)
+	{
+		benchmark(maps, depth);
+		return 0;
+	}
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shader
+	Shader shader("8.6.ifs.vs", "8.6.ifs.fs");
+
+	// set up vertex data, the unit square every map is applied to
+	float vertices[] = {
+		1.0f, 1.0f,	// top right
+		1.0f, 0.0f,	// bottom right
+		0.0f, 0.0f,	// bottom left
+		0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// define instance buffer object, filled whenever the depth changes
+	unsigned int instanceVBO;
+	glGenBuffers(1, &instanceVBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	IFSTransforms transforms;
+	int builtDepth = 0;
+	size_t instances = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+		depth = ifsClampDepth(maps.size(), depth);
+
+		// expand the system again when the depth changed, only the deepest level is drawn
+		if (depth != builtDepth)
+		{
+			IFSStats stats;
+			expandIFS(maps, depth, transforms, ThreadPool::shared(), &stats);
+			size_t begin = transforms.levelBegin(depth - 1), end = transforms.levelEnd(depth - 1);
+			glBindVertexArray(VAO);
+			uploadIFSInstances(transforms, begin, end, instanceVBO, 3);
+			glBindVertexArray(0);
+			instances = end - begin;
+
+			// frame the attractor, padded by the unit square drawn at each transform
+			float low[2], high[2];
+			ifsBounds(transforms, begin, end, low, high);
+			float pad = 0.0f;
+			for (size_t i = begin; i < end; i++)
+				pad = max(pad, fabsf(transforms.a[i]) + fabsf(transforms.b[i]) + fabsf(transforms.c[i]) + fabsf(transforms.d[i]));
+			shader.use();
+			shader.set4Float("view", low[0] - pad, low[1] - pad, 1.0f / max(high[0] - low[0] + 2.0f * pad, 1e-6f),
+				1.0f / max(high[1] - low[1] + 2.0f * pad, 1e-6f));
+
+			cout << "depth " << depth << ": " << stats.transforms << " transforms in " << stats.seconds * 1000.0 << " ms ("
+				<< stats.transforms / stats.seconds / 1e6 << " M/s, " << stats.isa << ", " << stats.threads << " threads), drawing "
+				<< instances << endl;
+			builtDepth = depth;
+		}
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// activate the shader program
+		shader.use();
+
+		// bind the vertex array object
+		glBindVertexArray(VAO);
+
+		// draw the deepest level in one call
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)instances);
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteBuffers(1, &instanceVBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
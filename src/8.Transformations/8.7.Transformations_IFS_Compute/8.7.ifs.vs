@@ -0,0 +1,22 @@
+#version 430 core
+layout(location = 0) in vec2 aPos;
+
+// transforms written by the compute shader, six arrays of arrayStride floats (a to f)
+layout(std430, binding = 1) readonly buffer Transforms { float coefficients[]; };
+uniform int instanceBegin;
+uniform int arrayStride;
+
+// attractor bounds: xy lower corner, zw 1 / size
+uniform vec4 view;
+
+out vec2 attractorPos;
+
+void main()
+{
+	int i = instanceBegin + gl_InstanceID;
+	float a = coefficients[i], b = coefficients[arrayStride + i], c = coefficients[2 * arrayStride + i];
+	float d = coefficients[3 * arrayStride + i], e = coefficients[4 * arrayStride + i], f = coefficients[5 * arrayStride + i];
+	vec2 p = vec2(a * aPos.x + b * aPos.y + e, c * aPos.x + d * aPos.y + f);
+	attractorPos = (p - view.xy) * view.zw;
+	gl_Position = vec4(attractorPos * 1.8 - 0.9, 0.0, 1.0);
+}
\ No newline at end of file
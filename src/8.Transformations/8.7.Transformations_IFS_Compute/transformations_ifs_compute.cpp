@@ -0,0 +1,255 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/ifs.h"
+#include "../../../includes/learnopengl/ifs_compute.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+int depth = 0;
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	// one level per key press
+	static bool upPressed = false, downPressed = false;
+	bool up = glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS;
+	bool down = glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS;
+	if (up && !upPressed)
+		depth++;
+	if (down && !downPressed)
+		depth = max(depth - 1, 1);
+	upPressed = up;
+	downPressed = down;
+}
+
+// CPU expansion + upload against GPU expansion for depths 6 to 14. both sides
+// wait for the GPU, so the times are until the transforms are ready to draw
+void benchmark(const vector<AffineMap>& maps, IFSCompute& gpu, unsigned int VAO, unsigned int instanceVBO)
+{
+	unsigned int query;
+	glGenQueries(1, &query);
+	IFSTransforms transforms;
+	cout << "depth  transforms   CPU expand  CPU upload   GPU expand (GPU time)" << endl;
+	for (int d = 6; d <= 14; d++)
+	{
+		if (ifsClampDepth(maps.size(), d) != d)
+			break;
+		double best[4] = { 1e30, 1e30, 1e30, 1e30 };
+		for (int run = 0; run < 3; run++)
+		{
+			IFSStats stats;
+			expandIFS(maps, d, transforms, ThreadPool::shared(), &stats);
+			double start = glfwGetTime();
+			glBindVertexArray(VAO);
+			uploadIFSInstances(transforms, transforms.levelBegin(d - 1), transforms.levelEnd(d - 1), instanceVBO, 3);
+			glBindVertexArray(0);
+			glFinish();
+			double upload = glfwGetTime() - start;
+
+			glFinish();
+			start = glfwGetTime();
+			glBeginQuery(GL_TIME_ELAPSED, query);
+			gpu.expand(maps, d);
+			glEndQuery(GL_TIME_ELAPSED);
+			glFinish();
+			double wall = glfwGetTime() - start;
+			GLuint64 nanoseconds = 0;
+			glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+
+			best[0] = min(best[0], stats.seconds);
+			best[1] = min(best[1], upload);
+			best[2] = min(best[2], wall);
+			best[3] = min(best[3], nanoseconds * 1e-9);
+		}
+		cout << d << "\t" << ifsTransformCount(maps.size(), d) << "\t" << best[0] * 1000.0 << " ms\t" << best[1] * 1000.0
+			<< " ms\t" << best[2] * 1000.0 << " ms (" << best[3] * 1000.0 << " ms)" << endl;
+	}
+	glDeleteQueries(1, &query);
+}
+
+// usage: a.out [sierpinski|fern|dragon|carpet] [depth]
+//        a.out bench [sierpinski|fern|dragon|carpet]
+int main(int argc, char** argv)
+{
+	bool bench = argc > 1 && strcmp(argv[1], "bench") == 0;
+	int first = bench ? 2 : 1;
+	int defaultDepth;
+	vector<AffineMap> maps = ifsPreset(argc > first ? argv[first] : "sierpinski", &defaultDepth);
+	depth = ifsClampDepth(maps.size(), argc > first + 1 ? max(1, atoi(argv[first + 1])) : defaultDepth);
+
+	glfwInit();
+	// compute shaders need OpenGL 4.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create the compute expander and the shader drawing its output
+	IFSCompute* gpu = new IFSCompute(6);
+	if (!gpu->valid())
+	{
+		delete gpu;
+		glfwTerminate();
+		return -1;
+	}
+	Shader shader("8.7.ifs.vs", "8.7.ifs.fs");
+
+	// set up vertex data, the unit square every map is applied to
+	float vertices[] = {
+		1.0f, 1.0f,	// top right
+		1.0f, 0.0f,	// bottom right
+		0.0f, 0.0f,	// bottom left
+		0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	if (bench)
+	{
+		// the CPU path needs its own VAO with per instance attributes
+		unsigned int cpuVAO, instanceVBO;
+		glGenVertexArrays(1, &cpuVAO);
+		glGenBuffers(1, &instanceVBO);
+		benchmark(maps, *gpu, cpuVAO, instanceVBO);
+		glDeleteVertexArrays(1, &cpuVAO);
+		glDeleteBuffers(1, &instanceVBO);
+		glfwSetWindowShouldClose(window, true);
+	}
+
+	int builtDepth = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+		depth = ifsClampDepth(maps.size(), depth);
+
+		// expand again on the GPU when the depth changed, nothing is read back
+		if (depth != builtDepth)
+		{
+			gpu->expand(maps, depth);
+
+			// frame the attractor from a shallow CPU expansion, which is enough for the bounds
+			IFSTransforms preview;
+			int previewDepth = min(depth, ifsClampDepth(maps.size(), 8));
+			expandIFS(maps, previewDepth, preview);
+			size_t begin = preview.levelBegin(previewDepth - 1), end = preview.levelEnd(previewDepth - 1);
+			float low[2], high[2];
+			ifsBounds(preview, begin, end, low, high);
+			float pad = 0.0f;
+			for (size_t i = begin; i < end; i++)
+				pad = max(pad, fabsf(preview.a[i]) + fabsf(preview.b[i]) + fabsf(preview.c[i]) + fabsf(preview.d[i]));
+
+			shader.use();
+			shader.set4Float("view", low[0] - pad, low[1] - pad, 1.0f / max(high[0] - low[0] + 2.0f * pad, 1e-6f),
+				1.0f / max(high[1] - low[1] + 2.0f * pad, 1e-6f));
+			shader.setInt("instanceBegin", (int)gpu->levelBegin(depth - 1));
+			shader.setInt("arrayStride", (int)gpu->arrayStride());
+			cout << "depth " << depth << ": " << gpu->size() << " transforms expanded on the GPU, drawing "
+				<< gpu->levelEnd(depth - 1) - gpu->levelBegin(depth - 1) << endl;
+			builtDepth = depth;
+		}
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// activate the shader program
+		shader.use();
+
+		// bind the vertex array object
+		glBindVertexArray(VAO);
+
+		// draw the deepest level, the instance count comes from the compute shader
+		gpu->bindForDraw(1);
+		glDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, 0);
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	delete gpu;
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,9 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 screenPos;
+
+void main()
+{
+	vec3 low = vec3(0.1, 0.4, 0.2), high = vec3(1.0f, 0.5f, 0.2f);
+	FragColor = vec4(mix(low, high, clamp(screenPos.y, 0.0, 1.0)) * (0.7 + 0.3 * screenPos.x), 1.0);
+}
\ No newline at end of file
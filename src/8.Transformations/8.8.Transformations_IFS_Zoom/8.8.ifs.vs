@@ -0,0 +1,18 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;
+// one affine map per instance, already including the view, x = a x + b y + e, y = c x + d y + f
+layout(location = 3) in float mapA;
+layout(location = 4) in float mapB;
+layout(location = 5) in float mapC;
+layout(location = 6) in float mapD;
+layout(location = 7) in float mapE;
+layout(location = 8) in float mapF;
+
+out vec2 screenPos;
+
+void main()
+{
+	vec2 p = vec2(mapA * aPos.x + mapB * aPos.y + mapE, mapC * aPos.x + mapD * aPos.y + mapF);
+	screenPos = p * 0.5 + 0.5;
+	gl_Position = vec4(p, 0.0, 1.0);
+}
\ No newline at end of file
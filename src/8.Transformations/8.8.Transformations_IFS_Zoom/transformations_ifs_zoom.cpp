@@ -0,0 +1,238 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/ifs.h"
+
+using namespace std;
+
+// view in double precision, shared with the callbacks
+IFSView view;
+bool autoZoom = true;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+	view.width = width;
+	view.height = height;
+	view.aspect = height > 0 ? (double)width / height : 1.0;
+}
+
+// zoom towards the point under the cursor
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
+{
+	double mouseX, mouseY;
+	glfwGetCursorPos(window, &mouseX, &mouseY);
+	int width, height;
+	glfwGetWindowSize(window, &width, &height);
+	double ndcX = 2.0 * mouseX / max(width, 1) - 1.0, ndcY = 1.0 - 2.0 * mouseY / max(height, 1);
+	double x = view.centerX + ndcX * view.aspect / view.scale, y = view.centerY + ndcY / view.scale;
+	double factor = pow(1.2, yoffset);
+	view.centerX = x + (view.centerX - x) / factor;
+	view.centerY = y + (view.centerY - y) / factor;
+	view.scale *= factor;
+	autoZoom = false;
+}
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	static bool spacePressed = false;
+	bool space = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+	if (space && !spacePressed)
+		autoZoom = !autoZoom;
+	spacePressed = space;
+}
+
+// usage: a.out [sierpinski|fern|dragon|carpet] [pixel threshold] [transform budget]
+// scroll to zoom at the cursor, space toggles the automatic zoom
+int main(int argc, char** argv)
+{
+	vector<AffineMap> maps = ifsPreset(argc > 1 ? argv[1] : "sierpinski");
+	float pixelThreshold = argc > 2 ? (float)atof(argv[2]) : 2.0f;
+	size_t budget = argc > 3 ? (size_t)atol(argv[3]) : 200000;
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	framebuffer_size_callback(window, width, height);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+	glfwSetScrollCallback(window, scroll_callback);
+
+	// create shader
+	Shader shader("8.8.ifs.vs", "8.8.ifs.fs");
+
+	// set up vertex data, the unit square every map is applied to
+	float vertices[] = {
+		1.0f, 1.0f,	// top right
+		1.0f, 0.0f,	// bottom right
+		0.0f, 0.0f,	// bottom left
+		0.0f, 1.0f	// top left
+	};
+
+	unsigned int indices[] = {
+		0, 1, 3,	// first triangle
+		1, 2, 3		// second triangle
+	};
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// define vertex buffer object
+	unsigned int VBO;
+	glGenBuffers(1, &VBO);
+
+	// define element buffer object
+	unsigned int EBO;
+	glGenBuffers(1, &EBO);
+
+	// define instance buffer object, refilled every frame
+	unsigned int instanceVBO;
+	glGenBuffers(1, &instanceVBO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// copy the vertices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ARRAY_BUFFER, VBO);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+
+	// copy the indices array in a buffer for OpenGL to use
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+	// let OpenGL know how to interpret the vertex data
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	// bounds of a node's subtree, used for culling and for the projected size
+	float shapeLow[2] = { 0.0f, 0.0f }, shapeHigh[2] = { 1.0f, 1.0f };
+	float low[2], high[2];
+	ifsSubtreeBounds(maps, shapeLow, shapeHigh, low, high);
+
+	// start with the whole attractor in view
+	view.centerX = 0.5 * (low[0] + high[0]);
+	view.centerY = 0.5 * (low[1] + high[1]);
+	view.scale = 1.8 / max((double)high[1] - low[1], (high[0] - low[0]) / view.aspect);
+	const double startScale = view.scale;
+
+	// the automatic zoom heads for a point on the attractor found by the chaos game
+	double targetX = 0.0, targetY = 0.0;
+	srand(7);
+	for (int i = 0; i < 200; i++)
+	{
+		const AffineMap& m = maps[rand() % maps.size()];
+		double x = m.a * targetX + m.b * targetY + m.e, y = m.c * targetX + m.d * targetY + m.f;
+		targetX = x;
+		targetY = y;
+	}
+
+	IFSTransforms transforms;
+	double lastFrame = glfwGetTime(), lastReport = lastFrame;
+	IFSRefineStats stats;
+	double refineSeconds = 0.0;
+	int frames = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		double now = glfwGetTime();
+		if (autoZoom)
+		{
+			// 1.5x per second; double precision runs out around 1e12, start over there
+			double factor = pow(1.5, now - lastFrame);
+			view.centerX = targetX + (view.centerX - targetX) / factor;
+			view.centerY = targetY + (view.centerY - targetY) / factor;
+			view.scale *= factor;
+			if (view.scale > startScale * 1e12)
+				view.scale = startScale;
+		}
+		lastFrame = now;
+
+		// refine for this view and upload the result, the transforms are already in NDC
+		refineIFS(maps, view, low, high, pixelThreshold, budget, transforms, &stats);
+		refineSeconds += stats.seconds;
+		glBindVertexArray(VAO);
+		uploadIFSInstances(transforms, 0, transforms.size(), instanceVBO, 3);
+
+		// redering commands
+
+		// clear the color buffer
+		glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+		glClear(GL_COLOR_BUFFER_BIT);
+
+		// activate the shader program
+		shader.use();
+
+		// draw every refined node in one call
+		glDrawElementsInstanced(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0, (GLsizei)transforms.size());
+
+		frames++;
+		if (now - lastReport > 2.0)
+		{
+			cout << "zoom " << view.scale / startScale << "x: " << stats.emitted << " transforms (depth up to " << stats.maxDepth
+				<< "), " << stats.visited << " visited, " << stats.culled << " culled" << (stats.budgetHit ? ", budget hit" : "")
+				<< ", refine " << refineSeconds * 1000.0 / frames << " ms, " << frames / (now - lastReport) << " fps" << endl;
+			refineSeconds = 0.0;
+			frames = 0;
+			lastReport = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteBuffers(1, &VBO);
+	glDeleteBuffers(1, &EBO);
+	glDeleteBuffers(1, &instanceVBO);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}
@@ -0,0 +1,16 @@
+#version 330 core
+out vec4 FragColor;
+in vec2 TexCoord;
+
+uniform sampler2D density;
+// 1 / log(1 + the density mapped to full brightness)
+uniform float exposure;
+
+void main()
+{
+	float hits = texture(density, TexCoord).r;
+	float level = clamp(log(1.0 + hits) * exposure, 0.0, 1.0);
+	vec3 background = vec3(0.2, 0.3, 0.3);
+	vec3 color = mix(vec3(0.1, 0.4, 0.2), vec3(1.0, 0.9, 0.6), level);
+	FragColor = vec4(hits > 0.0 ? color * (0.3 + 0.7 * level) : background, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#version 330 core
+out vec4 FragColor;
+
+void main()
+{
+	// every point adds one hit to the density target, blending does the sum
+	FragColor = vec4(1.0);
+}
\ No newline at end of file
@@ -0,0 +1,11 @@
+#version 330 core
+layout(location = 0) in vec2 aPos;
+
+// attractor bounds: xy lower corner, zw 1 / size
+uniform vec4 view;
+
+void main()
+{
+	vec2 attractorPos = (aPos - view.xy) * view.zw;
+	gl_Position = vec4(attractorPos * 1.8 - 0.9, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,291 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <iostream>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <algorithm>
+
+#include "../../../includes/learnopengl/shader_s.h"
+#include "../../../includes/learnopengl/ifs.h"
+#include "../../../includes/learnopengl/stream_buffer.h"
+#include "../../../includes/learnopengl/procedural_draw.h"
+
+using namespace std;
+
+// callback method for change in window size
+void framebuffer_size_callback(GLFWwindow* window, int width, int height)
+{
+	glViewport(0, 0, width, height);
+}
+
+bool clearDensity = false;
+
+// process inputs in each iteration of render loop
+void processInput(GLFWwindow* window)
+{
+	if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+		glfwSetWindowShouldClose(window, true);
+
+	// start accumulating from scratch
+	if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
+		clearDensity = true;
+}
+
+// points per second of each kernel on one thread, then of ifsChaosGame on 1 to all cores
+void benchmark(const vector<AffineMap>& maps, size_t count)
+{
+	IFSChaosTable table = ifsChaosTable(maps);
+	vector<float> xy(count * 2);
+	cout << maps.size() << " maps, " << count << " points" << endl;
+
+	const char* names[3] = { "scalar", "SSE2", "AVX2" };
+	void (*kernels[3])(const IFSChaosTable&, unsigned int, float*, int) = { ifsChaosScalar, NULL, NULL };
+#ifdef IFS_X86
+	kernels[1] = ifsChaosSSE2;
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		kernels[2] = ifsChaosAVX2;
+#endif
+	for (int k = 0; k < 3; k++)
+	{
+		if (!kernels[k])
+			continue;
+		double best = 1e30;
+		for (int run = 0; run < 3; run++)
+		{
+			chrono::steady_clock::time_point start = chrono::steady_clock::now();
+			for (size_t begin = 0; begin < count; begin += IFS_CHAOS_BLOCK)
+				kernels[k](table, run * 7919 + (unsigned int)begin, &xy[begin * 2], (int)min((size_t)IFS_CHAOS_BLOCK, count - begin));
+			best = min(best, chrono::duration<double>(chrono::steady_clock::now() - start).count());
+		}
+		cout << "  " << names[k] << ", 1 thread: " << count / best / 1e6 << " M points/s" << endl;
+	}
+
+	int cores = max(1, (int)thread::hardware_concurrency());
+	double single = 0.0;
+	for (int threads = 1; ; threads = min(threads * 2, cores))
+	{
+		ThreadPool pool(threads);
+		IFSChaosStats stats;
+		double best = 1e30;
+		for (int run = 0; run < 3; run++)
+		{
+			ifsChaosGame(table, &xy[0], count, run + 1, pool, &stats);
+			best = min(best, stats.seconds);
+		}
+		if (threads == 1)
+			single = best;
+		cout << "  ifsChaosGame " << stats.isa << ", " << threads << " threads: " << count / best / 1e6 << " M points/s ("
+			<< single / best << "x)" << endl;
+		if (threads == cores)
+			break;
+	}
+}
+
+// single channel float render target the points are summed into
+void createDensityTarget(int width, int height, unsigned int& FBO, unsigned int& texture)
+{
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_R32F, width, height, 0, GL_RED, GL_FLOAT, NULL);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+	glGenFramebuffers(1, &FBO);
+	glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+	glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0);
+	if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		cout << "ERROR::FRAMEBUFFER::DENSITY_TARGET_INCOMPLETE" << endl;
+	glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+// usage: a.out [sierpinski|fern|dragon|carpet] [million points per frame]
+//        a.out bench [sierpinski|fern|dragon|carpet] [million points]
+// space starts the accumulation over
+int main(int argc, char** argv)
+{
+	bool bench = argc > 1 && strcmp(argv[1], "bench") == 0;
+	int first = bench ? 2 : 1;
+	vector<AffineMap> maps = ifsPreset(argc > first ? argv[first] : "sierpinski");
+	size_t count = (size_t)(1e6 * (argc > first + 1 ? max(0.001, atof(argv[first + 1])) : 4.0));
+	if (bench)
+	{
+		benchmark(maps, count);
+		return 0;
+	}
+	IFSChaosTable table = ifsChaosTable(maps);
+
+	glfwInit();
+	// Set OpenGL version to 3.3
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+	// for Mac OS X, uncomment the following line
+	// glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+
+	// create GLFW window
+	GLFWwindow* window = glfwCreateWindow(800, 600, "LearnOpenGL", NULL, NULL);
+	if (window == NULL)
+	{
+		cout << "Failed to create GLFW window" << endl;
+		glfwTerminate();
+		return -1;
+	}
+	glfwMakeContextCurrent(window);
+	// no vsync, the point rate is the benchmark
+	glfwSwapInterval(0);
+
+	// check wheter GLAD has initialized successfully
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
+	{
+		cout << "Failed to initialize GLAD" << endl;
+		return -1;
+	}
+
+	// inform OpenGL about window size and set callback when it's changed
+	glViewport(0, 0, 800, 600);
+	glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+	// create shaders, one summing the points and one showing the sum
+	Shader pointShader("8.9.points.vs", "8.9.points.fs");
+	Shader displayShader("8.9.display.vs", "8.9.display.fs");
+
+	// frame the attractor with a first batch of points
+	vector<float> sample(65536 * 2);
+	ifsChaosGame(table, &sample[0], 65536, 0);
+	float low[2] = { 1e30f, 1e30f }, high[2] = { -1e30f, -1e30f };
+	for (size_t i = 0; i < sample.size(); i += 2)
+	{
+		low[0] = min(low[0], sample[i]);
+		high[0] = max(high[0], sample[i]);
+		low[1] = min(low[1], sample[i + 1]);
+		high[1] = max(high[1], sample[i + 1]);
+	}
+	pointShader.use();
+	pointShader.set4Float("view", low[0], low[1], 1.0f / max(high[0] - low[0], 1e-6f), 1.0f / max(high[1] - low[1], 1e-6f));
+	displayShader.use();
+	displayShader.setInt("density", 0);
+
+	// the workers write every frame's points straight into the mapped buffer
+	StreamBuffer* points = new StreamBuffer(count * 2 * sizeof(float));
+	cout << count << " points per frame, " << count * 2 * sizeof(float) / (1024 * 1024) << " MB streamed through a "
+		<< (points->isPersistent() ? "persistently mapped ring" : "orphaned buffer") << endl;
+
+	// define vertex array object
+	unsigned int VAO;
+	glGenVertexArrays(1, &VAO);
+
+	// bind the VAO
+	glBindVertexArray(VAO);
+
+	// let OpenGL know how to interpret the vertex data
+	glBindBuffer(GL_ARRAY_BUFFER, points->buffer());
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+	glEnableVertexAttribArray(0);
+
+	// Unbind the VAO so it won't be accidentally modified by other VAO calls
+	glBindVertexArray(0);
+
+	ProceduralDraw* fullscreen = new ProceduralDraw();
+	int width, height;
+	glfwGetFramebufferSize(window, &width, &height);
+	unsigned int FBO, densityTexture;
+	createDensityTarget(width, height, FBO, densityTexture);
+
+	double totalPoints = 0.0, cpuSeconds = 0.0;
+	double lastReport = glfwGetTime();
+	unsigned int frame = 0;
+	int frames = 0;
+	const char* isa = "";
+	int threads = 0;
+
+	// render loop
+	while (!glfwWindowShouldClose(window))
+	{
+		// input
+		processInput(window);
+
+		// a new size starts over with a new target
+		int newWidth, newHeight;
+		glfwGetFramebufferSize(window, &newWidth, &newHeight);
+		if (newWidth != width || newHeight != height)
+		{
+			glDeleteFramebuffers(1, &FBO);
+			glDeleteTextures(1, &densityTexture);
+			width = newWidth;
+			height = newHeight;
+			createDensityTarget(max(width, 1), max(height, 1), FBO, densityTexture);
+			totalPoints = 0.0;
+		}
+		if (clearDensity)
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+			glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+			glClear(GL_COLOR_BUFFER_BIT);
+			totalPoints = 0.0;
+			clearDensity = false;
+		}
+
+		// this frame's points, a new seed gives new ones
+		IFSChaosStats stats;
+		float* xy = (float*)points->begin();
+		ifsChaosGame(table, xy, count, ++frame, ThreadPool::shared(), &stats);
+		GLint first = (GLint)(points->end() / (2 * sizeof(float)));
+		cpuSeconds += stats.seconds;
+		isa = stats.isa;
+		threads = stats.threads;
+
+		// redering commands
+
+		// add the points to the density target
+		glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_ONE, GL_ONE);
+		pointShader.use();
+		glBindVertexArray(VAO);
+		glDrawArrays(GL_POINTS, first, (GLsizei)count);
+		glDisable(GL_BLEND);
+		points->fence();
+		totalPoints += count;
+
+		// show the density, on a log scale so the sparse parts stay visible
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		displayShader.use();
+		displayShader.setFloat("exposure", 1.0f / (float)log(1.0 + 4.0 * totalPoints / max(width * height, 1)));
+		glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, densityTexture);
+		fullscreen->fullscreenTriangle();
+
+		frames++;
+		double now = glfwGetTime();
+		if (now - lastReport > 2.0)
+		{
+			cout << count * frames / (now - lastReport) / 1e6 << " M points/s drawn, " << frames / (now - lastReport) << " fps, generation "
+				<< count * frames / cpuSeconds / 1e6 << " M points/s (" << isa << ", " << threads << " threads), "
+				<< totalPoints / 1e9 << " G points accumulated" << endl;
+			frames = 0;
+			cpuSeconds = 0.0;
+			lastReport = now;
+		}
+
+		// swap the buffers and poll IO events
+		glfwSwapBuffers(window);
+		glfwPollEvents();
+	}
+
+	// optional: de-allocate all resources once they-ve outlived their purpose
+	delete points;
+	delete fullscreen;
+	glDeleteVertexArrays(1, &VAO);
+	glDeleteFramebuffers(1, &FBO);
+	glDeleteTextures(1, &densityTexture);
+
+	// glfw: terminate, clean all previously allocated GLFW resources
+	glfwTerminate();
+	return 0;
+}